@@ -84,9 +84,17 @@ void ShutdownEvent::consume() const {
     }
 }
 
-Server::Server(JNIEnv* env, jobject watcherCallback)
+EventBurst::EventBurst(chrono::steady_clock::time_point windowStart)
+    : windowStart(windowStart)
+    , eventCount(0)
+    , invalidated(false) {
+}
+
+Server::Server(JNIEnv* env, jobject watcherCallback, int invalidationThreshold, long invalidationWindowInMillis)
     : AbstractServer(env, watcherCallback)
-    , inotify(new Inotify()) {
+    , inotify(new Inotify())
+    , invalidationThreshold(invalidationThreshold)
+    , invalidationWindow(invalidationWindowInMillis) {
     buffer.reserve(EVENT_BUFFER_SIZE);
     jclass listClass = env->FindClass("java/util/List");
     this->listAddMethod = env->GetMethodID(listClass, "add", "(Ljava/lang/Object;)Z");
@@ -103,7 +111,8 @@ void Server::runLoop() {
     int forever = numeric_limits<int>::max();
 
     while (!shouldTerminate) {
-        processQueues(forever);
+        int timeout = millisUntilNextWindowCloses();
+        processQueues(timeout == -1 ? forever : timeout);
     }
 
     // No need to clean up watch points, they will be cancelled
@@ -136,6 +145,74 @@ void Server::processQueues(int timeout) {
             reportFailure(getThreadEnv(), ex);
         }
     }
+
+    closeExpiredWindows(getThreadEnv());
+}
+
+int Server::millisUntilNextWindowCloses() {
+    unique_lock<recursive_mutex> lock(mutationMutex);
+    if (eventBursts.empty()) {
+        return -1;
+    }
+    auto now = chrono::steady_clock::now();
+    auto nextClose = chrono::steady_clock::time_point::max();
+    for (auto& it : eventBursts) {
+        nextClose = min(nextClose, it.second.windowStart + invalidationWindow);
+    }
+    if (nextClose <= now) {
+        return 0;
+    }
+    // Round up so we don't wake up just before the window closes
+    auto remaining = chrono::duration_cast<chrono::milliseconds>(nextClose - now) + chrono::milliseconds(1);
+    return (int) min(remaining.count(), (chrono::milliseconds::rep) numeric_limits<int>::max());
+}
+
+bool Server::suppressEventInBurst(JNIEnv* env, const u16string& watchRoot) {
+    if (invalidationThreshold <= 0) {
+        return false;
+    }
+    auto now = chrono::steady_clock::now();
+    auto it = eventBursts.find(watchRoot);
+    if (it == eventBursts.end()) {
+        it = eventBursts.emplace(watchRoot, EventBurst(now)).first;
+    } else if (it->second.windowStart + invalidationWindow <= now) {
+        // The previous window has closed, but we haven't got around to report it yet
+        if (it->second.invalidated) {
+            reportChangeEvent(env, ChangeType::INVALIDATED, watchRoot);
+        }
+        it->second = EventBurst(now);
+    }
+
+    auto& burst = it->second;
+    burst.eventCount++;
+    if (burst.invalidated) {
+        return true;
+    }
+    if (burst.eventCount > invalidationThreshold) {
+        logToJava(LogLevel::FINE, "Received more than %d events for %s, summarizing remaining events in window",
+            invalidationThreshold, utf16ToUtf8String(watchRoot).c_str());
+        burst.invalidated = true;
+        return true;
+    }
+    return false;
+}
+
+void Server::closeExpiredWindows(JNIEnv* env) {
+    unique_lock<recursive_mutex> lock(mutationMutex);
+    auto now = chrono::steady_clock::now();
+    for (auto it = eventBursts.begin(); it != eventBursts.end();) {
+        auto& burst = it->second;
+        if (burst.windowStart + invalidationWindow > now) {
+            ++it;
+            continue;
+        }
+        if (burst.invalidated && !shouldTerminate) {
+            logToJava(LogLevel::FINE, "Summarized %d events as invalidation of %s",
+                burst.eventCount, utf16ToUtf8String(it->first).c_str());
+            reportChangeEvent(env, ChangeType::INVALIDATED, it->first);
+        }
+        it = eventBursts.erase(it);
+    }
 }
 
 void Server::handleEvents() {
@@ -190,6 +267,8 @@ void Server::handleEvent(JNIEnv* env, const inotify_event* event) {
 
     // Overflow received, handle gracefully
     if (IS_SET(mask, IN_Q_OVERFLOW)) {
+        // Overflow supersedes any pending invalidation
+        eventBursts.clear();
         for (auto it : watchPoints) {
             auto path = it.first;
             reportOverflow(env, path);
@@ -225,6 +304,16 @@ void Server::handleEvent(JNIEnv* env, const inotify_event* event) {
         logToJava(LogLevel::FINE, "Finished watching still registered '%s' (wd = %d)",
             utf16ToUtf8String(path).c_str(), event->wd);
         watchRoots.erase(event->wd);
+        // Events for the root, such as its removal, may have been suppressed by a burst, so report it before it is dropped
+        auto iBurst = eventBursts.find(path);
+        if (iBurst != eventBursts.end()) {
+            if (iBurst->second.invalidated && !shouldTerminate) {
+                logToJava(LogLevel::FINE, "Summarized %d events as invalidation of %s before it stopped being watched",
+                    iBurst->second.eventCount, utf16ToUtf8String(path).c_str());
+                reportChangeEvent(env, ChangeType::INVALIDATED, path);
+            }
+            eventBursts.erase(iBurst);
+        }
         watchPoints.erase(path);
         return;
     }
@@ -242,6 +331,7 @@ void Server::handleEvent(JNIEnv* env, const inotify_event* event) {
     }
 
     ChangeType type;
+    const u16string& watchRoot = iWatchRoot->second;
     const u16string name = utf8ToUtf16String(eventName);
 
     if (!name.empty()) {
@@ -261,6 +351,10 @@ void Server::handleEvent(JNIEnv* env, const inotify_event* event) {
         return;
     }
 
+    if (suppressEventInBurst(env, watchRoot)) {
+        return;
+    }
+
     reportChangeEvent(env, type, path);
 }
 
@@ -323,6 +417,7 @@ bool Server::unregisterPath(const u16string& path) {
     }
     recentlyUnregisteredWatchRoots.emplace(wd, path);
     watchRoots.erase(wd);
+    eventBursts.erase(path);
     // We use the path instead erase(it) here because on Alpine Linux we've seen crashes happen here
     // when inside a Docker container a host-mapped directory is watched. There is no good theory as
     // of this writing why the problem occurs, but not using the iterator here fixes it.
@@ -370,9 +465,9 @@ void Server::addToList(JNIEnv* env, jobject jList, jstring jString) {
 }
 
 JNIEXPORT jobject JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_LinuxFileEventFunctions_startWatcher0(JNIEnv* env, jclass, jobject javaCallback) {
+Java_net_rubygrapefruit_platform_internal_jni_LinuxFileEventFunctions_startWatcher0(JNIEnv* env, jclass, jint invalidationThreshold, jlong invalidationWindowInMillis, jobject javaCallback) {
     try {
-        return wrapServer(env, new Server(env, javaCallback));
+        return wrapServer(env, new Server(env, javaCallback, invalidationThreshold, invalidationWindowInMillis));
     } catch (const InotifyInstanceLimitTooLowException& e) {
         rethrowAsJavaException(env, e, linuxJniConstants->inotifyInstanceLimitTooLowExceptionClass.get());
         return NULL;
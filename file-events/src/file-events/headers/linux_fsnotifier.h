@@ -2,6 +2,7 @@
 
 #ifdef __linux__
 
+#include <chrono>
 #include <poll.h>
 #include <sys/eventfd.h>
 #include <sys/inotify.h>
@@ -88,9 +89,25 @@ private:
     friend class Server;
 };
 
+/**
+ * Counts the events received for a single watch point during the current invalidation window.
+ */
+struct EventBurst {
+    EventBurst(chrono::steady_clock::time_point windowStart);
+
+    chrono::steady_clock::time_point windowStart;
+    int eventCount;
+
+    /**
+     * The threshold has been exceeded, further events are suppressed and
+     * the watch point is reported as invalidated when the window closes.
+     */
+    bool invalidated;
+};
+
 class Server : public AbstractServer {
 public:
-    Server(JNIEnv* env, jobject watcherCallback);
+    Server(JNIEnv* env, jobject watcherCallback, int invalidationThreshold, long invalidationWindowInMillis);
 
     // List<String> absolutePathsToCheck, List<String> droppedPaths
     void stopWatchingMovedPaths(jobjectArray absolutePathsToCheck, jobject droppedPaths);
@@ -108,6 +125,10 @@ private:
     void handleEvents();
     void handleEvent(JNIEnv* env, const inotify_event* event);
 
+    int millisUntilNextWindowCloses();
+    bool suppressEventInBurst(JNIEnv* env, const u16string& watchRoot);
+    void closeExpiredWindows(JNIEnv* env);
+
     void registerPath(const u16string& path);
     bool unregisterPath(const u16string& path);
 
@@ -117,7 +138,10 @@ private:
     unordered_map<u16string, WatchPoint> watchPoints;
     unordered_map<int, u16string> watchRoots;
     unordered_map<int, u16string> recentlyUnregisteredWatchRoots;
+    unordered_map<u16string, EventBurst> eventBursts;
     const shared_ptr<Inotify> inotify;
+    const int invalidationThreshold;
+    const chrono::milliseconds invalidationWindow;
     const ShutdownEvent shutdownEvent;
     bool shouldTerminate = false;
     vector<uint8_t> buffer;
@@ -34,12 +34,18 @@ import java.util.concurrent.TimeUnit;
  * <h3>Remarks:</h3>
  *
  * <ul>
+ *     <li>Bursts of changes in a watched directory, like the ones caused by a {@code git checkout},
+ *     can be summarized as a single {@link FileWatchEvent.ChangeType#INVALIDATED} event,
+ *     see {@link WatcherBuilder#withSubtreeInvalidation(int, long, TimeUnit)}.</li>
+ *
  *     <li>Events arrive from a single background thread unique to the {@link FileWatcher}.
  *     Calling methods from the {@link FileWatcher} inside the callback method is undefined
  *     behavior and can lead to a deadlock.</li>
  * </ul>
  */
 public class LinuxFileEventFunctions extends AbstractFileEventFunctions<LinuxFileEventFunctions.LinuxFileWatcher> {
+    private static final int DEFAULT_INVALIDATION_THRESHOLD = 0;
+    private static final long DEFAULT_INVALIDATION_WINDOW_IN_MS = 0;
 
     public LinuxFileEventFunctions() {
         // We have seen some weird behavior on Alpine Linux that uses musl with Gradle that lead to crashes
@@ -81,13 +87,35 @@ public class LinuxFileEventFunctions extends AbstractFileEventFunctions<LinuxFil
     }
 
     public static class WatcherBuilder extends AbstractWatcherBuilder<LinuxFileWatcher> {
+        private int invalidationThreshold = DEFAULT_INVALIDATION_THRESHOLD;
+        private long invalidationWindowInMillis = DEFAULT_INVALIDATION_WINDOW_IN_MS;
+
         WatcherBuilder(BlockingQueue<FileWatchEvent> eventQueue) {
             super(eventQueue);
         }
 
+        /**
+         * Summarize bursts of changes in a watched directory.
+         * When more than {@code eventThreshold} events arrive for the same watched directory
+         * within the given window, the first {@code eventThreshold} events are reported as usual,
+         * the rest are dropped, and a single {@link FileWatchEvent.ChangeType#INVALIDATED} event
+         * is reported for the watched directory when the window closes.
+         *
+         * The default is {@value DEFAULT_INVALIDATION_THRESHOLD}, meaning all events are reported.
+         *
+         * @param eventThreshold the number of events to report before summarizing, {@code 0} meaning no summarizing.
+         * @param window the time window in which events are counted.
+         * @param unit the time unit for {@code window}.
+         */
+        public WatcherBuilder withSubtreeInvalidation(int eventThreshold, long window, TimeUnit unit) {
+            invalidationThreshold = eventThreshold;
+            invalidationWindowInMillis = unit.toMillis(window);
+            return this;
+        }
+
         @Override
         protected Object startWatcher(NativeFileWatcherCallback callback) throws InotifyInstanceLimitTooLowException {
-            return startWatcher0(callback);
+            return startWatcher0(invalidationThreshold, invalidationWindowInMillis, callback);
         }
 
         @Override
@@ -96,5 +124,5 @@ public class LinuxFileEventFunctions extends AbstractFileEventFunctions<LinuxFil
         }
     }
 
-    private static native Object startWatcher0(NativeFileWatcherCallback callback);
+    private static native Object startWatcher0(int invalidationThreshold, long invalidationWindowInMillis, NativeFileWatcherCallback callback);
 }
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020 the original author or authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file
+
+import net.rubygrapefruit.platform.internal.Platform
+import net.rubygrapefruit.platform.internal.jni.LinuxFileEventFunctions
+import spock.lang.Requires
+
+import java.util.concurrent.TimeUnit
+
+import static java.util.concurrent.TimeUnit.SECONDS
+import static net.rubygrapefruit.platform.file.FileWatchEvent.ChangeType.CREATED
+import static net.rubygrapefruit.platform.file.FileWatchEvent.ChangeType.INVALIDATED
+import static net.rubygrapefruit.platform.file.FileWatchEvent.ChangeType.REMOVED
+
+@Requires({ Platform.current().linux })
+class LinuxFileEventFunctionsTest extends AbstractFileEventFunctionsTest {
+
+    def "summarizes burst of changes as invalidation of watched directory"() {
+        given:
+        def watchedDir = new File(rootDir, "watched")
+        assert watchedDir.mkdirs()
+        def createdFiles = (1..20).collect { new File(watchedDir, "created-${it}.txt") }
+        watcher = startSummarizingWatcher(5, 500, watchedDir)
+
+        when:
+        createdFiles.each { createNewFile(it) }
+
+        then:
+        expectEvents(eventQueue, 5, SECONDS, createdFiles.take(5).collect { change(CREATED, it) } + change(INVALIDATED, watchedDir))
+    }
+
+    def "reports changes individually when below threshold"() {
+        given:
+        def watchedDir = new File(rootDir, "watched")
+        assert watchedDir.mkdirs()
+        def createdFiles = (1..3).collect { new File(watchedDir, "created-${it}.txt") }
+        watcher = startSummarizingWatcher(5, 500, watchedDir)
+
+        when:
+        createdFiles.each { createNewFile(it) }
+
+        then:
+        expectEvents createdFiles.collect { change(CREATED, it) }
+    }
+
+    def "reports invalidation of watched directory removed during burst of changes"() {
+        given:
+        def watchedDir = new File(rootDir, "watched")
+        assert watchedDir.mkdirs()
+        def createdFiles = (1..20).collect { new File(watchedDir, "created-${it}.txt") }
+        createdFiles.each { createNewFile(it) }
+        watcher = startSummarizingWatcher(5, 500, watchedDir)
+
+        when:
+        assert watchedDir.deleteDir()
+
+        then:
+        // Which of the removals are reported before the burst is summarized depends on the order of the directory
+        expectEvents(eventQueue, 5, SECONDS, createdFiles.collect { optionalChange(REMOVED, it) } + optionalChange(REMOVED, watchedDir) + change(INVALIDATED, watchedDir))
+    }
+
+    private FileWatcher startSummarizingWatcher(int threshold, long windowInMillis, File... roots) {
+        waitForChangeEventLatency()
+        def watcher = (watcherFixture.service as LinuxFileEventFunctions).newWatcher(eventQueue)
+            .withSubtreeInvalidation(threshold, windowInMillis, TimeUnit.MILLISECONDS)
+            .start()
+        watcher.startWatching(roots as List)
+        return watcher
+    }
+}
@@ -21,8 +21,10 @@
 
 #include "net_rubygrapefruit_platform_internal_jni_TerminfoFunctions.h"
 #include "generic.h"
+#include <pthread.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <curses.h>
 #include <term.h>
 
@@ -32,15 +34,39 @@
 #define TERMINAL_CHAR_TYPE int
 #endif
 
-const char* getcap(const char* capability) {
-    return tgetstr((char*)capability, NULL);
-}
-
-#define BUFFER_LEN 20
-
-int is_init = 0;
-int buffer_pos = 0;
-jbyte buffer[BUFFER_LEN];
+// Resolved by JNI_OnLoad()
+jfieldID terminalNameFieldId;
+jfieldID terminalSequencesFieldId;
+
+// Corresponds to the table layout of TerminalCapabilities
+#define SEQUENCE_BOLD_ON 0
+#define SEQUENCE_DIM_ON 1
+#define SEQUENCE_RESET 2
+#define SEQUENCE_DEFAULT_FOREGROUND 3
+#define SEQUENCE_HIDE_CURSOR 4
+#define SEQUENCE_SHOW_CURSOR 5
+#define SEQUENCE_UP 6
+#define SEQUENCE_DOWN 7
+#define SEQUENCE_LEFT 8
+#define SEQUENCE_RIGHT 9
+#define SEQUENCE_START_LINE 10
+#define SEQUENCE_CLEAR_TO_END_OF_LINE 11
+#define SEQUENCE_FOREGROUND 12
+#define SEQUENCE_COLOR_COUNT 8
+#define SEQUENCE_COUNT (SEQUENCE_FOREGROUND + SEQUENCE_COLOR_COUNT)
+
+// The termcap names of the plain capabilities, in table order
+static const char* const sequenceCapabilities[SEQUENCE_FOREGROUND] = {
+    "md", "mh", "me", "op", "vi", "ve", "up", "do", "le", "nd", "cr", "ce"
+};
+
+#define BUFFER_LEN 256
+
+// The termcap functions are not thread-safe, and tputs() has no way to pass the buffer to the output function
+static pthread_mutex_t terminfoLock = PTHREAD_MUTEX_INITIALIZER;
+static const char* terminalType = NULL;
+static int buffer_pos = 0;
+static jbyte buffer[BUFFER_LEN];
 
 int write_to_buffer(TERMINAL_CHAR_TYPE ch) {
     if (buffer_pos == BUFFER_LEN) {
@@ -53,35 +79,58 @@ int write_to_buffer(TERMINAL_CHAR_TYPE ch) {
     return ch;
 }
 
-jbyteArray byte_array_for_capability(JNIEnv *env, const char* capability, jobject result) {
+/*
+ * Renders the given capability and adds it to the table. Leaves the entry null when the terminal does not have the capability.
+ */
+bool add_sequence(JNIEnv *env, jobjectArray sequences, int index, const char* capability, jobject result) {
+    if (capability == NULL) {
+        return true;
+    }
     buffer_pos = 0;
     if (tputs((char*)capability, 1, write_to_buffer) == ERR) {
         mark_failed_with_message(env, "could not write to buffer", result);
-        return NULL;
+        return false;
     }
     jbyteArray bytes = env->NewByteArray(buffer_pos);
+    if (bytes == NULL) {
+        return false;
+    }
     env->SetByteArrayRegion(bytes, 0, buffer_pos, buffer);
-    return bytes;
+    env->SetObjectArrayElement(sequences, index, bytes);
+    env->DeleteLocalRef(bytes);
+    return true;
 }
 
-jbyteArray read_capability(JNIEnv *env, const char* capability, jobject result) {
-    if (capability == NULL) {
+/*
+ * Resolves and renders every sequence that TerminfoTerminal uses. Must hold the lock.
+ */
+jobjectArray create_sequences(JNIEnv *env, jobject result) {
+    jclass byteArrayClass = env->FindClass("[B");
+    if (byteArrayClass == NULL) {
         return NULL;
     }
-    return byte_array_for_capability(env, capability, result);
-}
-
-jbyteArray read_param_capability(JNIEnv *env, const char* capability, int count, jobject result) {
-    if (capability == NULL) {
+    jobjectArray sequences = env->NewObjectArray(SEQUENCE_COUNT, byteArrayClass, NULL);
+    env->DeleteLocalRef(byteArrayClass);
+    if (sequences == NULL) {
         return NULL;
     }
-
-    capability = tparm((char*)capability, count, 0, 0, 0, 0, 0, 0, 0, 0);
-    if (capability == NULL) {
-        mark_failed_with_message(env, "could not format terminal capability string", result);
-        return NULL;
+    for (int i = 0; i < SEQUENCE_FOREGROUND; i++) {
+        if (!add_sequence(env, sequences, i, tgetstr((char*)sequenceCapabilities[i], NULL), result)) {
+            return NULL;
+        }
     }
-    return byte_array_for_capability(env, capability, result);
+    const char* setForeground = tgetstr((char*)"AF", NULL);
+    for (int color = 0; setForeground != NULL && color < SEQUENCE_COLOR_COUNT; color++) {
+        const char* sequence = tparm((char*)setForeground, color, 0, 0, 0, 0, 0, 0, 0, 0);
+        if (sequence == NULL) {
+            mark_failed_with_message(env, "could not format terminal capability string", result);
+            return NULL;
+        }
+        if (!add_sequence(env, sequences, SEQUENCE_FOREGROUND + color, sequence, result)) {
+            return NULL;
+        }
+    }
+    return sequences;
 }
 
 JNIEXPORT jstring JNICALL
@@ -95,89 +144,55 @@ Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_initTerminal(JNI
         mark_failed_with_message(env, "not a terminal", result);
         return;
     }
-    if (is_init == 0) {
+    pthread_mutex_lock(&terminfoLock);
+    if (terminalType == NULL) {
         char* termType = getenv("TERM");
         if (termType == NULL) {
             mark_failed_with_message(env, "$TERM not set", result);
+            pthread_mutex_unlock(&terminfoLock);
             return;
         }
         int retval = tgetent(NULL, termType);
         if (retval != 1) {
             mark_failed_with_message(env, "could not get termcap entry", result);
+            pthread_mutex_unlock(&terminfoLock);
             return;
         }
-
-        jclass destClass = env->GetObjectClass(capabilities);
-        jfieldID field = env->GetFieldID(destClass, "terminalName", "Ljava/lang/String;");
-        jstring jtermType = char_to_java(env, termType, result);
-        env->SetObjectField(capabilities, field, jtermType);
+        // Keep a copy, as the environment can be changed later
+        terminalType = strdup(termType);
     }
-    is_init = 1;
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_boldOn(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("md"), result);
-}
 
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_dimOn(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("mh"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_reset(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("me"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_foreground(JNIEnv *env, jclass target, jint color, jobject result) {
-    return read_param_capability(env, getcap("AF"), color, result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_up(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("up"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_down(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("do"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_left(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("le"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_right(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("nd"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_startLine(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("cr"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_clearToEndOfLine(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("ce"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_defaultForeground(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("op"), result);
-}
-
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_hideCursor(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("vi"), result);
+    jstring jtermType = char_to_java(env, terminalType, result);
+    if (jtermType != NULL) {
+        env->SetObjectField(capabilities, terminalNameFieldId, jtermType);
+        jobjectArray sequences = create_sequences(env, result);
+        if (sequences != NULL) {
+            env->SetObjectField(capabilities, terminalSequencesFieldId, sequences);
+        }
+    }
+    pthread_mutex_unlock(&terminfoLock);
 }
 
-JNIEXPORT jbyteArray JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_TerminfoFunctions_showCursor(JNIEnv *env, jclass target, jobject result) {
-    return read_capability(env, getcap("ve"), result);
+JNIEXPORT jint JNICALL
+JNI_OnLoad(JavaVM* jvm, void*) {
+    JNIEnv* env;
+    jint ret = jvm->GetEnv((void**) &env, JNI_VERSION_1_6);
+    if (ret != JNI_OK) {
+        return -1;
+    }
+    if (!init_generic_ids(env)) {
+        return JNI_ERR;
+    }
+    jclass capabilitiesClass = find_global_class(env, "net/rubygrapefruit/platform/internal/TerminalCapabilities");
+    if (capabilitiesClass == NULL) {
+        return JNI_ERR;
+    }
+    terminalNameFieldId = env->GetFieldID(capabilitiesClass, "terminalName", "Ljava/lang/String;");
+    terminalSequencesFieldId = env->GetFieldID(capabilitiesClass, "sequences", "[[B");
+    if (terminalNameFieldId == NULL || terminalSequencesFieldId == NULL) {
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_6;
 }
 
 #endif
@@ -20,6 +20,7 @@
 #if defined(__APPLE__)
 
 #include "generic.h"
+#include "posix_ids.h"
 #include "net_rubygrapefruit_platform_internal_jni_MemoryFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_OsxMemoryFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions.h"
@@ -58,10 +59,6 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
         return;
     }
 
-    jclass info_class = env->GetObjectClass(info);
-    jmethodID method = env->GetMethodID(info_class, "add", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ZZZ)V");
-    jmethodID unknownFsMethod = env->GetMethodID(info_class, "addForUnknownCaseSensitivity", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Z)V");
-
     for (int i = 0; i < fs_count; i++) {
         struct attrlist alist;
         memset(&alist, 0, sizeof(alist));
@@ -77,7 +74,7 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
         // getattrlist requires the path to the actual mount point.
         int err = getattrlist(buf[i].f_mntonname, &alist, &buffer, sizeof(buffer), 0);
         if (err != 0) {
-            env->CallVoidMethod(info, unknownFsMethod, mount_point, file_system_type, device_name, remote);
+            env->CallVoidMethod(info, fileSystemListAddForUnknownCaseSensitivityMethodId, mount_point, file_system_type, device_name, remote);
         } else {
             jboolean caseSensitive = JNI_TRUE;
             jboolean casePreserving = JNI_TRUE;
@@ -91,7 +88,7 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
                 }
             }
 
-            env->CallVoidMethod(info, method, mount_point, file_system_type, device_name, remote, caseSensitive, casePreserving);
+            env->CallVoidMethod(info, fileSystemListAddMethodId, mount_point, file_system_type, device_name, remote, caseSensitive, casePreserving);
         }
     }
     free(buf);
@@ -20,6 +20,7 @@
 #if defined(__FreeBSD__)
 
 #include "generic.h"
+#include "posix_ids.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions.h"
 #include <errno.h>
 #include <stdlib.h>
@@ -48,9 +49,6 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
         return;
     }
 
-    jclass info_class = env->GetObjectClass(info);
-    jmethodID method = env->GetMethodID(info_class, "add", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ZZZ)V");
-
     for (int i = 0; i < fs_count; i++) {
         jboolean caseSensitive = JNI_TRUE;
         jboolean casePreserving = JNI_TRUE;
@@ -59,7 +57,7 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
         jstring file_system_type = char_to_java(env, buf[i].f_fstypename, result);
         jstring device_name = char_to_java(env, buf[i].f_mntfromname, result);
         jboolean remote = (buf[i].f_flags & MNT_LOCAL) == 0;
-        env->CallVoidMethod(info, method, mount_point, file_system_type, device_name, remote, caseSensitive, casePreserving);
+        env->CallVoidMethod(info, fileSystemListAddMethodId, mount_point, file_system_type, device_name, remote, caseSensitive, casePreserving);
     }
     free(buf);
 }
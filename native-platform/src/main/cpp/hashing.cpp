@@ -0,0 +1,637 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Hash algorithms used for file hashing: XXH3 (64 bit), SHA-256 and BLAKE3.
+ * These are portable implementations following the reference implementations of each algorithm.
+ */
+#ifndef _WIN32
+
+#include "hashing.h"
+#include <string.h>
+
+static inline uint32_t read_le32(const unsigned char* p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline uint64_t read_le64(const unsigned char* p) {
+    return (uint64_t) read_le32(p) | ((uint64_t) read_le32(p + 4) << 32);
+}
+
+static inline uint32_t read_be32(const unsigned char* p) {
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+static inline void write_be32(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char) (value >> 24);
+    p[1] = (unsigned char) (value >> 16);
+    p[2] = (unsigned char) (value >> 8);
+    p[3] = (unsigned char) value;
+}
+
+static inline void write_be64(unsigned char* p, uint64_t value) {
+    write_be32(p, (uint32_t) (value >> 32));
+    write_be32(p + 4, (uint32_t) value);
+}
+
+static inline void write_le32(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char) value;
+    p[1] = (unsigned char) (value >> 8);
+    p[2] = (unsigned char) (value >> 16);
+    p[3] = (unsigned char) (value >> 24);
+}
+
+static inline uint32_t rotr32(uint32_t value, int count) {
+    return (value >> count) | (value << (32 - count));
+}
+
+static inline uint64_t rotl64(uint64_t value, int count) {
+    return (value << count) | (value >> (64 - count));
+}
+
+/*
+ * XXH3, 64 bit variant with the default secret and seed 0
+ */
+
+#define XXH3_STRIPE_LEN 64
+#define XXH3_SECRET_LEN 192
+#define XXH3_SECRET_CONSUME_RATE 8
+#define XXH3_STRIPES_PER_BLOCK ((XXH3_SECRET_LEN - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE)
+#define XXH3_BLOCK_LEN (XXH3_STRIPE_LEN * XXH3_STRIPES_PER_BLOCK)
+#define XXH3_BUFFER_LEN 256
+#define XXH3_BUFFER_STRIPES (XXH3_BUFFER_LEN / XXH3_STRIPE_LEN)
+#define XXH3_SECRET_LASTACC_START 7
+#define XXH3_SECRET_MERGEACCS_START 11
+#define XXH3_MIDSIZE_MAX 240
+#define XXH3_MIDSIZE_STARTOFFSET 3
+#define XXH3_MIDSIZE_LASTOFFSET 17
+#define XXH3_SECRET_SIZE_MIN 136
+
+static const uint32_t XXH_PRIME32_1 = 0x9E3779B1U;
+static const uint32_t XXH_PRIME32_2 = 0x85EBCA77U;
+static const uint32_t XXH_PRIME32_3 = 0xC2B2AE3DU;
+static const uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+static const uint64_t XXH_PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64_t XXH_PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+static const unsigned char XXH3_SECRET[XXH3_SECRET_LEN] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+typedef struct xxh3_state {
+    uint64_t acc[8];
+    unsigned char buffer[XXH3_BUFFER_LEN];
+    size_t bufferedLen;
+    size_t stripesSoFar;
+    uint64_t totalLen;
+} xxh3_state_t;
+
+static inline uint64_t xxh_mul128_fold64(uint64_t lhs, uint64_t rhs) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128) lhs * rhs;
+    return (uint64_t) product ^ (uint64_t) (product >> 64);
+#else
+    uint64_t loLo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+    uint64_t hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+    uint64_t loHi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+    uint64_t hiHi = (lhs >> 32) * (rhs >> 32);
+    uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+    uint64_t upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+    uint64_t lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t xxh64_avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint64_t xxh3_avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= XXH_PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint64_t xxh3_rrmxmx(uint64_t h, uint64_t len) {
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= XXH_PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= XXH_PRIME_MX2;
+    return h ^ (h >> 28);
+}
+
+static inline uint64_t xxh3_mix16(const unsigned char* input, const unsigned char* secret) {
+    return xxh_mul128_fold64(read_le64(input) ^ read_le64(secret), read_le64(input + 8) ^ read_le64(secret + 8));
+}
+
+/*
+ * Hashes an input of at most XXH3_MIDSIZE_MAX bytes in one go.
+ */
+static uint64_t xxh3_hash_short(const unsigned char* input, size_t len) {
+    const unsigned char* secret = XXH3_SECRET;
+    if (len == 0) {
+        return xxh64_avalanche(read_le64(secret + 56) ^ read_le64(secret + 64));
+    }
+    if (len <= 3) {
+        uint32_t combined = ((uint32_t) input[0] << 16) | ((uint32_t) input[len >> 1] << 24) | (uint32_t) input[len - 1] | ((uint32_t) len << 8);
+        uint64_t bitflip = read_le32(secret) ^ read_le32(secret + 4);
+        return xxh64_avalanche((uint64_t) combined ^ bitflip);
+    }
+    if (len <= 8) {
+        uint64_t input64 = read_le32(input + len - 4) + ((uint64_t) read_le32(input) << 32);
+        uint64_t bitflip = read_le64(secret + 8) ^ read_le64(secret + 16);
+        return xxh3_rrmxmx(input64 ^ bitflip, len);
+    }
+    if (len <= 16) {
+        uint64_t inputLo = read_le64(input) ^ (read_le64(secret + 24) ^ read_le64(secret + 32));
+        uint64_t inputHi = read_le64(input + len - 8) ^ (read_le64(secret + 40) ^ read_le64(secret + 48));
+        uint64_t acc = len + __builtin_bswap64(inputLo) + inputHi + xxh_mul128_fold64(inputLo, inputHi);
+        return xxh3_avalanche(acc);
+    }
+    uint64_t acc = len * XXH_PRIME64_1;
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += xxh3_mix16(input + 48, secret + 96);
+                    acc += xxh3_mix16(input + len - 64, secret + 112);
+                }
+                acc += xxh3_mix16(input + 32, secret + 64);
+                acc += xxh3_mix16(input + len - 48, secret + 80);
+            }
+            acc += xxh3_mix16(input + 16, secret + 32);
+            acc += xxh3_mix16(input + len - 32, secret + 48);
+        }
+        acc += xxh3_mix16(input, secret);
+        acc += xxh3_mix16(input + len - 16, secret + 16);
+        return xxh3_avalanche(acc);
+    }
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; i++) {
+        acc += xxh3_mix16(input + 16 * i, secret + 16 * i);
+    }
+    acc = xxh3_avalanche(acc);
+    for (size_t i = 8; i < rounds; i++) {
+        acc += xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + XXH3_MIDSIZE_STARTOFFSET);
+    }
+    acc += xxh3_mix16(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET);
+    return xxh3_avalanche(acc);
+}
+
+static inline void xxh3_accumulate_stripe(uint64_t* acc, const unsigned char* input, const unsigned char* secret) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t value = read_le64(input + 8 * i);
+        uint64_t key = value ^ read_le64(secret + 8 * i);
+        acc[i ^ 1] += value;
+        acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+}
+
+static inline void xxh3_scramble(uint64_t* acc, const unsigned char* secret) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t value = acc[i];
+        value ^= value >> 47;
+        value ^= read_le64(secret + 8 * i);
+        value *= XXH_PRIME32_1;
+        acc[i] = value;
+    }
+}
+
+static void xxh3_accumulate(uint64_t* acc, const unsigned char* input, const unsigned char* secret, size_t stripes) {
+    for (size_t i = 0; i < stripes; i++) {
+        xxh3_accumulate_stripe(acc, input + i * XXH3_STRIPE_LEN, secret + i * XXH3_SECRET_CONSUME_RATE);
+    }
+}
+
+/*
+ * Accumulates the given stripes, scrambling the accumulators at the end of each block.
+ */
+static void xxh3_consume_stripes(uint64_t* acc, size_t* stripesSoFar, const unsigned char* input, size_t stripes) {
+    const unsigned char* secret = XXH3_SECRET;
+    if (XXH3_STRIPES_PER_BLOCK - *stripesSoFar <= stripes) {
+        size_t stripesToEnd = XXH3_STRIPES_PER_BLOCK - *stripesSoFar;
+        size_t stripesAfterBlock = stripes - stripesToEnd;
+        xxh3_accumulate(acc, input, secret + *stripesSoFar * XXH3_SECRET_CONSUME_RATE, stripesToEnd);
+        xxh3_scramble(acc, secret + XXH3_SECRET_LEN - XXH3_STRIPE_LEN);
+        xxh3_accumulate(acc, input + stripesToEnd * XXH3_STRIPE_LEN, secret, stripesAfterBlock);
+        *stripesSoFar = stripesAfterBlock;
+    } else {
+        xxh3_accumulate(acc, input, secret + *stripesSoFar * XXH3_SECRET_CONSUME_RATE, stripes);
+        *stripesSoFar += stripes;
+    }
+}
+
+static void xxh3_init(void* s) {
+    xxh3_state_t* state = (xxh3_state_t*) s;
+    state->acc[0] = XXH_PRIME32_3;
+    state->acc[1] = XXH_PRIME64_1;
+    state->acc[2] = XXH_PRIME64_2;
+    state->acc[3] = XXH_PRIME64_3;
+    state->acc[4] = XXH_PRIME64_4;
+    state->acc[5] = XXH_PRIME32_2;
+    state->acc[6] = XXH_PRIME64_5;
+    state->acc[7] = XXH_PRIME32_1;
+    state->bufferedLen = 0;
+    state->stripesSoFar = 0;
+    state->totalLen = 0;
+}
+
+static void xxh3_update(void* s, const unsigned char* input, size_t len) {
+    xxh3_state_t* state = (xxh3_state_t*) s;
+    const unsigned char* end = input + len;
+    state->totalLen += len;
+    if (len <= XXH3_BUFFER_LEN - state->bufferedLen) {
+        memcpy(state->buffer + state->bufferedLen, input, len);
+        state->bufferedLen += len;
+        return;
+    }
+    // Always keep at least one byte buffered, as the last stripe is handled differently
+    if (state->bufferedLen > 0) {
+        size_t loadLen = XXH3_BUFFER_LEN - state->bufferedLen;
+        memcpy(state->buffer + state->bufferedLen, input, loadLen);
+        input += loadLen;
+        xxh3_consume_stripes(state->acc, &state->stripesSoFar, state->buffer, XXH3_BUFFER_STRIPES);
+        state->bufferedLen = 0;
+    }
+    if (end - input > XXH3_BUFFER_LEN) {
+        const unsigned char* limit = end - XXH3_BUFFER_LEN;
+        do {
+            xxh3_consume_stripes(state->acc, &state->stripesSoFar, input, XXH3_BUFFER_STRIPES);
+            input += XXH3_BUFFER_LEN;
+        } while (input < limit);
+        // Keep the last stripe, in case it is needed for the digest
+        memcpy(state->buffer + XXH3_BUFFER_LEN - XXH3_STRIPE_LEN, input - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN);
+    }
+    memcpy(state->buffer, input, end - input);
+    state->bufferedLen = end - input;
+}
+
+static void xxh3_digest(void* s, unsigned char* digest) {
+    xxh3_state_t* state = (xxh3_state_t*) s;
+    uint64_t hash;
+    if (state->totalLen > XXH3_MIDSIZE_MAX) {
+        uint64_t acc[8];
+        memcpy(acc, state->acc, sizeof(acc));
+        const unsigned char* lastStripe;
+        unsigned char lastStripeBuffer[XXH3_STRIPE_LEN];
+        if (state->bufferedLen >= XXH3_STRIPE_LEN) {
+            size_t stripes = (state->bufferedLen - 1) / XXH3_STRIPE_LEN;
+            size_t stripesSoFar = state->stripesSoFar;
+            xxh3_consume_stripes(acc, &stripesSoFar, state->buffer, stripes);
+            lastStripe = state->buffer + state->bufferedLen - XXH3_STRIPE_LEN;
+        } else {
+            size_t catchupLen = XXH3_STRIPE_LEN - state->bufferedLen;
+            memcpy(lastStripeBuffer, state->buffer + XXH3_BUFFER_LEN - catchupLen, catchupLen);
+            memcpy(lastStripeBuffer + catchupLen, state->buffer, state->bufferedLen);
+            lastStripe = lastStripeBuffer;
+        }
+        xxh3_accumulate_stripe(acc, lastStripe, XXH3_SECRET + XXH3_SECRET_LEN - XXH3_STRIPE_LEN - XXH3_SECRET_LASTACC_START);
+
+        hash = state->totalLen * XXH_PRIME64_1;
+        const unsigned char* secret = XXH3_SECRET + XXH3_SECRET_MERGEACCS_START;
+        for (int i = 0; i < 4; i++) {
+            hash += xxh_mul128_fold64(acc[2 * i] ^ read_le64(secret + 16 * i), acc[2 * i + 1] ^ read_le64(secret + 16 * i + 8));
+        }
+        hash = xxh3_avalanche(hash);
+    } else {
+        hash = xxh3_hash_short(state->buffer, (size_t) state->totalLen);
+    }
+    write_be64(digest, hash);
+}
+
+/*
+ * SHA-256
+ */
+
+typedef struct sha256_state {
+    uint32_t h[8];
+    unsigned char block[64];
+    size_t blockLen;
+    uint64_t totalLen;
+} sha256_state_t;
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// Also used as the BLAKE3 IV
+static const uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static void sha256_compress(uint32_t* h, const unsigned char* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = read_be32(block + 4 * i);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = k + s1 + ch + SHA256_K[i] + w[i];
+        uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += k;
+}
+
+static void sha256_init(void* s) {
+    sha256_state_t* state = (sha256_state_t*) s;
+    memcpy(state->h, SHA256_IV, sizeof(state->h));
+    state->blockLen = 0;
+    state->totalLen = 0;
+}
+
+static void sha256_update(void* s, const unsigned char* input, size_t len) {
+    sha256_state_t* state = (sha256_state_t*) s;
+    state->totalLen += len;
+    if (state->blockLen > 0) {
+        size_t fill = 64 - state->blockLen < len ? 64 - state->blockLen : len;
+        memcpy(state->block + state->blockLen, input, fill);
+        state->blockLen += fill;
+        input += fill;
+        len -= fill;
+        if (state->blockLen < 64) {
+            return;
+        }
+        sha256_compress(state->h, state->block);
+        state->blockLen = 0;
+    }
+    while (len >= 64) {
+        sha256_compress(state->h, input);
+        input += 64;
+        len -= 64;
+    }
+    memcpy(state->block, input, len);
+    state->blockLen = len;
+}
+
+static void sha256_digest(void* s, unsigned char* digest) {
+    sha256_state_t* state = (sha256_state_t*) s;
+    uint64_t bitLen = state->totalLen * 8;
+    state->block[state->blockLen++] = 0x80;
+    if (state->blockLen > 56) {
+        memset(state->block + state->blockLen, 0, 64 - state->blockLen);
+        sha256_compress(state->h, state->block);
+        state->blockLen = 0;
+    }
+    memset(state->block + state->blockLen, 0, 56 - state->blockLen);
+    write_be64(state->block + 56, bitLen);
+    sha256_compress(state->h, state->block);
+    for (int i = 0; i < 8; i++) {
+        write_be32(digest + 4 * i, state->h[i]);
+    }
+}
+
+/*
+ * BLAKE3, unkeyed hashing with 32 byte output
+ */
+
+#define BLAKE3_BLOCK_LEN 64
+#define BLAKE3_CHUNK_LEN 1024
+#define BLAKE3_CHUNK_START 1
+#define BLAKE3_CHUNK_END 2
+#define BLAKE3_PARENT 4
+#define BLAKE3_ROOT 8
+// Enough for 2^54 chunks
+#define BLAKE3_MAX_DEPTH 54
+
+static const unsigned char BLAKE3_MSG_PERMUTATION[16] = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+
+typedef struct blake3_chunk {
+    uint32_t cv[8];
+    uint64_t counter;
+    unsigned char block[BLAKE3_BLOCK_LEN];
+    size_t blockLen;
+    size_t blocksCompressed;
+} blake3_chunk_t;
+
+typedef struct blake3_state {
+    blake3_chunk_t chunk;
+    uint32_t cvStack[BLAKE3_MAX_DEPTH][8];
+    size_t cvStackLen;
+} blake3_state_t;
+
+static inline void blake3_g(uint32_t* state, int a, int b, int c, int d, uint32_t mx, uint32_t my) {
+    state[a] = state[a] + state[b] + mx;
+    state[d] = rotr32(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + my;
+    state[d] = rotr32(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32(state[b] ^ state[c], 7);
+}
+
+static void blake3_compress(const uint32_t* cv, const unsigned char* block, size_t blockLen, uint64_t counter, uint32_t flags, uint32_t* out) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; i++) {
+        m[i] = read_le32(block + 4 * i);
+    }
+    uint32_t state[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        SHA256_IV[0], SHA256_IV[1], SHA256_IV[2], SHA256_IV[3],
+        (uint32_t) counter, (uint32_t) (counter >> 32), (uint32_t) blockLen, flags,
+    };
+    for (int round = 0; round < 7; round++) {
+        blake3_g(state, 0, 4, 8, 12, m[0], m[1]);
+        blake3_g(state, 1, 5, 9, 13, m[2], m[3]);
+        blake3_g(state, 2, 6, 10, 14, m[4], m[5]);
+        blake3_g(state, 3, 7, 11, 15, m[6], m[7]);
+        blake3_g(state, 0, 5, 10, 15, m[8], m[9]);
+        blake3_g(state, 1, 6, 11, 12, m[10], m[11]);
+        blake3_g(state, 2, 7, 8, 13, m[12], m[13]);
+        blake3_g(state, 3, 4, 9, 14, m[14], m[15]);
+        uint32_t permuted[16];
+        for (int i = 0; i < 16; i++) {
+            permuted[i] = m[BLAKE3_MSG_PERMUTATION[i]];
+        }
+        memcpy(m, permuted, sizeof(m));
+    }
+    for (int i = 0; i < 8; i++) {
+        out[i] = state[i] ^ state[i + 8];
+    }
+}
+
+static void blake3_chunk_init(blake3_chunk_t* chunk, uint64_t counter) {
+    memcpy(chunk->cv, SHA256_IV, sizeof(chunk->cv));
+    chunk->counter = counter;
+    chunk->blockLen = 0;
+    chunk->blocksCompressed = 0;
+}
+
+static inline size_t blake3_chunk_len(blake3_chunk_t* chunk) {
+    return BLAKE3_BLOCK_LEN * chunk->blocksCompressed + chunk->blockLen;
+}
+
+static inline uint32_t blake3_chunk_start_flag(blake3_chunk_t* chunk) {
+    return chunk->blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0;
+}
+
+static void blake3_chunk_update(blake3_chunk_t* chunk, const unsigned char* input, size_t len) {
+    while (len > 0) {
+        // Only compress a full block once more input arrives, the last block is compressed with different flags
+        if (chunk->blockLen == BLAKE3_BLOCK_LEN) {
+            blake3_compress(chunk->cv, chunk->block, BLAKE3_BLOCK_LEN, chunk->counter, blake3_chunk_start_flag(chunk), chunk->cv);
+            chunk->blocksCompressed++;
+            chunk->blockLen = 0;
+        }
+        size_t take = BLAKE3_BLOCK_LEN - chunk->blockLen < len ? BLAKE3_BLOCK_LEN - chunk->blockLen : len;
+        memcpy(chunk->block + chunk->blockLen, input, take);
+        chunk->blockLen += take;
+        input += take;
+        len -= take;
+    }
+}
+
+/*
+ * Compresses the last block of a chunk, giving the chaining value of the chunk, or the root hash when flags include BLAKE3_ROOT.
+ */
+static void blake3_chunk_output(blake3_chunk_t* chunk, uint32_t flags, uint32_t* out) {
+    unsigned char block[BLAKE3_BLOCK_LEN];
+    memset(block, 0, sizeof(block));
+    memcpy(block, chunk->block, chunk->blockLen);
+    blake3_compress(chunk->cv, block, chunk->blockLen, chunk->counter, blake3_chunk_start_flag(chunk) | BLAKE3_CHUNK_END | flags, out);
+}
+
+static void blake3_parent_output(const uint32_t* left, const uint32_t* right, uint32_t flags, uint32_t* out) {
+    unsigned char block[BLAKE3_BLOCK_LEN];
+    for (int i = 0; i < 8; i++) {
+        write_le32(block + 4 * i, left[i]);
+        write_le32(block + 32 + 4 * i, right[i]);
+    }
+    blake3_compress(SHA256_IV, block, BLAKE3_BLOCK_LEN, 0, BLAKE3_PARENT | flags, out);
+}
+
+static void blake3_init(void* s) {
+    blake3_state_t* state = (blake3_state_t*) s;
+    blake3_chunk_init(&state->chunk, 0);
+    state->cvStackLen = 0;
+}
+
+static void blake3_add_chunk_cv(blake3_state_t* state, uint32_t* cv, uint64_t totalChunks) {
+    // Merge completed subtrees, one per trailing zero bit of the chunk count
+    while ((totalChunks & 1) == 0) {
+        state->cvStackLen--;
+        blake3_parent_output(state->cvStack[state->cvStackLen], cv, 0, cv);
+        totalChunks >>= 1;
+    }
+    memcpy(state->cvStack[state->cvStackLen], cv, 8 * sizeof(uint32_t));
+    state->cvStackLen++;
+}
+
+static void blake3_update(void* s, const unsigned char* input, size_t len) {
+    blake3_state_t* state = (blake3_state_t*) s;
+    while (len > 0) {
+        // Only finish a chunk once more input arrives, the last chunk is handled by the digest
+        if (blake3_chunk_len(&state->chunk) == BLAKE3_CHUNK_LEN) {
+            uint32_t cv[8];
+            blake3_chunk_output(&state->chunk, 0, cv);
+            uint64_t totalChunks = state->chunk.counter + 1;
+            blake3_add_chunk_cv(state, cv, totalChunks);
+            blake3_chunk_init(&state->chunk, totalChunks);
+        }
+        size_t available = BLAKE3_CHUNK_LEN - blake3_chunk_len(&state->chunk);
+        size_t take = available < len ? available : len;
+        blake3_chunk_update(&state->chunk, input, take);
+        input += take;
+        len -= take;
+    }
+}
+
+static void blake3_digest(void* s, unsigned char* digest) {
+    blake3_state_t* state = (blake3_state_t*) s;
+    uint32_t out[8];
+    if (state->cvStackLen == 0) {
+        blake3_chunk_output(&state->chunk, BLAKE3_ROOT, out);
+    } else {
+        uint32_t cv[8];
+        blake3_chunk_output(&state->chunk, 0, cv);
+        size_t remaining = state->cvStackLen;
+        while (remaining > 1) {
+            remaining--;
+            blake3_parent_output(state->cvStack[remaining], cv, 0, cv);
+        }
+        blake3_parent_output(state->cvStack[0], cv, BLAKE3_ROOT, out);
+    }
+    for (int i = 0; i < 8; i++) {
+        write_le32(digest + 4 * i, out[i]);
+    }
+}
+
+static const hash_algorithm_t ALGORITHMS[] = {
+    { 8, sizeof(xxh3_state_t), xxh3_init, xxh3_update, xxh3_digest },
+    { 32, sizeof(sha256_state_t), sha256_init, sha256_update, sha256_digest },
+    { 32, sizeof(blake3_state_t), blake3_init, blake3_update, blake3_digest },
+};
+
+const hash_algorithm_t* hash_algorithm(int algorithm) {
+    if (algorithm < 0 || algorithm >= (int) (sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]))) {
+        return NULL;
+    }
+    return &ALGORITHMS[algorithm];
+}
+
+#endif
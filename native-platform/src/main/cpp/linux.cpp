@@ -20,38 +20,355 @@
 #ifdef __linux__
 
 #include "generic.h"
+#include "linux.h"
+#include "posix_ids.h"
+#include "net_rubygrapefruit_platform_internal_jni_LinuxFileSystemFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions.h"
 #include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <mntent.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/inotify.h>
 #include <unistd.h>
 
 /*
  * File system functions
  */
+
+/*
+ * Returns true for file system types whose storage is on another machine.
+ */
+bool is_remote_file_system(const char* type) {
+    static const char* remoteTypes[] = {
+        "nfs", "nfs4", "cifs", "smb3", "smbfs", "ncpfs", "afs", "9p", "ceph", "glusterfs", "lustre", "gpfs", "fuse.sshfs", "davfs", NULL
+    };
+    for (int i = 0; remoteTypes[i] != NULL; i++) {
+        if (strcmp(type, remoteTypes[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void file_system_case_sensitivity(const char* type, jboolean* caseSensitive, jboolean* casePreserving) {
+    if (strcmp(type, "vfat") == 0 || strcmp(type, "exfat") == 0) {
+        *caseSensitive = JNI_FALSE;
+        *casePreserving = JNI_TRUE;
+    } else if (strcmp(type, "msdos") == 0) {
+        *caseSensitive = JNI_FALSE;
+        *casePreserving = JNI_FALSE;
+    } else {
+        *caseSensitive = JNI_TRUE;
+        *casePreserving = JNI_TRUE;
+    }
+}
+
+/*
+ * Replaces the octal escapes that mountinfo uses for spaces, tabs, newlines and backslashes, in place.
+ */
+char* unescape_mount_field(char* field) {
+    char* out = field;
+    for (char* in = field; *in != '\0'; in++) {
+        if (in[0] == '\\' && in[1] >= '0' && in[1] <= '3' && in[2] >= '0' && in[2] <= '7' && in[3] >= '0' && in[3] <= '7') {
+            *out++ = (char) (((in[1] - '0') << 6) | ((in[2] - '0') << 3) | (in[3] - '0'));
+            in += 3;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return field;
+}
+
+/*
+ * Parses a line of mountinfo, in place. The format of a line is:
+ *
+ * mount-id parent-id major:minor root mount-point mount-options [optional-fields...] - type source super-options
+ */
+bool parse_mountinfo_line(char* line, char** fields, char** optionalFields) {
+    // The 6 leading fields, then the 3 fields following the separator
+    int count = 0;
+    bool afterSeparator = false;
+    char* optionalStart = NULL;
+    char* optionalEnd = NULL;
+    char* save = NULL;
+    for (char* token = strtok_r(line, " \n", &save); token != NULL; token = strtok_r(NULL, " \n", &save)) {
+        if (!afterSeparator && count == 6) {
+            if (strcmp(token, "-") == 0) {
+                afterSeparator = true;
+                if (optionalEnd != NULL) {
+                    *optionalEnd = '\0';
+                }
+            } else {
+                if (optionalStart == NULL) {
+                    optionalStart = token;
+                } else {
+                    // Join the optional fields back together, separated by a single space
+                    token[-1] = ' ';
+                }
+                optionalEnd = token + strlen(token);
+            }
+            continue;
+        }
+        if (count < 9) {
+            fields[count++] = token;
+        }
+    }
+    *optionalFields = optionalStart == NULL ? (char*) "" : optionalStart;
+    return count == 9;
+}
+
+/*
+ * Returns true when the given comma separated list contains the given item.
+ */
+bool list_contains(const char* list, const char* item) {
+    size_t len = strlen(item);
+    for (const char* start = list; start != NULL; start = strchr(start, ',')) {
+        if (*start == ',') {
+            start++;
+        }
+        if (strncmp(start, item, len) == 0 && (start[len] == ',' || start[len] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Returns true when the given controller is enabled in the cgroup v2 hierarchy mounted at the given directory.
+ */
+bool cgroup2_has_controller(const char* mountPoint, const char* controller) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/cgroup.controllers", mountPoint) >= (int) sizeof(path)) {
+        return false;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char controllers[1024];
+    ssize_t len = pread_file(fd, controllers, sizeof(controllers));
+    close(fd);
+    if (len < 0) {
+        return false;
+    }
+    // The controllers are separated by spaces
+    size_t controllerLen = strlen(controller);
+    for (char* start = strstr(controllers, controller); start != NULL; start = strstr(start + 1, controller)) {
+        bool startsWord = start == controllers || start[-1] == ' ';
+        bool endsWord = start[controllerLen] == ' ' || start[controllerLen] == '\n' || start[controllerLen] == '\0';
+        if (startsWord && endsWord) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int find_cgroup_dir(const char* controller, char* dir, size_t dirLen) {
+    // Find the path of the cgroup of this process in each hierarchy. Lines have the format: hierarchy-id:controllers:path
+    FILE* fp = fopen("/proc/self/cgroup", "re");
+    if (fp == NULL) {
+        return CGROUP_VERSION_NONE;
+    }
+    char* v1Path = NULL;
+    char* v2Path = NULL;
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    while (getline(&line, &lineCapacity, fp) >= 0) {
+        line[strcspn(line, "\n")] = '\0';
+        char* controllers = strchr(line, ':');
+        char* path = controllers == NULL ? NULL : strchr(controllers + 1, ':');
+        if (path == NULL) {
+            continue;
+        }
+        *controllers++ = '\0';
+        *path++ = '\0';
+        if (strcmp(line, "0") == 0 && *controllers == '\0') {
+            free(v2Path);
+            v2Path = strdup(path);
+        } else if (list_contains(controllers, controller)) {
+            free(v1Path);
+            v1Path = strdup(path);
+        }
+    }
+    fclose(fp);
+
+    // Find where the hierarchy is mounted
+    int version = CGROUP_VERSION_NONE;
+    fp = v1Path == NULL && v2Path == NULL ? NULL : fopen(MOUNTINFO_FILE, "re");
+    while (fp != NULL && version != CGROUP_VERSION_1 && getline(&line, &lineCapacity, fp) >= 0) {
+        char* fields[9];
+        char* optionalFields;
+        if (!parse_mountinfo_line(line, fields, &optionalFields)) {
+            continue;
+        }
+        int mountVersion;
+        const char* path;
+        if (v1Path != NULL && strcmp(fields[6], "cgroup") == 0 && list_contains(fields[8], controller)) {
+            mountVersion = CGROUP_VERSION_1;
+            path = v1Path;
+        } else if (v2Path != NULL && version == CGROUP_VERSION_NONE && strcmp(fields[6], "cgroup2") == 0
+                && cgroup2_has_controller(unescape_mount_field(fields[4]), controller)) {
+            mountVersion = CGROUP_VERSION_2;
+            path = v2Path;
+        } else {
+            continue;
+        }
+        const char* root = unescape_mount_field(fields[3]);
+        const char* mountPoint = unescape_mount_field(fields[4]);
+
+        // The mount may expose only part of the hierarchy, for example in a container
+        size_t rootLen = strcmp(root, "/") == 0 ? 0 : strlen(root);
+        const char* relativePath = strncmp(path, root, rootLen) == 0 ? path + rootLen : "";
+        if (strcmp(relativePath, "/") == 0) {
+            relativePath = "";
+        }
+        if (snprintf(dir, dirLen, "%s%s", mountPoint, relativePath) >= (int) dirLen || access(dir, F_OK) != 0) {
+            // The cgroup is not visible through the mount, which happens in a container without a cgroup namespace,
+            // where the root of the mount is the cgroup of the container
+            if (snprintf(dir, dirLen, "%s", mountPoint) >= (int) dirLen) {
+                continue;
+            }
+        }
+        version = mountVersion;
+    }
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    free(line);
+    free(v1Path);
+    free(v2Path);
+    return version;
+}
+
+ssize_t pread_file(int fd, char* buffer, size_t bufferLen) {
+    size_t len = 0;
+    while (len < bufferLen - 1) {
+        ssize_t count = pread(fd, buffer + len, bufferLen - 1 - len, len);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (count == 0) {
+            break;
+        }
+        len += count;
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+/*
+ * Lists the file systems using mountinfo, which carries mount ids, the root of bind mounts and propagation details.
+ *
+ * Returns false when mountinfo is not available.
+ */
+bool list_mountinfo(JNIEnv* env, jobject info, jobject result) {
+    FILE* fp = fopen(MOUNTINFO_FILE, "re");
+    if (fp == NULL) {
+        return false;
+    }
+
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    while (getline(&line, &lineCapacity, fp) >= 0) {
+        char* fields[9];
+        char* optionalFields;
+        if (!parse_mountinfo_line(line, fields, &optionalFields)) {
+            continue;
+        }
+        int mountId = atoi(fields[0]);
+        int parentId = atoi(fields[1]);
+        unsigned int major = 0;
+        unsigned int minor = 0;
+        sscanf(fields[2], "%u:%u", &major, &minor);
+        const char* type = fields[6];
+        jboolean caseSensitive;
+        jboolean casePreserving;
+        file_system_case_sensitivity(type, &caseSensitive, &casePreserving);
+
+        jstring mountPoint = char_to_java(env, unescape_mount_field(fields[4]), result);
+        jstring fileSystemType = char_to_java(env, type, result);
+        jstring deviceName = char_to_java(env, unescape_mount_field(fields[7]), result);
+        jstring root = char_to_java(env, unescape_mount_field(fields[3]), result);
+        jstring mountOptions = char_to_java(env, fields[5], result);
+        jstring propagation = char_to_java(env, optionalFields, result);
+        jstring superOptions = char_to_java(env, fields[8], result);
+        env->CallVoidMethod(info, fileSystemListAddMountMethodId, mountPoint, fileSystemType, deviceName, is_remote_file_system(type) ? JNI_TRUE : JNI_FALSE,
+            caseSensitive, casePreserving, (jint) mountId, (jint) parentId, (jint) major, (jint) minor, root, mountOptions, propagation, superOptions);
+        env->DeleteLocalRef(mountPoint);
+        env->DeleteLocalRef(fileSystemType);
+        env->DeleteLocalRef(deviceName);
+        env->DeleteLocalRef(root);
+        env->DeleteLocalRef(mountOptions);
+        env->DeleteLocalRef(propagation);
+        env->DeleteLocalRef(superOptions);
+        if (env->ExceptionCheck()) {
+            break;
+        }
+    }
+
+    free(line);
+    fclose(fp);
+    return true;
+}
+
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileSystems(JNIEnv* env, jclass target, jobject info, jobject result) {
+    if (list_mountinfo(env, info, result)) {
+        return;
+    }
+
     FILE* fp = setmntent(MOUNTED, "r");
     if (fp == NULL) {
         mark_failed_with_errno(env, "could not open mount file", result);
         return;
     }
-    char buf[1024];
+    char buf[4096];
     struct mntent mount_info;
 
-    jclass info_class = env->GetObjectClass(info);
-    jmethodID method = env->GetMethodID(info_class, "add", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ZZZ)V");
-
     while (getmntent_r(fp, &mount_info, buf, sizeof(buf)) != NULL) {
+        jboolean caseSensitive;
+        jboolean casePreserving;
+        file_system_case_sensitivity(mount_info.mnt_type, &caseSensitive, &casePreserving);
         jstring mount_point = char_to_java(env, mount_info.mnt_dir, result);
         jstring file_system_type = char_to_java(env, mount_info.mnt_type, result);
         jstring device_name = char_to_java(env, mount_info.mnt_fsname, result);
-        env->CallVoidMethod(info, method, mount_point, file_system_type, device_name, JNI_FALSE, JNI_TRUE, JNI_TRUE);
+        env->CallVoidMethod(info, fileSystemListAddMethodId, mount_point, file_system_type, device_name, is_remote_file_system(mount_info.mnt_type) ? JNI_TRUE : JNI_FALSE, caseSensitive, casePreserving);
     }
 
     endmntent(fp);
 }
 
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxFileSystemFunctions_openMountTableWatch(JNIEnv* env, jclass target, jobject result) {
+    int fd = open(MOUNTINFO_FILE, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        mark_failed_with_errno(env, "could not open mount table", result);
+    }
+    return fd;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxFileSystemFunctions_mountTableChanged(JNIEnv* env, jclass target, jint fd, jobject result) {
+    // The kernel flags the file with POLLPRI and POLLERR when a file system has been mounted or unmounted since the last poll
+    struct pollfd pollInfo;
+    pollInfo.fd = fd;
+    pollInfo.events = POLLPRI;
+    pollInfo.revents = 0;
+    int retval = poll(&pollInfo, 1, 0);
+    if (retval < 0) {
+        mark_failed_with_errno(env, "could not poll mount table", result);
+        return JNI_TRUE;
+    }
+    return retval > 0 && (pollInfo.revents & (POLLPRI | POLLERR)) != 0 ? JNI_TRUE : JNI_FALSE;
+}
+
 #endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Linux CPU functions.
+ */
+#ifdef __linux__
+
+#include "generic.h"
+#include "linux.h"
+#include "net_rubygrapefruit_platform_internal_jni_LinuxCpuFunctions.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <set>
+#include <utility>
+
+// Corresponds to the record layout of DefaultCpuInfo
+#define CPU_RECORD_ONLINE_PROCESSORS 0
+#define CPU_RECORD_AVAILABLE_PROCESSORS 1
+#define CPU_RECORD_CORES 2
+#define CPU_RECORD_PACKAGES 3
+#define CPU_RECORD_NUMA_NODES 4
+#define CPU_RECORD_CGROUP_QUOTA 5
+#define CPU_RECORD_CGROUP_PERIOD 6
+#define CPU_RECORD_LEN 7
+
+#define CPU_FILE_BUFFER_SIZE 4096
+
+// Upper bound for the size of the affinity mask, which depends on the CPU count the kernel was configured for
+#define MAX_CPUS (1 << 16)
+
+/*
+ * Reads the given small file into the given buffer. Returns false when the file cannot be read.
+ */
+bool read_cpu_file(const char* path, char* buffer, size_t bufferLen) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t len = pread_file(fd, buffer, bufferLen);
+    close(fd);
+    return len > 0;
+}
+
+/*
+ * Returns the integer content of the given file, or -1 when the file cannot be read.
+ */
+long long read_cpu_file_value(const char* path) {
+    char buffer[64];
+    if (!read_cpu_file(path, buffer, sizeof(buffer))) {
+        return -1;
+    }
+    return strtoll(buffer, NULL, 10);
+}
+
+/*
+ * Adds the CPUs of a list in the kernel's format, such as "0-3,8,10-11", to the given set.
+ */
+void parse_cpu_list(const char* list, cpu_set_t* set, size_t setSize) {
+    const char* pos = list;
+    while (*pos >= '0' && *pos <= '9') {
+        char* end;
+        long first = strtol(pos, &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < MAX_CPUS; cpu++) {
+            CPU_SET_S(cpu, setSize, set);
+        }
+        pos = *end == ',' ? end + 1 : end;
+    }
+}
+
+/*
+ * Reads the CPU quota of the cgroup of the current process, as microseconds of CPU time per period.
+ */
+void read_cgroup_cpu_quota(jlong* quota, jlong* period) {
+    *quota = -1;
+    *period = -1;
+    char dir[PATH_MAX];
+    char path[PATH_MAX];
+    int version = find_cgroup_dir("cpu", dir, sizeof(dir));
+    if (version == CGROUP_VERSION_2) {
+        // The format is "$MAX $PERIOD", where $MAX is "max" when there is no quota
+        char buffer[64];
+        if (snprintf(path, sizeof(path), "%s/cpu.max", dir) < (int) sizeof(path)
+                && read_cpu_file(path, buffer, sizeof(buffer)) && strncmp(buffer, "max", 3) != 0) {
+            char* end;
+            *quota = strtoll(buffer, &end, 10);
+            *period = strtoll(end, NULL, 10);
+        }
+    } else if (version == CGROUP_VERSION_1) {
+        // A path that does not fit is treated as no quota
+        if (snprintf(path, sizeof(path), "%s/cpu.cfs_quota_us", dir) < (int) sizeof(path)) {
+            long long value = read_cpu_file_value(path);
+            if (value > 0 && snprintf(path, sizeof(path), "%s/cpu.cfs_period_us", dir) < (int) sizeof(path)) {
+                *quota = value;
+                *period = read_cpu_file_value(path);
+            }
+        }
+    }
+    if (*quota <= 0 || *period <= 0) {
+        *quota = -1;
+        *period = -1;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxCpuFunctions_getCpuInfo(JNIEnv* env, jclass target, jlongArray record, jobject result) {
+    if (env->GetArrayLength(record) < CPU_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+
+    // The affinity mask reflects both taskset and the cpuset of the cgroup. Grow it until it is large enough for the kernel
+    int cpuCount = CPU_SETSIZE;
+    cpu_set_t* affinity = NULL;
+    size_t setSize = 0;
+    while (true) {
+        affinity = CPU_ALLOC(cpuCount);
+        setSize = CPU_ALLOC_SIZE(cpuCount);
+        if (affinity == NULL) {
+            mark_failed_with_message(env, "could not allocate CPU set", result);
+            return;
+        }
+        CPU_ZERO_S(setSize, affinity);
+        if (sched_getaffinity(0, setSize, affinity) == 0) {
+            break;
+        }
+        CPU_FREE(affinity);
+        if (errno != EINVAL || cpuCount >= MAX_CPUS) {
+            mark_failed_with_errno(env, "could not query CPU affinity", result);
+            return;
+        }
+        cpuCount *= 2;
+    }
+
+    jlong values[CPU_RECORD_LEN];
+    values[CPU_RECORD_ONLINE_PROCESSORS] = sysconf(_SC_NPROCESSORS_ONLN);
+    values[CPU_RECORD_AVAILABLE_PROCESSORS] = CPU_COUNT_S(setSize, affinity);
+
+    // Count the distinct cores and packages of the CPUs that this process can run on
+    std::set<std::pair<long long, long long> > cores;
+    std::set<long long> packages;
+    char path[PATH_MAX];
+    for (int cpu = 0; cpu < cpuCount; cpu++) {
+        if (!CPU_ISSET_S(cpu, setSize, affinity)) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        long long package = read_cpu_file_value(path);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        long long core = read_cpu_file_value(path);
+        // When the topology is not available, treat each CPU as a separate core
+        cores.insert(core < 0 ? std::make_pair(-1LL - cpu, -1LL) : std::make_pair(package, core));
+        packages.insert(package);
+    }
+    values[CPU_RECORD_CORES] = cores.size();
+    values[CPU_RECORD_PACKAGES] = packages.size();
+
+    // Count the NUMA nodes that have at least one of the CPUs that this process can run on
+    jlong nodes = 0;
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir != NULL) {
+        cpu_set_t* nodeCpus = CPU_ALLOC(cpuCount);
+        char buffer[CPU_FILE_BUFFER_SIZE];
+        struct dirent* entry;
+        while (nodeCpus != NULL && (entry = readdir(dir)) != NULL) {
+            if (strncmp(entry->d_name, "node", 4) != 0 || entry->d_name[4] < '0' || entry->d_name[4] > '9') {
+                continue;
+            }
+            snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", entry->d_name);
+            if (!read_cpu_file(path, buffer, sizeof(buffer))) {
+                continue;
+            }
+            CPU_ZERO_S(setSize, nodeCpus);
+            parse_cpu_list(buffer, nodeCpus, setSize);
+            CPU_AND_S(setSize, nodeCpus, nodeCpus, affinity);
+            if (CPU_COUNT_S(setSize, nodeCpus) > 0) {
+                nodes++;
+            }
+        }
+        if (nodeCpus != NULL) {
+            CPU_FREE(nodeCpus);
+        }
+        closedir(dir);
+    }
+    // Kernels without NUMA support do not have the node directory
+    values[CPU_RECORD_NUMA_NODES] = nodes > 0 ? nodes : 1;
+    CPU_FREE(affinity);
+
+    read_cgroup_cpu_quota(&values[CPU_RECORD_CGROUP_QUOTA], &values[CPU_RECORD_CGROUP_PERIOD]);
+    env->SetLongArrayRegion(record, 0, CPU_RECORD_LEN, values);
+}
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Linux memory functions.
+ */
+#ifdef __linux__
+
+#include "generic.h"
+#include "linux.h"
+#include "net_rubygrapefruit_platform_internal_jni_LinuxMemoryFunctions.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Corresponds to the record layout of DefaultLinuxMemoryInfo
+#define MEMORY_RECORD_TOTAL 0
+#define MEMORY_RECORD_AVAILABLE 1
+#define MEMORY_RECORD_CGROUP_VERSION 2
+#define MEMORY_RECORD_CGROUP_LIMIT 3
+#define MEMORY_RECORD_CGROUP_HIGH 4
+#define MEMORY_RECORD_CGROUP_USAGE 5
+#define MEMORY_RECORD_LEN 6
+
+#define MEMINFO_BUFFER_SIZE 8192
+#define CGROUP_VALUE_BUFFER_SIZE 64
+
+// cgroup v1 reports no limit as the largest multiple of the page size
+#define CGROUP_UNLIMITED_THRESHOLD (LLONG_MAX / 2)
+
+/*
+ * The files are opened once and then read again with pread() for each query, as daemons sample memory often.
+ */
+typedef struct memory_files {
+    int meminfo;
+    int cgroupVersion;
+    int cgroupLimit;
+    int cgroupHigh;
+    int cgroupUsage;
+} memory_files_t;
+
+static pthread_once_t memoryFilesOnce = PTHREAD_ONCE_INIT;
+static memory_files_t memoryFiles;
+
+int open_cgroup_file(const char* dir, const char* name) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int) sizeof(path)) {
+        return -1;
+    }
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+void open_memory_files() {
+    memoryFiles.meminfo = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    memoryFiles.cgroupLimit = -1;
+    memoryFiles.cgroupHigh = -1;
+    memoryFiles.cgroupUsage = -1;
+
+    char dir[PATH_MAX];
+    memoryFiles.cgroupVersion = find_cgroup_dir("memory", dir, sizeof(dir));
+    if (memoryFiles.cgroupVersion == CGROUP_VERSION_2) {
+        memoryFiles.cgroupLimit = open_cgroup_file(dir, "memory.max");
+        memoryFiles.cgroupHigh = open_cgroup_file(dir, "memory.high");
+        memoryFiles.cgroupUsage = open_cgroup_file(dir, "memory.current");
+    } else if (memoryFiles.cgroupVersion == CGROUP_VERSION_1) {
+        memoryFiles.cgroupLimit = open_cgroup_file(dir, "memory.limit_in_bytes");
+        memoryFiles.cgroupHigh = open_cgroup_file(dir, "memory.soft_limit_in_bytes");
+        memoryFiles.cgroupUsage = open_cgroup_file(dir, "memory.usage_in_bytes");
+    }
+    if (memoryFiles.cgroupUsage < 0) {
+        // The root cgroup does not have the memory files
+        memoryFiles.cgroupVersion = CGROUP_VERSION_NONE;
+    }
+}
+
+/*
+ * Returns the value in bytes of the given field of /proc/meminfo, or -1 when the field is not present.
+ */
+jlong meminfo_field(const char* meminfo, const char* name) {
+    size_t nameLen = strlen(name);
+    for (const char* line = meminfo; line != NULL && *line != '\0'; line = strchr(line, '\n')) {
+        if (*line == '\n') {
+            line++;
+        }
+        if (strncmp(line, name, nameLen) == 0 && line[nameLen] == ':') {
+            // Values are reported in kB
+            return strtoll(line + nameLen + 1, NULL, 10) * 1024;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Reads a cgroup memory value in bytes. Returns -1 when the file is not available or when there is no limit.
+ */
+jlong read_cgroup_value(int fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    char buffer[CGROUP_VALUE_BUFFER_SIZE];
+    if (pread_file(fd, buffer, sizeof(buffer)) <= 0 || strncmp(buffer, "max", 3) == 0) {
+        return -1;
+    }
+    long long value = strtoll(buffer, NULL, 10);
+    return value >= CGROUP_UNLIMITED_THRESHOLD ? -1 : (jlong) value;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxMemoryFunctions_getLinuxMemoryInfo(JNIEnv* env, jclass target, jlongArray record, jobject result) {
+    if (env->GetArrayLength(record) < MEMORY_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+    pthread_once(&memoryFilesOnce, open_memory_files);
+    if (memoryFiles.meminfo < 0) {
+        mark_failed_with_message(env, "could not open /proc/meminfo", result);
+        return;
+    }
+
+    char meminfo[MEMINFO_BUFFER_SIZE];
+    if (pread_file(memoryFiles.meminfo, meminfo, sizeof(meminfo)) < 0) {
+        mark_failed_with_errno(env, "could not read /proc/meminfo", result);
+        return;
+    }
+
+    jlong values[MEMORY_RECORD_LEN];
+    values[MEMORY_RECORD_TOTAL] = meminfo_field(meminfo, "MemTotal");
+    values[MEMORY_RECORD_AVAILABLE] = meminfo_field(meminfo, "MemAvailable");
+    if (values[MEMORY_RECORD_AVAILABLE] < 0) {
+        // Kernels before 3.14 do not report an estimate, so approximate it
+        values[MEMORY_RECORD_AVAILABLE] = meminfo_field(meminfo, "MemFree") + meminfo_field(meminfo, "Buffers") + meminfo_field(meminfo, "Cached");
+    }
+    values[MEMORY_RECORD_CGROUP_VERSION] = memoryFiles.cgroupVersion;
+    values[MEMORY_RECORD_CGROUP_LIMIT] = read_cgroup_value(memoryFiles.cgroupLimit);
+    values[MEMORY_RECORD_CGROUP_HIGH] = read_cgroup_value(memoryFiles.cgroupHigh);
+    values[MEMORY_RECORD_CGROUP_USAGE] = read_cgroup_value(memoryFiles.cgroupUsage);
+    env->SetLongArrayRegion(record, 0, MEMORY_RECORD_LEN, values);
+}
+
+#endif
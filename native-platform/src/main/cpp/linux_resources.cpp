@@ -0,0 +1,506 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Linux process resource sampling functions.
+ */
+#ifdef __linux__
+
+#include "generic.h"
+#include "linux.h"
+#include "net_rubygrapefruit_platform_internal_jni_LinuxResourceFunctions.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <set>
+#include <vector>
+
+// Corresponds to the file descriptor layout of DefaultProcessResourceSampler
+#define SAMPLER_FD_STAT 0
+#define SAMPLER_FD_STATUS 1
+#define SAMPLER_FD_IO 2
+#define SAMPLER_FD_PRESSURE_CPU 3
+#define SAMPLER_FD_PRESSURE_MEMORY 4
+#define SAMPLER_FD_PRESSURE_IO 5
+#define SAMPLER_FD_LEN 6
+
+// Corresponds to the record layout of DefaultProcessResourceSample
+#define SAMPLE_RECORD_TIMESTAMP 0
+#define SAMPLE_RECORD_USER_TIME 1
+#define SAMPLE_RECORD_SYSTEM_TIME 2
+#define SAMPLE_RECORD_THREADS 3
+#define SAMPLE_RECORD_RESIDENT 4
+#define SAMPLE_RECORD_PEAK_RESIDENT 5
+#define SAMPLE_RECORD_READ_CHARS 6
+#define SAMPLE_RECORD_WRITE_CHARS 7
+#define SAMPLE_RECORD_READ_BYTES 8
+#define SAMPLE_RECORD_WRITE_BYTES 9
+#define SAMPLE_RECORD_PRESSURE_CPU 10
+#define SAMPLE_RECORD_PRESSURE_MEMORY 18
+#define SAMPLE_RECORD_PRESSURE_IO 26
+#define SAMPLE_RECORD_LEN 34
+
+// Corresponds to the record layout of DefaultPressureStallInfo, relative to the start of the resource
+#define PRESSURE_RECORD_SOME 0
+#define PRESSURE_RECORD_FULL 4
+#define PRESSURE_RECORD_AVG10 0
+#define PRESSURE_RECORD_AVG60 1
+#define PRESSURE_RECORD_AVG300 2
+#define PRESSURE_RECORD_TOTAL 3
+#define PRESSURE_RECORD_LEN 8
+
+// Corresponds to the record layout of DefaultProcessTree, for each process of the tree
+#define TREE_RECORD_PID 0
+#define TREE_RECORD_PARENT_PID 1
+#define TREE_RECORD_USER_TIME 2
+#define TREE_RECORD_SYSTEM_TIME 3
+#define TREE_RECORD_RESIDENT 4
+#define TREE_RECORD_PROPORTIONAL 5
+#define TREE_RECORD_READ_BYTES 6
+#define TREE_RECORD_WRITE_BYTES 7
+#define TREE_RECORD_LEN 8
+
+#define SAMPLE_FILE_BUFFER_SIZE 4096
+
+// The fields of /proc/self/stat, counted from the process state that follows the command name
+#define STAT_FIELD_UTIME 11
+#define STAT_FIELD_STIME 12
+#define STAT_FIELD_PPID 1
+#define STAT_FIELD_NUM_THREADS 17
+#define STAT_FIELD_RSS 21
+
+/*
+ * Returns the value of the given "name: value" field of a /proc file, or -1 when the field is not present.
+ */
+jlong proc_field(const char* content, const char* name) {
+    size_t nameLen = strlen(name);
+    for (const char* line = content; line != NULL && *line != '\0'; line = strchr(line, '\n')) {
+        if (*line == '\n') {
+            line++;
+        }
+        if (strncmp(line, name, nameLen) == 0 && line[nameLen] == ':') {
+            return strtoll(line + nameLen + 1, NULL, 10);
+        }
+    }
+    return -1;
+}
+
+/*
+ * Parses a decimal with two fractional digits, as used for the PSI averages, into hundredths.
+ */
+jlong parse_hundredths(const char* str) {
+    char* end;
+    jlong value = strtoll(str, &end, 10) * 100;
+    if (*end == '.' && end[1] >= '0' && end[1] <= '9') {
+        value += (end[1] - '0') * 10;
+        if (end[2] >= '0' && end[2] <= '9') {
+            value += end[2] - '0';
+        }
+    }
+    return value;
+}
+
+/*
+ * Parses a line of a /proc/pressure file, such as "some avg10=0.12 avg60=0.05 avg300=0.01 total=1234".
+ */
+void parse_pressure_line(const char* line, jlong* values) {
+    const char* avg10 = strstr(line, "avg10=");
+    const char* avg60 = strstr(line, "avg60=");
+    const char* avg300 = strstr(line, "avg300=");
+    const char* total = strstr(line, "total=");
+    if (avg10 == NULL || avg60 == NULL || avg300 == NULL || total == NULL) {
+        return;
+    }
+    values[PRESSURE_RECORD_AVG10] = parse_hundredths(avg10 + 6);
+    values[PRESSURE_RECORD_AVG60] = parse_hundredths(avg60 + 6);
+    values[PRESSURE_RECORD_AVG300] = parse_hundredths(avg300 + 7);
+    values[PRESSURE_RECORD_TOTAL] = strtoll(total + 6, NULL, 10);
+}
+
+void sample_pressure(int fd, jlong* values) {
+    for (int i = 0; i < PRESSURE_RECORD_LEN; i++) {
+        values[i] = -1;
+    }
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    // Kernels booted with psi=0 have the files but fail to read them
+    if (fd < 0 || pread_file(fd, buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+    for (char* line = buffer; line != NULL; line = strchr(line, '\n')) {
+        if (*line == '\n') {
+            line++;
+        }
+        if (strncmp(line, "some ", 5) == 0) {
+            parse_pressure_line(line, values + PRESSURE_RECORD_SOME);
+        } else if (strncmp(line, "full ", 5) == 0) {
+            parse_pressure_line(line, values + PRESSURE_RECORD_FULL);
+        }
+    }
+}
+
+bool sample_stat(int fd, jlong* values) {
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    if (pread_file(fd, buffer, sizeof(buffer)) <= 0) {
+        return false;
+    }
+    // The command name can contain spaces and parentheses, so skip to the last ')'
+    char* pos = strrchr(buffer, ')');
+    if (pos == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+    pos++;
+    static long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    for (int field = 0; field <= STAT_FIELD_NUM_THREADS && *pos != '\0'; field++) {
+        while (*pos == ' ') {
+            pos++;
+        }
+        if (field == STAT_FIELD_UTIME) {
+            values[SAMPLE_RECORD_USER_TIME] = strtoll(pos, NULL, 10) * (1000000000LL / ticksPerSecond);
+        } else if (field == STAT_FIELD_STIME) {
+            values[SAMPLE_RECORD_SYSTEM_TIME] = strtoll(pos, NULL, 10) * (1000000000LL / ticksPerSecond);
+        } else if (field == STAT_FIELD_NUM_THREADS) {
+            values[SAMPLE_RECORD_THREADS] = strtoll(pos, NULL, 10);
+        }
+        while (*pos != ' ' && *pos != '\0') {
+            pos++;
+        }
+    }
+    return true;
+}
+
+void sample_status(int fd, jlong* values) {
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    if (fd < 0 || pread_file(fd, buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+    // Values are reported in kB
+    jlong resident = proc_field(buffer, "VmRSS");
+    jlong peakResident = proc_field(buffer, "VmHWM");
+    values[SAMPLE_RECORD_RESIDENT] = resident < 0 ? -1 : resident * 1024;
+    values[SAMPLE_RECORD_PEAK_RESIDENT] = peakResident < 0 ? -1 : peakResident * 1024;
+}
+
+void sample_io(int fd, jlong* values) {
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    if (fd < 0 || pread_file(fd, buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+    values[SAMPLE_RECORD_READ_CHARS] = proc_field(buffer, "rchar");
+    values[SAMPLE_RECORD_WRITE_CHARS] = proc_field(buffer, "wchar");
+    values[SAMPLE_RECORD_READ_BYTES] = proc_field(buffer, "read_bytes");
+    values[SAMPLE_RECORD_WRITE_BYTES] = proc_field(buffer, "write_bytes");
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxResourceFunctions_openSampler(JNIEnv* env, jclass target, jintArray fds, jobject result) {
+    if (env->GetArrayLength(fds) < SAMPLER_FD_LEN) {
+        mark_failed_with_message(env, "file descriptor array too small", result);
+        return;
+    }
+    jint values[SAMPLER_FD_LEN];
+    values[SAMPLER_FD_STAT] = open("/proc/self/stat", O_RDONLY | O_CLOEXEC);
+    if (values[SAMPLER_FD_STAT] < 0) {
+        mark_failed_with_errno(env, "could not open /proc/self/stat", result);
+        return;
+    }
+    // The remaining files are optional, as they depend on the kernel configuration
+    values[SAMPLER_FD_STATUS] = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+    values[SAMPLER_FD_IO] = open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+    values[SAMPLER_FD_PRESSURE_CPU] = open("/proc/pressure/cpu", O_RDONLY | O_CLOEXEC);
+    values[SAMPLER_FD_PRESSURE_MEMORY] = open("/proc/pressure/memory", O_RDONLY | O_CLOEXEC);
+    values[SAMPLER_FD_PRESSURE_IO] = open("/proc/pressure/io", O_RDONLY | O_CLOEXEC);
+    env->SetIntArrayRegion(fds, 0, SAMPLER_FD_LEN, values);
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxResourceFunctions_sample(JNIEnv* env, jclass target, jintArray fds, jlongArray record, jobject result) {
+    if (env->GetArrayLength(fds) < SAMPLER_FD_LEN || env->GetArrayLength(record) < SAMPLE_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+    jint fdValues[SAMPLER_FD_LEN];
+    env->GetIntArrayRegion(fds, 0, SAMPLER_FD_LEN, fdValues);
+
+    jlong values[SAMPLE_RECORD_LEN];
+    for (int i = 0; i < SAMPLE_RECORD_LEN; i++) {
+        values[i] = -1;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    values[SAMPLE_RECORD_TIMESTAMP] = (jlong) now.tv_sec * 1000000000LL + now.tv_nsec;
+
+    if (!sample_stat(fdValues[SAMPLER_FD_STAT], values)) {
+        mark_failed_with_errno(env, "could not read /proc/self/stat", result);
+        return;
+    }
+    sample_status(fdValues[SAMPLER_FD_STATUS], values);
+    sample_io(fdValues[SAMPLER_FD_IO], values);
+    sample_pressure(fdValues[SAMPLER_FD_PRESSURE_CPU], values + SAMPLE_RECORD_PRESSURE_CPU);
+    sample_pressure(fdValues[SAMPLER_FD_PRESSURE_MEMORY], values + SAMPLE_RECORD_PRESSURE_MEMORY);
+    sample_pressure(fdValues[SAMPLER_FD_PRESSURE_IO], values + SAMPLE_RECORD_PRESSURE_IO);
+    env->SetLongArrayRegion(record, 0, SAMPLE_RECORD_LEN, values);
+}
+
+/*
+ * Reads a file relative to the given /proc directory. Returns the length read, or -1 on failure.
+ */
+ssize_t read_proc_file(int procFd, const char* path, char* buffer, size_t bufferLen) {
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t len = pread_file(fd, buffer, bufferLen);
+    close(fd);
+    return len;
+}
+
+/*
+ * Reads the parent, CPU times and resident memory of the given process. Returns false when the process does not exist.
+ */
+bool read_tree_stat(int procFd, pid_t pid, jlong* values) {
+    char path[64];
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    snprintf(path, sizeof(path), "%d/stat", pid);
+    if (read_proc_file(procFd, path, buffer, sizeof(buffer)) <= 0) {
+        return false;
+    }
+    char* pos = strrchr(buffer, ')');
+    if (pos == NULL) {
+        return false;
+    }
+    pos++;
+    static long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    static long pageSize = sysconf(_SC_PAGESIZE);
+    for (int field = 0; field <= STAT_FIELD_RSS && *pos != '\0'; field++) {
+        while (*pos == ' ') {
+            pos++;
+        }
+        if (field == STAT_FIELD_PPID) {
+            values[TREE_RECORD_PARENT_PID] = strtoll(pos, NULL, 10);
+        } else if (field == STAT_FIELD_UTIME) {
+            values[TREE_RECORD_USER_TIME] = strtoll(pos, NULL, 10) * (1000000000LL / ticksPerSecond);
+        } else if (field == STAT_FIELD_STIME) {
+            values[TREE_RECORD_SYSTEM_TIME] = strtoll(pos, NULL, 10) * (1000000000LL / ticksPerSecond);
+        } else if (field == STAT_FIELD_RSS) {
+            values[TREE_RECORD_RESIDENT] = strtoll(pos, NULL, 10) * pageSize;
+        }
+        while (*pos != ' ' && *pos != '\0') {
+            pos++;
+        }
+    }
+    return true;
+}
+
+/*
+ * Reads the proportional memory and I/O of the given process. These are only readable for processes the caller is allowed to trace, and
+ * are left as -1 otherwise.
+ */
+void read_tree_usage(int procFd, pid_t pid, jlong* values) {
+    char path[64];
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    snprintf(path, sizeof(path), "%d/smaps_rollup", pid);
+    if (read_proc_file(procFd, path, buffer, sizeof(buffer)) > 0) {
+        // Reported in kB
+        jlong proportional = proc_field(buffer, "Pss");
+        values[TREE_RECORD_PROPORTIONAL] = proportional < 0 ? -1 : proportional * 1024;
+    }
+    snprintf(path, sizeof(path), "%d/io", pid);
+    if (read_proc_file(procFd, path, buffer, sizeof(buffer)) > 0) {
+        values[TREE_RECORD_READ_BYTES] = proc_field(buffer, "read_bytes");
+        values[TREE_RECORD_WRITE_BYTES] = proc_field(buffer, "write_bytes");
+    }
+}
+
+/*
+ * Returns true when the kernel provides /proc/<pid>/task/<tid>/children, which requires CONFIG_PROC_CHILDREN.
+ */
+bool children_supported(int procFd) {
+    char path[64];
+    snprintf(path, sizeof(path), "%d/task/%d/children", getpid(), getpid());
+    return faccessat(procFd, path, F_OK, 0) == 0;
+}
+
+/*
+ * Appends the children of each thread of the given process, from /proc/<pid>/task/<tid>/children.
+ */
+void read_children(int procFd, pid_t pid, std::vector<pid_t>& children) {
+    char path[64];
+    snprintf(path, sizeof(path), "%d/task", pid);
+    int taskFd = openat(procFd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (taskFd < 0) {
+        // The process has exited
+        return;
+    }
+    DIR* taskDir = fdopendir(taskFd);
+    if (taskDir == NULL) {
+        close(taskFd);
+        return;
+    }
+    char buffer[SAMPLE_FILE_BUFFER_SIZE];
+    while (struct dirent* entry = readdir(taskDir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        char childrenPath[NAME_MAX + sizeof("/children")];
+        snprintf(childrenPath, sizeof(childrenPath), "%s/children", entry->d_name);
+        int fd = openat(taskFd, childrenPath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            // The thread has exited
+            continue;
+        }
+        // The file is read in chunks, as its content can exceed the buffer, so a pid can be split across chunks
+        pid_t child = 0;
+        bool inPid = false;
+        while (true) {
+            ssize_t count = read(fd, buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            for (ssize_t i = 0; i < count; i++) {
+                if (buffer[i] >= '0' && buffer[i] <= '9') {
+                    child = child * 10 + (buffer[i] - '0');
+                    inPid = true;
+                } else if (inPid) {
+                    children.push_back(child);
+                    child = 0;
+                    inPid = false;
+                }
+            }
+        }
+        if (inPid) {
+            children.push_back(child);
+        }
+        close(fd);
+    }
+    closedir(taskDir);
+}
+
+/*
+ * Finds the parent of every process by scanning /proc, for kernels that do not provide the children files.
+ */
+void read_all_parents(int procFd, std::vector<std::pair<pid_t, pid_t> >& parents) {
+    int dirFd = dup(procFd);
+    if (dirFd < 0) {
+        return;
+    }
+    DIR* procDir = fdopendir(dirFd);
+    if (procDir == NULL) {
+        close(dirFd);
+        return;
+    }
+    rewinddir(procDir);
+    jlong values[TREE_RECORD_LEN];
+    while (struct dirent* entry = readdir(procDir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        pid_t pid = (pid_t) strtol(entry->d_name, NULL, 10);
+        if (read_tree_stat(procFd, pid, values)) {
+            parents.push_back(std::make_pair(pid, (pid_t) values[TREE_RECORD_PARENT_PID]));
+        }
+    }
+    closedir(procDir);
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxResourceFunctions_getProcessTree(JNIEnv* env, jclass target, jint pid, jlongArray records, jobject result) {
+    int procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procFd < 0) {
+        mark_failed_with_errno(env, "could not open /proc", result);
+        return 0;
+    }
+
+    // Walk the tree breadth first, so that parents are reported before their children
+    std::vector<jlong> values;
+    std::vector<pid_t> pending;
+    std::vector<std::pair<pid_t, pid_t> > parents;
+    std::set<pid_t> visited;
+    bool useChildren = children_supported(procFd);
+    if (!useChildren) {
+        read_all_parents(procFd, parents);
+    }
+    pending.push_back(pid);
+    for (size_t next = 0; next < pending.size(); next++) {
+        pid_t current = pending[next];
+        if (!visited.insert(current).second) {
+            continue;
+        }
+        jlong process[TREE_RECORD_LEN];
+        for (int i = 0; i < TREE_RECORD_LEN; i++) {
+            process[i] = -1;
+        }
+        process[TREE_RECORD_PID] = current;
+        if (!read_tree_stat(procFd, current, process)) {
+            if (current == pid) {
+                close(procFd);
+                errno = ESRCH;
+                mark_failed_with_errno(env, "could not read process", result);
+                return 0;
+            }
+            // Exited since it was listed
+            continue;
+        }
+        if (current != pid && visited.count((pid_t) process[TREE_RECORD_PARENT_PID]) == 0) {
+            // Exited since it was listed, and the pid has been reused by a process outside of the tree
+            continue;
+        }
+        read_tree_usage(procFd, current, process);
+        values.insert(values.end(), process, process + TREE_RECORD_LEN);
+
+        if (useChildren) {
+            read_children(procFd, current, pending);
+        } else {
+            for (size_t i = 0; i < parents.size(); i++) {
+                if (parents[i].second == current) {
+                    pending.push_back(parents[i].first);
+                }
+            }
+        }
+    }
+    close(procFd);
+
+    jint count = (jint) (values.size() / TREE_RECORD_LEN);
+    jsize capacity = env->GetArrayLength(records) / TREE_RECORD_LEN;
+    if (count <= capacity && count > 0) {
+        env->SetLongArrayRegion(records, 0, count * TREE_RECORD_LEN, &values[0]);
+    }
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_LinuxResourceFunctions_closeSampler(JNIEnv* env, jclass target, jintArray fds) {
+    jint values[SAMPLER_FD_LEN];
+    env->GetIntArrayRegion(fds, 0, SAMPLER_FD_LEN, values);
+    for (int i = 0; i < SAMPLER_FD_LEN; i++) {
+        if (values[i] >= 0) {
+            close(values[i]);
+            values[i] = -1;
+        }
+    }
+    env->SetIntArrayRegion(fds, 0, SAMPLER_FD_LEN, values);
+}
+
+#endif
@@ -20,53 +20,86 @@
 #ifndef _WIN32
 
 #include "generic.h"
+#include "posix_ids.h"
+#include "posix_workers.h"
 #include "net_rubygrapefruit_platform_internal_jni_NativeLibraryFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixFileFunctions.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions.h"
 #include "net_rubygrapefruit_platform_internal_jni_PosixTypeFunctions.h"
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/types.h>
 #include <sys/utsname.h>
+#include <sys/wait.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
+#include <set>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#endif
 
 jmethodID fileStatDetailsMethodId;
+jmethodID dirListAddFilesMethodId;
+jmethodID treeWalkChunkMethodId;
+jmethodID fileSystemListAddMethodId;
+jmethodID fileSystemListAddForUnknownCaseSensitivityMethodId;
+jmethodID fileSystemListAddMountMethodId;
+jfieldID systemInfoOsNameFieldId;
+jfieldID systemInfoOsVersionFieldId;
+jfieldID systemInfoMachineArchitectureFieldId;
+jfieldID systemInfoHostnameFieldId;
+jfieldID typeInfoIntBytesFieldId;
+jfieldID typeInfoULongBytesFieldId;
+jfieldID typeInfoSizeTBytesFieldId;
+jfieldID typeInfoUidTBytesFieldId;
+jfieldID typeInfoGidTBytesFieldId;
+jfieldID typeInfoOffTBytesFieldId;
+jfieldID terminalSizeColsFieldId;
+jfieldID terminalSizeRowsFieldId;
 
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_NativeLibraryFunctions_getSystemInfo(JNIEnv* env, jclass target, jobject info, jobject result) {
-    jclass infoClass = env->GetObjectClass(info);
-
     struct utsname machine_info;
     if (uname(&machine_info) != 0) {
         mark_failed_with_errno(env, "could not query machine details", result);
         return;
     }
 
-    jfieldID osNameField = env->GetFieldID(infoClass, "osName", "Ljava/lang/String;");
-    env->SetObjectField(info, osNameField, char_to_java(env, machine_info.sysname, result));
-    jfieldID osVersionField = env->GetFieldID(infoClass, "osVersion", "Ljava/lang/String;");
-    env->SetObjectField(info, osVersionField, char_to_java(env, machine_info.release, result));
-    jfieldID machineArchitectureField = env->GetFieldID(infoClass, "machineArchitecture", "Ljava/lang/String;");
-    env->SetObjectField(info, machineArchitectureField, char_to_java(env, machine_info.machine, result));
-    jfieldID hostnameField = env->GetFieldID(infoClass, "hostname", "Ljava/lang/String;");
-    env->SetObjectField(info, hostnameField, char_to_java(env, machine_info.nodename, result));
+    env->SetObjectField(info, systemInfoOsNameFieldId, char_to_java(env, machine_info.sysname, result));
+    env->SetObjectField(info, systemInfoOsVersionFieldId, char_to_java(env, machine_info.release, result));
+    env->SetObjectField(info, systemInfoMachineArchitectureFieldId, char_to_java(env, machine_info.machine, result));
+    env->SetObjectField(info, systemInfoHostnameFieldId, char_to_java(env, machine_info.nodename, result));
 }
 
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixTypeFunctions_getNativeTypeInfo(JNIEnv* env, jclass target, jobject info) {
-    jclass infoClass = env->GetObjectClass(info);
-    env->SetIntField(info, env->GetFieldID(infoClass, "int_bytes", "I"), sizeof(int));
-    env->SetIntField(info, env->GetFieldID(infoClass, "u_long_bytes", "I"), sizeof(u_long));
-    env->SetIntField(info, env->GetFieldID(infoClass, "size_t_bytes", "I"), sizeof(size_t));
-    env->SetIntField(info, env->GetFieldID(infoClass, "uid_t_bytes", "I"), sizeof(uid_t));
-    env->SetIntField(info, env->GetFieldID(infoClass, "gid_t_bytes", "I"), sizeof(gid_t));
-    env->SetIntField(info, env->GetFieldID(infoClass, "off_t_bytes", "I"), sizeof(off_t));
+    env->SetIntField(info, typeInfoIntBytesFieldId, sizeof(int));
+    env->SetIntField(info, typeInfoULongBytesFieldId, sizeof(u_long));
+    env->SetIntField(info, typeInfoSizeTBytesFieldId, sizeof(size_t));
+    env->SetIntField(info, typeInfoUidTBytesFieldId, sizeof(uid_t));
+    env->SetIntField(info, typeInfoGidTBytesFieldId, sizeof(gid_t));
+    env->SetIntField(info, typeInfoOffTBytesFieldId, sizeof(off_t));
 }
 
 /*
@@ -75,12 +108,13 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixTypeFunctions_getNativeTypeIn
 
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_chmod(JNIEnv* env, jclass target, jstring path, jint mode, jobject result) {
-    char* pathStr = java_to_char(env, path, result);
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
     if (pathStr == NULL) {
         return;
     }
     int retval = chmod(pathStr, mode);
-    free(pathStr);
+    free_chars(pathStr, pathBuffer);
     if (retval != 0) {
         mark_failed_with_errno(env, "could not chmod file", result);
     }
@@ -118,7 +152,8 @@ void unpackStat(struct stat* source, file_stat_t* result) {
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_stat(JNIEnv* env, jclass target, jstring path, jboolean followLink, jobject dest, jobject result) {
     struct stat fileInfo;
-    char* pathStr = java_to_char(env, path, result);
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
     if (pathStr == NULL) {
         return;
     }
@@ -128,7 +163,7 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_stat(JNIEnv* en
     } else {
         retval = lstat(pathStr, &fileInfo);
     }
-    free(pathStr);
+    free_chars(pathStr, pathBuffer);
     if (retval != 0 && errno != ENOENT && errno != ENOTDIR) {
         mark_failed_with_errno(env, "could not stat file", result);
         return;
@@ -151,59 +186,773 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_stat(JNIEnv* en
     }
 }
 
+// Corresponds to the record layout of FileStatList
+#define STAT_RECORD_TYPE 0
+#define STAT_RECORD_MODE 1
+#define STAT_RECORD_UID 2
+#define STAT_RECORD_GID 3
+#define STAT_RECORD_SIZE 4
+#define STAT_RECORD_LAST_MODIFIED 5
+#define STAT_RECORD_BLOCK_SIZE 6
+#define STAT_RECORD_ERRNO 7
+#define STAT_RECORD_LEN 8
+
+// Number of paths a worker thread claims at a time
+#define STAT_CHUNK_SIZE 256
+
+/*
+ * Stats the given path into a record. Does not call back into Java, so can be called from any thread.
+ */
+void stat_to_record(const char* path, bool followLink, jlong* record) {
+    struct stat fileInfo;
+    int retval = followLink ? stat(path, &fileInfo) : lstat(path, &fileInfo);
+    memset(record, 0, STAT_RECORD_LEN * sizeof(jlong));
+    if (retval != 0) {
+        record[STAT_RECORD_TYPE] = FILE_TYPE_MISSING;
+        if (errno != ENOENT && errno != ENOTDIR) {
+            record[STAT_RECORD_ERRNO] = errno;
+        }
+        return;
+    }
+    file_stat_t fileResult;
+    unpackStat(&fileInfo, &fileResult);
+    record[STAT_RECORD_TYPE] = fileResult.fileType;
+    record[STAT_RECORD_MODE] = 0777 & fileInfo.st_mode;
+    record[STAT_RECORD_UID] = fileInfo.st_uid;
+    record[STAT_RECORD_GID] = fileInfo.st_gid;
+    record[STAT_RECORD_SIZE] = fileResult.size;
+    record[STAT_RECORD_LAST_MODIFIED] = fileResult.lastModified;
+    record[STAT_RECORD_BLOCK_SIZE] = fileInfo.st_blksize;
+}
+
+/*
+ * Replaces the contents of a record with the given failure. The record does not need to be aligned.
+ */
+void failure_to_record(int error, char* record) {
+    jlong values[STAT_RECORD_LEN];
+    memset(values, 0, sizeof(values));
+    values[STAT_RECORD_TYPE] = FILE_TYPE_MISSING;
+    values[STAT_RECORD_ERRNO] = error;
+    memcpy(record, values, sizeof(values));
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_statInto(JNIEnv* env, jclass target, jstring path, jboolean followLink, jobject record) {
+    jlong* recordAddress = (jlong*) env->GetDirectBufferAddress(record);
+    if (recordAddress == NULL || env->GetDirectBufferCapacity(record) < (jlong) (STAT_RECORD_LEN * sizeof(jlong))) {
+        // There is no record to report the failure in
+        return EINVAL;
+    }
+    if (((uintptr_t) recordAddress) % sizeof(jlong) != 0) {
+        failure_to_record(EINVAL, (char*) recordAddress);
+        return EINVAL;
+    }
+    char pathBuffer[STRING_BUFFER_SIZE];
+    // Report a failure to convert the path through the return value and the record, rather than through a FunctionResult
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), NULL);
+    if (pathStr == NULL) {
+        failure_to_record(EILSEQ, (char*) recordAddress);
+        return EILSEQ;
+    }
+    stat_to_record(pathStr, followLink, recordAddress);
+    free_chars(pathStr, pathBuffer);
+    return (jint) recordAddress[STAT_RECORD_ERRNO];
+}
+
+typedef struct bulk_stat {
+    char** paths;
+    bool followLink;
+    jlong* records;
+} bulk_stat_t;
+
+void bulk_stat_task(void* context, size_t index) {
+    bulk_stat_t* bulk = (bulk_stat_t*) context;
+    stat_to_record(bulk->paths[index], bulk->followLink, bulk->records + index * STAT_RECORD_LEN);
+}
+
 JNIEXPORT void JNICALL
-Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_readdir(JNIEnv* env, jclass target, jstring path, jboolean followLink, jobject contents, jobject result) {
-    jclass contentsClass = env->GetObjectClass(contents);
-    jmethodID mid = env->GetMethodID(contentsClass, "addFile", "(Ljava/lang/String;IJJ)V");
-    if (mid == NULL) {
-        mark_failed_with_message(env, "could not find method", result);
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_statAll(JNIEnv* env, jclass target, jobjectArray paths, jboolean followLink, jlongArray records, jobject result) {
+    jsize count = env->GetArrayLength(paths);
+    if (env->GetArrayLength(records) < count * STAT_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    bulk_stat_t bulk;
+    bulk.followLink = followLink;
+    bulk.paths = (char**) calloc(count, sizeof(char*));
+    bulk.records = (jlong*) malloc(count * STAT_RECORD_LEN * sizeof(jlong));
+    if (bulk.paths == NULL || bulk.records == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for stat results", result);
+        free(bulk.paths);
+        free(bulk.records);
+        return;
+    }
+
+    // Convert all paths up front, the worker threads cannot use JNI
+    bool converted = true;
+    for (jsize i = 0; i < count; i++) {
+        jstring path = (jstring) env->GetObjectArrayElement(paths, i);
+        bulk.paths[i] = java_to_char(env, path, result);
+        env->DeleteLocalRef(path);
+        if (bulk.paths[i] == NULL) {
+            converted = false;
+            break;
+        }
+    }
+
+    if (converted) {
+        run_in_parallel(bulk_stat_task, &bulk, count, STAT_CHUNK_SIZE);
+        env->SetLongArrayRegion(records, 0, count * STAT_RECORD_LEN, bulk.records);
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        free(bulk.paths[i]);
+    }
+    free(bulk.paths);
+    free(bulk.records);
+}
+
+// Corresponds to the record layout of ExtendedFileStat
+#define XSTAT_RECORD_TYPE 0
+#define XSTAT_RECORD_MODE 1
+#define XSTAT_RECORD_UID 2
+#define XSTAT_RECORD_GID 3
+#define XSTAT_RECORD_SIZE 4
+#define XSTAT_RECORD_BLOCK_SIZE 5
+#define XSTAT_RECORD_DEVICE 6
+#define XSTAT_RECORD_INODE 7
+#define XSTAT_RECORD_LINK_COUNT 8
+#define XSTAT_RECORD_ACCESS_TIME 9
+#define XSTAT_RECORD_MODIFIED_TIME 10
+#define XSTAT_RECORD_CHANGE_TIME 11
+#define XSTAT_RECORD_CREATION_TIME 12
+#define XSTAT_RECORD_FIELDS 13
+#define XSTAT_RECORD_LEN 14
+
+// Corresponds to the ordinals of StatField
+#define STAT_FIELD_TYPE 0
+#define STAT_FIELD_MODE 1
+#define STAT_FIELD_OWNER 2
+#define STAT_FIELD_SIZE 3
+#define STAT_FIELD_BLOCK_SIZE 4
+#define STAT_FIELD_DEVICE 5
+#define STAT_FIELD_INODE 6
+#define STAT_FIELD_LINK_COUNT 7
+#define STAT_FIELD_ACCESS_TIME 8
+#define STAT_FIELD_MODIFIED_TIME 9
+#define STAT_FIELD_CHANGE_TIME 10
+#define STAT_FIELD_CREATION_TIME 11
+
+#define STAT_FIELD_BIT(field) (1 << (field))
+#define ALL_STAT_FIELDS (STAT_FIELD_BIT(STAT_FIELD_CREATION_TIME + 1) - 1)
+
+jlong toNanos(struct timespec t) {
+    return (jlong)(t.tv_sec) * 1000000000 + (jlong)(t.tv_nsec);
+}
+
+int file_type_of_mode(mode_t mode) {
+    switch (mode & S_IFMT) {
+        case S_IFREG:
+            return FILE_TYPE_FILE;
+        case S_IFDIR:
+            return FILE_TYPE_DIRECTORY;
+        case S_IFLNK:
+            return FILE_TYPE_SYMLINK;
+        default:
+            return FILE_TYPE_OTHER;
+    }
+}
+
+/*
+ * Fills an extended stat record using plain stat(), for platforms or kernels without statx().
+ * All fields except the creation time are available, the creation time is available on macOS only.
+ */
+int fstatat_to_extended_record(const char* path, bool followLink, jlong* record) {
+    struct stat fileInfo;
+    if (fstatat(AT_FDCWD, path, &fileInfo, followLink ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+        return -1;
+    }
+    int fileType = file_type_of_mode(fileInfo.st_mode);
+    record[XSTAT_RECORD_TYPE] = fileType;
+    record[XSTAT_RECORD_MODE] = 0777 & fileInfo.st_mode;
+    record[XSTAT_RECORD_UID] = fileInfo.st_uid;
+    record[XSTAT_RECORD_GID] = fileInfo.st_gid;
+    record[XSTAT_RECORD_SIZE] = fileType == FILE_TYPE_FILE ? fileInfo.st_size : 0;
+    record[XSTAT_RECORD_BLOCK_SIZE] = fileInfo.st_blksize;
+    record[XSTAT_RECORD_DEVICE] = fileInfo.st_dev;
+    record[XSTAT_RECORD_INODE] = fileInfo.st_ino;
+    record[XSTAT_RECORD_LINK_COUNT] = fileInfo.st_nlink;
+    int fields = ALL_STAT_FIELDS & ~STAT_FIELD_BIT(STAT_FIELD_CREATION_TIME);
+#if defined(__linux__)
+    record[XSTAT_RECORD_ACCESS_TIME] = toNanos(fileInfo.st_atim);
+    record[XSTAT_RECORD_MODIFIED_TIME] = toNanos(fileInfo.st_mtim);
+    record[XSTAT_RECORD_CHANGE_TIME] = toNanos(fileInfo.st_ctim);
+#else
+    record[XSTAT_RECORD_ACCESS_TIME] = toNanos(fileInfo.st_atimespec);
+    record[XSTAT_RECORD_MODIFIED_TIME] = toNanos(fileInfo.st_mtimespec);
+    record[XSTAT_RECORD_CHANGE_TIME] = toNanos(fileInfo.st_ctimespec);
+#endif
+#if defined(__APPLE__)
+    record[XSTAT_RECORD_CREATION_TIME] = toNanos(fileInfo.st_birthtimespec);
+    fields |= STAT_FIELD_BIT(STAT_FIELD_CREATION_TIME);
+#endif
+    record[XSTAT_RECORD_FIELDS] = fields;
+    return 0;
+}
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+
+// Set once statx() turns out to be unavailable, for example on kernels older than 4.11 or when blocked by a seccomp filter
+volatile bool statxUnavailable = false;
+
+jlong toNanos(struct statx_timestamp t) {
+    return (jlong)(t.tv_sec) * 1000000000 + (jlong)(t.tv_nsec);
+}
+
+/*
+ * Fills an extended stat record using statx(), asking the file system for the requested fields only.
+ *
+ * Returns -1 and sets errno on failure.
+ */
+int statx_to_extended_record(const char* path, bool followLink, int fields, bool allowStale, jlong* record) {
+    // The type is always needed
+    unsigned int mask = STATX_TYPE;
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_MODE)) {
+        mask |= STATX_MODE;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_OWNER)) {
+        mask |= STATX_UID | STATX_GID;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_SIZE)) {
+        mask |= STATX_SIZE;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_INODE)) {
+        mask |= STATX_INO;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_LINK_COUNT)) {
+        mask |= STATX_NLINK;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_ACCESS_TIME)) {
+        mask |= STATX_ATIME;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_MODIFIED_TIME)) {
+        mask |= STATX_MTIME;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_CHANGE_TIME)) {
+        mask |= STATX_CTIME;
+    }
+    if (fields & STAT_FIELD_BIT(STAT_FIELD_CREATION_TIME)) {
+        mask |= STATX_BTIME;
+    }
+    int flags = (followLink ? 0 : AT_SYMLINK_NOFOLLOW) | (allowStale ? AT_STATX_DONT_SYNC : AT_STATX_SYNC_AS_STAT);
+
+    struct statx fileInfo;
+    if (statx(AT_FDCWD, path, flags, mask, &fileInfo) != 0) {
+        return -1;
+    }
+
+    // The device and block size are always filled in
+    int available = STAT_FIELD_BIT(STAT_FIELD_DEVICE) | STAT_FIELD_BIT(STAT_FIELD_BLOCK_SIZE);
+    int fileType = file_type_of_mode(fileInfo.stx_mode);
+    record[XSTAT_RECORD_TYPE] = fileType;
+    record[XSTAT_RECORD_BLOCK_SIZE] = fileInfo.stx_blksize;
+    record[XSTAT_RECORD_DEVICE] = makedev(fileInfo.stx_dev_major, fileInfo.stx_dev_minor);
+    if (fileInfo.stx_mask & STATX_TYPE) {
+        available |= STAT_FIELD_BIT(STAT_FIELD_TYPE);
+    }
+    if (fileInfo.stx_mask & STATX_MODE) {
+        record[XSTAT_RECORD_MODE] = 0777 & fileInfo.stx_mode;
+        available |= STAT_FIELD_BIT(STAT_FIELD_MODE);
+    }
+    if ((fileInfo.stx_mask & (STATX_UID | STATX_GID)) == (STATX_UID | STATX_GID)) {
+        record[XSTAT_RECORD_UID] = fileInfo.stx_uid;
+        record[XSTAT_RECORD_GID] = fileInfo.stx_gid;
+        available |= STAT_FIELD_BIT(STAT_FIELD_OWNER);
+    }
+    if (fileInfo.stx_mask & STATX_SIZE) {
+        record[XSTAT_RECORD_SIZE] = fileType == FILE_TYPE_FILE ? fileInfo.stx_size : 0;
+        available |= STAT_FIELD_BIT(STAT_FIELD_SIZE);
+    }
+    if (fileInfo.stx_mask & STATX_INO) {
+        record[XSTAT_RECORD_INODE] = fileInfo.stx_ino;
+        available |= STAT_FIELD_BIT(STAT_FIELD_INODE);
+    }
+    if (fileInfo.stx_mask & STATX_NLINK) {
+        record[XSTAT_RECORD_LINK_COUNT] = fileInfo.stx_nlink;
+        available |= STAT_FIELD_BIT(STAT_FIELD_LINK_COUNT);
+    }
+    if (fileInfo.stx_mask & STATX_ATIME) {
+        record[XSTAT_RECORD_ACCESS_TIME] = toNanos(fileInfo.stx_atime);
+        available |= STAT_FIELD_BIT(STAT_FIELD_ACCESS_TIME);
+    }
+    if (fileInfo.stx_mask & STATX_MTIME) {
+        record[XSTAT_RECORD_MODIFIED_TIME] = toNanos(fileInfo.stx_mtime);
+        available |= STAT_FIELD_BIT(STAT_FIELD_MODIFIED_TIME);
+    }
+    if (fileInfo.stx_mask & STATX_CTIME) {
+        record[XSTAT_RECORD_CHANGE_TIME] = toNanos(fileInfo.stx_ctime);
+        available |= STAT_FIELD_BIT(STAT_FIELD_CHANGE_TIME);
+    }
+    if (fileInfo.stx_mask & STATX_BTIME) {
+        record[XSTAT_RECORD_CREATION_TIME] = toNanos(fileInfo.stx_btime);
+        available |= STAT_FIELD_BIT(STAT_FIELD_CREATION_TIME);
+    }
+    record[XSTAT_RECORD_FIELDS] = available;
+    return 0;
+}
+
+#endif
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_statx(JNIEnv* env, jclass target, jstring path, jboolean followLink, jint fields, jboolean allowStale, jlongArray record, jobject result) {
+    if (env->GetArrayLength(record) < XSTAT_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
+    if (pathStr == NULL) {
+        return;
+    }
+
+    jlong values[XSTAT_RECORD_LEN];
+    memset(values, 0, sizeof(values));
+    int retval = -1;
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    if (!statxUnavailable) {
+        retval = statx_to_extended_record(pathStr, followLink, fields, allowStale, values);
+        if (retval != 0 && (errno == ENOSYS || errno == EPERM)) {
+            statxUnavailable = true;
+        }
+    }
+    if (statxUnavailable) {
+        retval = fstatat_to_extended_record(pathStr, followLink, values);
+    }
+#else
+    retval = fstatat_to_extended_record(pathStr, followLink, values);
+#endif
+    free_chars(pathStr, pathBuffer);
+
+    if (retval != 0) {
+        if (errno != ENOENT && errno != ENOTDIR) {
+            mark_failed_with_errno(env, "could not stat file", result);
+            return;
+        }
+        values[XSTAT_RECORD_TYPE] = FILE_TYPE_MISSING;
+        values[XSTAT_RECORD_FIELDS] = ALL_STAT_FIELDS;
+    }
+    env->SetLongArrayRegion(record, 0, XSTAT_RECORD_LEN, values);
+}
+
+/*
+ * Entries of a directory, collected before being handed to Java in one go.
+ * The names are stored back to back in a single buffer.
+ */
+typedef struct dir_entries {
+    jint count;
+    jint capacity;
+    size_t* nameOffsets;
+    jint* types;
+    jlong* sizes;
+    jlong* lastModified;
+    char* names;
+    size_t namesLen;
+    size_t namesCapacity;
+} dir_entries_t;
+
+void free_dir_entries(dir_entries_t* entries) {
+    free(entries->nameOffsets);
+    free(entries->types);
+    free(entries->sizes);
+    free(entries->lastModified);
+    free(entries->names);
+}
+
+bool add_dir_entry(dir_entries_t* entries, const char* name, file_stat_t* fileResult) {
+    if (entries->count == entries->capacity) {
+        jint capacity = entries->capacity == 0 ? 64 : entries->capacity * 2;
+        size_t* nameOffsets = (size_t*) realloc(entries->nameOffsets, capacity * sizeof(size_t));
+        if (nameOffsets == NULL) {
+            return false;
+        }
+        entries->nameOffsets = nameOffsets;
+        jint* types = (jint*) realloc(entries->types, capacity * sizeof(jint));
+        if (types == NULL) {
+            return false;
+        }
+        entries->types = types;
+        jlong* sizes = (jlong*) realloc(entries->sizes, capacity * sizeof(jlong));
+        if (sizes == NULL) {
+            return false;
+        }
+        entries->sizes = sizes;
+        jlong* lastModified = (jlong*) realloc(entries->lastModified, capacity * sizeof(jlong));
+        if (lastModified == NULL) {
+            return false;
+        }
+        entries->lastModified = lastModified;
+        entries->capacity = capacity;
+    }
+    size_t nameLen = strlen(name) + 1;
+    if (entries->namesLen + nameLen > entries->namesCapacity) {
+        size_t namesCapacity = entries->namesCapacity == 0 ? 4096 : entries->namesCapacity * 2;
+        while (entries->namesLen + nameLen > namesCapacity) {
+            namesCapacity *= 2;
+        }
+        char* names = (char*) realloc(entries->names, namesCapacity);
+        if (names == NULL) {
+            return false;
+        }
+        entries->names = names;
+        entries->namesCapacity = namesCapacity;
+    }
+    memcpy(entries->names + entries->namesLen, name, nameLen);
+    entries->nameOffsets[entries->count] = entries->namesLen;
+    entries->namesLen += nameLen;
+    entries->types[entries->count] = fileResult->fileType;
+    entries->sizes[entries->count] = fileResult->size;
+    entries->lastModified[entries->count] = fileResult->lastModified;
+    entries->count++;
+    return true;
+}
+
+/*
+ * Determines the file type from the directory entry, without querying the file.
+ *
+ * Returns -1 when the type is not known.
+ */
+int dirent_file_type(struct dirent* entry) {
+#ifdef DT_UNKNOWN
+    switch (entry->d_type) {
+        case DT_REG:
+            return FILE_TYPE_FILE;
+        case DT_DIR:
+            return FILE_TYPE_DIRECTORY;
+        case DT_LNK:
+            return FILE_TYPE_SYMLINK;
+        case DT_UNKNOWN:
+            return -1;
+        default:
+            return FILE_TYPE_OTHER;
+    }
+#else
+    return -1;
+#endif
+}
+
+void transfer_dir_entries(JNIEnv* env, dir_entries_t* entries, jobject contents, jobject result) {
+    jobjectArray names = env->NewObjectArray(entries->count, stringClass, NULL);
+    if (names == NULL) {
+        mark_failed_with_message(env, "could not create array", result);
         return;
     }
+    for (jint i = 0; i < entries->count; i++) {
+        jstring name = char_to_java(env, entries->names + entries->nameOffsets[i], result);
+        if (name == NULL) {
+            return;
+        }
+        env->SetObjectArrayElement(names, i, name);
+        env->DeleteLocalRef(name);
+    }
+    jintArray types = env->NewIntArray(entries->count);
+    jlongArray sizes = env->NewLongArray(entries->count);
+    jlongArray lastModified = env->NewLongArray(entries->count);
+    if (types == NULL || sizes == NULL || lastModified == NULL) {
+        mark_failed_with_message(env, "could not create array", result);
+        return;
+    }
+    env->SetIntArrayRegion(types, 0, entries->count, entries->types);
+    env->SetLongArrayRegion(sizes, 0, entries->count, entries->sizes);
+    env->SetLongArrayRegion(lastModified, 0, entries->count, entries->lastModified);
+    env->CallVoidMethod(contents, dirListAddFilesMethodId, names, types, sizes, lastModified);
+}
 
-    char* pathStr = java_to_char(env, path, result);
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_readdir(JNIEnv* env, jclass target, jstring path, jboolean followLink, jboolean typeOnly, jobject contents, jobject result) {
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
     if (pathStr == NULL) {
         return;
     }
-    long pathLen = strlen(pathStr);
     DIR* dir = opendir(pathStr);
+    free_chars(pathStr, pathBuffer);
     if (dir == NULL) {
         mark_failed_with_errno(env, "could not open directory", result);
-        free(pathStr);
         return;
     }
-    struct dirent entry;
-    struct dirent* next;
+    int dirFd = dirfd(dir);
+    int statFlags = followLink ? 0 : AT_SYMLINK_NOFOLLOW;
+
+    dir_entries_t entries;
+    memset(&entries, 0, sizeof(entries));
+    bool failed = false;
     while (true) {
-        if (readdir_r(dir, &entry, &next) != 0) {
-            mark_failed_with_errno(env, "could not read directory entry", result);
+        errno = 0;
+        struct dirent* entry = readdir(dir);
+        if (entry == NULL) {
+            if (errno != 0) {
+                mark_failed_with_errno(env, "could not read directory entry", result);
+                failed = true;
+            }
             break;
         }
-        if (next == NULL) {
+        if (strcmp(".", entry->d_name) == 0 || strcmp("..", entry->d_name) == 0) {
+            continue;
+        }
+
+        file_stat_t fileResult;
+        int direntType = typeOnly ? dirent_file_type(entry) : -1;
+        if (direntType != -1 && !(followLink && direntType == FILE_TYPE_SYMLINK)) {
+            fileResult.fileType = direntType;
+            fileResult.size = 0;
+            fileResult.lastModified = 0;
+        } else {
+            struct stat fileInfo;
+            if (fstatat(dirFd, entry->d_name, &fileInfo, statFlags) != 0) {
+                if (!followLink || errno != ENOENT) {
+                    mark_failed_with_errno(env, "could not stat file", result);
+                    failed = true;
+                    break;
+                }
+                fileResult.fileType = FILE_TYPE_MISSING;
+                fileResult.size = 0;
+                fileResult.lastModified = 0;
+            } else {
+                unpackStat(&fileInfo, &fileResult);
+                if (typeOnly) {
+                    fileResult.size = 0;
+                    fileResult.lastModified = 0;
+                }
+            }
+        }
+
+        if (!add_dir_entry(&entries, entry->d_name, &fileResult)) {
+            mark_failed_with_message(env, "could not allocate memory for directory entries", result);
+            failed = true;
             break;
         }
-        if (strcmp(".", entry.d_name) == 0 || strcmp("..", entry.d_name) == 0) {
-            continue;
+    }
+    closedir(dir);
+
+    if (!failed) {
+        transfer_dir_entries(env, &entries, contents, result);
+    }
+    free_dir_entries(&entries);
+}
+
+/*
+ * Tree walking
+ */
+
+// Corresponds to TreeWalk.CHUNK_SIZE
+#define WALK_CHUNK_SIZE (64 * 1024)
+// Record header: type (int32), path length (int32), size (int64), last modified (int64)
+#define WALK_RECORD_HEADER_LEN 24
+// Number of filled chunks that may wait for the Java side before the workers pause
+#define WALK_MAX_QUEUED_CHUNKS 16
+
+typedef struct walk_dir {
+    char* relativePath;
+    // Depth of the directory, the root has depth 0
+    int depth;
+    struct walk_dir* next;
+} walk_dir_t;
+
+typedef struct walk_chunk {
+    size_t len;
+    struct walk_chunk* next;
+    char data[WALK_CHUNK_SIZE];
+} walk_chunk_t;
+
+typedef struct tree_walk {
+    int rootFd;
+    int maxDepth;
+    bool followLinks;
+    char** excludes;
+    jsize excludeCount;
+
+    pthread_mutex_t lock;
+    pthread_cond_t dirsAvailable;
+    pthread_cond_t chunksAvailable;
+    pthread_cond_t chunkSpaceAvailable;
+    // Directories waiting to be listed, used as a stack to keep it short
+    walk_dir_t* dirs;
+    // Directories that are waiting or being listed
+    int activeDirs;
+    walk_chunk_t* chunksHead;
+    walk_chunk_t* chunksTail;
+    int queuedChunks;
+    int runningWorkers;
+    volatile bool cancelled;
+    // The first failure that stopped the walk, or NULL
+    const char* failureMessage;
+    int failureErrno;
+    // Directories seen so far, identified by device and inode. Only used when following links to avoid cycles.
+    std::set<std::pair<dev_t, ino_t> >* visited;
+} tree_walk_t;
+
+walk_dir_t* new_walk_dir(const char* relativePath, int depth) {
+    walk_dir_t* dir = (walk_dir_t*) malloc(sizeof(walk_dir_t));
+    if (dir == NULL) {
+        return NULL;
+    }
+    dir->relativePath = strdup(relativePath);
+    if (dir->relativePath == NULL) {
+        free(dir);
+        return NULL;
+    }
+    dir->depth = depth;
+    dir->next = NULL;
+    return dir;
+}
+
+void free_walk_dir(walk_dir_t* dir) {
+    free(dir->relativePath);
+    free(dir);
+}
+
+/*
+ * Hands a filled chunk over to the Java side. Blocks while too many chunks are waiting.
+ */
+void publish_walk_chunk(tree_walk_t* walk, walk_chunk_t* chunk) {
+    pthread_mutex_lock(&walk->lock);
+    while (walk->queuedChunks >= WALK_MAX_QUEUED_CHUNKS && !walk->cancelled) {
+        pthread_cond_wait(&walk->chunkSpaceAvailable, &walk->lock);
+    }
+    if (walk->cancelled) {
+        pthread_mutex_unlock(&walk->lock);
+        free(chunk);
+        return;
+    }
+    chunk->next = NULL;
+    if (walk->chunksTail == NULL) {
+        walk->chunksHead = chunk;
+    } else {
+        walk->chunksTail->next = chunk;
+    }
+    walk->chunksTail = chunk;
+    walk->queuedChunks++;
+    pthread_cond_signal(&walk->chunksAvailable);
+    pthread_mutex_unlock(&walk->lock);
+}
+
+/*
+ * Appends a record to the worker's current chunk, publishing it and starting a new one when full.
+ *
+ * Returns false when out of memory.
+ */
+bool add_walk_record(tree_walk_t* walk, walk_chunk_t** chunk, const char* path, size_t pathLen, file_stat_t* fileResult) {
+    size_t recordLen = WALK_RECORD_HEADER_LEN + pathLen;
+    if (*chunk != NULL && (*chunk)->len + recordLen > WALK_CHUNK_SIZE) {
+        publish_walk_chunk(walk, *chunk);
+        *chunk = NULL;
+    }
+    if (*chunk == NULL) {
+        *chunk = (walk_chunk_t*) malloc(sizeof(walk_chunk_t));
+        if (*chunk == NULL) {
+            return false;
         }
+        (*chunk)->len = 0;
+    }
+    char* record = (*chunk)->data + (*chunk)->len;
+    jint type = fileResult->fileType;
+    jint len = (jint) pathLen;
+    memcpy(record, &type, sizeof(jint));
+    memcpy(record + 4, &len, sizeof(jint));
+    memcpy(record + 8, &fileResult->size, sizeof(jlong));
+    memcpy(record + 16, &fileResult->lastModified, sizeof(jlong));
+    memcpy(record + WALK_RECORD_HEADER_LEN, path, pathLen);
+    (*chunk)->len += recordLen;
+    return true;
+}
+
+bool is_walk_excluded(tree_walk_t* walk, const char* name) {
+    for (jsize i = 0; i < walk->excludeCount; i++) {
+        if (fnmatch(walk->excludes[i], name, 0) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
 
-        size_t childPathLen = pathLen + strlen(entry.d_name) + 2;
-        char* childPath = (char*) malloc(childPathLen);
-        strncpy(childPath, pathStr, pathLen);
-        childPath[pathLen] = '/';
-        strcpy(childPath + pathLen + 1, entry.d_name);
+void cancel_walk(tree_walk_t* walk) {
+    pthread_mutex_lock(&walk->lock);
+    walk->cancelled = true;
+    pthread_cond_broadcast(&walk->dirsAvailable);
+    pthread_cond_broadcast(&walk->chunkSpaceAvailable);
+    pthread_mutex_unlock(&walk->lock);
+}
 
-        struct stat fileInfo;
-        int retval;
-        if (followLink) {
-            retval = stat(childPath, &fileInfo);
+/*
+ * Stops the walk because of a failure that would otherwise leave entries missing from the tree. Only the first failure is reported.
+ */
+void fail_walk(tree_walk_t* walk, const char* message, int error) {
+    pthread_mutex_lock(&walk->lock);
+    if (walk->failureMessage == NULL) {
+        walk->failureMessage = message;
+        walk->failureErrno = error;
+    }
+    pthread_mutex_unlock(&walk->lock);
+    cancel_walk(walk);
+}
+
+/*
+ * Lists a single directory, reporting its entries and queueing its subdirectories.
+ * Directories that cannot be read, for example because of permissions or because they were removed, are skipped.
+ */
+void walk_directory(tree_walk_t* walk, walk_dir_t* dir, walk_chunk_t** chunk) {
+    int fd;
+    if (dir->depth == 0) {
+        fd = dup(walk->rootFd);
+    } else {
+        fd = openat(walk->rootFd, dir->relativePath, O_RDONLY | O_DIRECTORY | O_CLOEXEC | (walk->followLinks ? 0 : O_NOFOLLOW));
+    }
+    if (fd < 0) {
+        return;
+    }
+    DIR* d = fdopendir(fd);
+    if (d == NULL) {
+        close(fd);
+        return;
+    }
+
+    size_t dirPathLen = strlen(dir->relativePath);
+    char path[PATH_MAX];
+    int statFlags = walk->followLinks ? 0 : AT_SYMLINK_NOFOLLOW;
+    bool descend = walk->maxDepth < 0 || dir->depth + 2 <= walk->maxDepth;
+    while (!walk->cancelled) {
+        struct dirent* entry = readdir(d);
+        if (entry == NULL) {
+            break;
+        }
+        const char* name = entry->d_name;
+        if (strcmp(".", name) == 0 || strcmp("..", name) == 0 || is_walk_excluded(walk, name)) {
+            continue;
+        }
+        size_t nameLen = strlen(name);
+        size_t pathLen = dirPathLen == 0 ? nameLen : dirPathLen + 1 + nameLen;
+        if (pathLen >= sizeof(path)) {
+            fail_walk(walk, "path of file is too long", ENAMETOOLONG);
+            break;
+        }
+        if (dirPathLen == 0) {
+            memcpy(path, name, nameLen + 1);
         } else {
-            retval = lstat(childPath, &fileInfo);
+            memcpy(path, dir->relativePath, dirPathLen);
+            path[dirPathLen] = '/';
+            memcpy(path + dirPathLen + 1, name, nameLen + 1);
         }
-        free(childPath);
-        file_stat fileResult;
-        if (retval != 0) {
-            if (!followLink || errno != ENOENT) {
-                mark_failed_with_errno(env, "could not stat file", result);
-                break;
+
+        struct stat fileInfo;
+        file_stat_t fileResult;
+        if (fstatat(dirfd(d), name, &fileInfo, statFlags) != 0) {
+            if (!walk->followLinks || errno != ENOENT) {
+                // Removed since listed
+                continue;
             }
             fileResult.fileType = FILE_TYPE_MISSING;
             fileResult.size = 0;
@@ -212,28 +961,226 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_readdir(JNIEnv*
             unpackStat(&fileInfo, &fileResult);
         }
 
-        jstring childName = char_to_java(env, entry.d_name, result);
-        env->CallVoidMethod(contents, mid, childName, fileResult.fileType, fileResult.size, fileResult.lastModified);
+        if (!add_walk_record(walk, chunk, path, pathLen, &fileResult)) {
+            fail_walk(walk, "could not allocate memory for walk results", ENOMEM);
+            break;
+        }
+
+        if (descend && fileResult.fileType == FILE_TYPE_DIRECTORY) {
+            walk_dir_t* child = new_walk_dir(path, dir->depth + 1);
+            if (child == NULL) {
+                fail_walk(walk, "could not allocate memory for directory", ENOMEM);
+                break;
+            }
+            pthread_mutex_lock(&walk->lock);
+            if (walk->visited != NULL && !walk->visited->insert(std::make_pair(fileInfo.st_dev, fileInfo.st_ino)).second) {
+                pthread_mutex_unlock(&walk->lock);
+                free_walk_dir(child);
+                continue;
+            }
+            child->next = walk->dirs;
+            walk->dirs = child;
+            walk->activeDirs++;
+            pthread_cond_signal(&walk->dirsAvailable);
+            pthread_mutex_unlock(&walk->lock);
+        }
+    }
+    closedir(d);
+}
+
+void* walk_worker(void* arg) {
+    tree_walk_t* walk = (tree_walk_t*) arg;
+    walk_chunk_t* chunk = NULL;
+    while (true) {
+        pthread_mutex_lock(&walk->lock);
+        while (walk->dirs == NULL && walk->activeDirs > 0 && !walk->cancelled) {
+            pthread_cond_wait(&walk->dirsAvailable, &walk->lock);
+        }
+        if (walk->cancelled || walk->dirs == NULL) {
+            pthread_mutex_unlock(&walk->lock);
+            break;
+        }
+        walk_dir_t* dir = walk->dirs;
+        walk->dirs = dir->next;
+        pthread_mutex_unlock(&walk->lock);
+
+        walk_directory(walk, dir, &chunk);
+        free_walk_dir(dir);
+
+        pthread_mutex_lock(&walk->lock);
+        walk->activeDirs--;
+        if (walk->activeDirs == 0) {
+            pthread_cond_broadcast(&walk->dirsAvailable);
+        }
+        pthread_mutex_unlock(&walk->lock);
+    }
+    if (chunk != NULL) {
+        if (chunk->len > 0) {
+            publish_walk_chunk(walk, chunk);
+        } else {
+            free(chunk);
+        }
+    }
+
+    pthread_mutex_lock(&walk->lock);
+    walk->runningWorkers--;
+    pthread_cond_broadcast(&walk->chunksAvailable);
+    pthread_mutex_unlock(&walk->lock);
+    return NULL;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_walk(JNIEnv* env, jclass target, jstring path, jint maxDepth, jboolean followLinks, jobjectArray excludes, jobject buffer, jobject callback, jobject result) {
+    char* bufferAddress = (char*) env->GetDirectBufferAddress(buffer);
+    if (bufferAddress == NULL || env->GetDirectBufferCapacity(buffer) < WALK_CHUNK_SIZE) {
+        mark_failed_with_message(env, "buffer is not a direct buffer or too small", result);
+        return;
+    }
+
+    tree_walk_t walk;
+    memset(&walk, 0, sizeof(walk));
+    walk.maxDepth = maxDepth;
+    walk.followLinks = followLinks;
+    walk.excludeCount = env->GetArrayLength(excludes);
+    walk.excludes = (char**) calloc(walk.excludeCount + 1, sizeof(char*));
+    if (walk.excludes == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for exclude patterns", result);
+        return;
+    }
+    for (jsize i = 0; i < walk.excludeCount; i++) {
+        jstring exclude = (jstring) env->GetObjectArrayElement(excludes, i);
+        walk.excludes[i] = java_to_char(env, exclude, result);
+        env->DeleteLocalRef(exclude);
+        if (walk.excludes[i] == NULL) {
+            walk.excludeCount = i;
+            goto free_excludes;
+        }
+    }
+
+    {
+        char pathBuffer[STRING_BUFFER_SIZE];
+        char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
+        if (pathStr == NULL) {
+            goto free_excludes;
+        }
+        walk.rootFd = open(pathStr, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        free_chars(pathStr, pathBuffer);
+        if (walk.rootFd < 0) {
+            mark_failed_with_errno(env, "could not open directory", result);
+            goto free_excludes;
+        }
+
+        walk.dirs = new_walk_dir("", 0);
+        if (walk.dirs == NULL) {
+            mark_failed_with_message(env, "could not allocate memory for directory", result);
+            close(walk.rootFd);
+            goto free_excludes;
+        }
+        walk.activeDirs = 1;
+        if (followLinks) {
+            walk.visited = new std::set<std::pair<dev_t, ino_t> >();
+            struct stat rootInfo;
+            if (fstat(walk.rootFd, &rootInfo) == 0) {
+                walk.visited->insert(std::make_pair(rootInfo.st_dev, rootInfo.st_ino));
+            }
+        }
+        pthread_mutex_init(&walk.lock, NULL);
+        pthread_cond_init(&walk.dirsAvailable, NULL);
+        pthread_cond_init(&walk.chunksAvailable, NULL);
+        pthread_cond_init(&walk.chunkSpaceAvailable, NULL);
+
+        int workers = worker_count((size_t) -1, 1);
+        pthread_t threads[MAX_WORKER_THREADS];
+        int started = 0;
+        for (int i = 0; i < workers; i++) {
+            pthread_mutex_lock(&walk.lock);
+            walk.runningWorkers++;
+            pthread_mutex_unlock(&walk.lock);
+            if (pthread_create(&threads[started], NULL, walk_worker, &walk) != 0) {
+                pthread_mutex_lock(&walk.lock);
+                walk.runningWorkers--;
+                pthread_mutex_unlock(&walk.lock);
+                break;
+            }
+            started++;
+        }
+        if (started == 0) {
+            mark_failed_with_message(env, "could not start worker threads", result);
+        }
+
+        // Hand the chunks over to Java as they are filled by the workers
+        while (true) {
+            pthread_mutex_lock(&walk.lock);
+            while (walk.chunksHead == NULL && walk.runningWorkers > 0) {
+                pthread_cond_wait(&walk.chunksAvailable, &walk.lock);
+            }
+            walk_chunk_t* chunk = walk.chunksHead;
+            if (chunk == NULL) {
+                pthread_mutex_unlock(&walk.lock);
+                break;
+            }
+            walk.chunksHead = chunk->next;
+            if (walk.chunksHead == NULL) {
+                walk.chunksTail = NULL;
+            }
+            walk.queuedChunks--;
+            pthread_cond_signal(&walk.chunkSpaceAvailable);
+            pthread_mutex_unlock(&walk.lock);
+
+            if (!walk.cancelled) {
+                memcpy(bufferAddress, chunk->data, chunk->len);
+                env->CallVoidMethod(callback, treeWalkChunkMethodId, (jint) chunk->len);
+                if (env->ExceptionCheck()) {
+                    cancel_walk(&walk);
+                }
+            }
+            free(chunk);
+        }
+
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        // An exception thrown by the visitor takes precedence
+        if (walk.failureMessage != NULL && !env->ExceptionCheck()) {
+            errno = walk.failureErrno;
+            mark_failed_with_errno(env, walk.failureMessage, result);
+        }
+        while (walk.dirs != NULL) {
+            walk_dir_t* dir = walk.dirs;
+            walk.dirs = dir->next;
+            free_walk_dir(dir);
+        }
+        pthread_cond_destroy(&walk.chunkSpaceAvailable);
+        pthread_cond_destroy(&walk.chunksAvailable);
+        pthread_cond_destroy(&walk.dirsAvailable);
+        pthread_mutex_destroy(&walk.lock);
+        delete walk.visited;
+        close(walk.rootFd);
     }
 
-    closedir(dir);
-    free(pathStr);
+free_excludes:
+    for (jsize i = 0; i < walk.excludeCount; i++) {
+        free(walk.excludes[i]);
+    }
+    free(walk.excludes);
 }
 
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_symlink(JNIEnv* env, jclass target, jstring path, jstring contents, jobject result) {
-    char* pathStr = java_to_char(env, path, result);
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
     if (pathStr == NULL) {
         return;
     }
-    char* contentStr = java_to_char(env, contents, result);
+    char contentBuffer[STRING_BUFFER_SIZE];
+    char* contentStr = java_to_char_buffer(env, contents, contentBuffer, sizeof(contentBuffer), result);
     if (contentStr == NULL) {
-        free(pathStr);
+        free_chars(pathStr, pathBuffer);
         return;
     }
     int retval = symlink(contentStr, pathStr);
-    free(contentStr);
-    free(pathStr);
+    free_chars(contentStr, contentBuffer);
+    free_chars(pathStr, pathBuffer);
     if (retval != 0) {
         mark_failed_with_errno(env, "could not symlink", result);
     }
@@ -242,34 +1189,36 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_symlink(JNIEnv*
 JNIEXPORT jstring JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_readlink(JNIEnv* env, jclass target, jstring path, jobject result) {
     struct stat link_info;
-    char* pathStr = java_to_char(env, path, result);
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
     if (pathStr == NULL) {
         return NULL;
     }
     int retval = lstat(pathStr, &link_info);
     if (retval != 0) {
-        free(pathStr);
+        free_chars(pathStr, pathBuffer);
         mark_failed_with_errno(env, "could not lstat file", result);
         return NULL;
     }
 
-    char* contents = (char*) malloc(link_info.st_size + 1);
+    char contentsBuffer[STRING_BUFFER_SIZE];
+    char* contents = link_info.st_size < STRING_BUFFER_SIZE ? contentsBuffer : (char*) malloc(link_info.st_size + 1);
     if (contents == NULL) {
-        free(pathStr);
+        free_chars(pathStr, pathBuffer);
         mark_failed_with_message(env, "could not create array", result);
         return NULL;
     }
 
     retval = readlink(pathStr, contents, link_info.st_size);
-    free(pathStr);
+    free_chars(pathStr, pathBuffer);
     if (retval < 0) {
-        free(contents);
+        free_chars(contents, contentsBuffer);
         mark_failed_with_errno(env, "could not readlink", result);
         return NULL;
     }
     contents[link_info.st_size] = 0;
     jstring contents_str = char_to_java(env, contents, result);
-    free(contents);
+    free_chars(contents, contentsBuffer);
     return contents_str;
 }
 
@@ -306,14 +1255,15 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_getWorkingDi
 
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_setWorkingDirectory(JNIEnv* env, jclass target, jstring dir, jobject result) {
-    char* path = java_to_char(env, dir, result);
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* path = java_to_char_buffer(env, dir, pathBuffer, sizeof(pathBuffer), result);
     if (path == NULL) {
         return;
     }
     if (chdir(path) != 0) {
         mark_failed_with_errno(env, "could not setcwd()", result);
     }
-    free(path);
+    free_chars(path, pathBuffer);
 }
 
 JNIEXPORT jstring JNICALL
@@ -348,6 +1298,630 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_setEnvironme
     free(varStr);
 }
 
+/*
+ * Process launching functions
+ */
+
+// Corresponds to the descriptor layout of SpawnedProcess
+#define SPAWN_RECORD_PID 0
+#define SPAWN_RECORD_PIDFD 1
+#define SPAWN_RECORD_STDIN 2
+#define SPAWN_RECORD_STDOUT 3
+#define SPAWN_RECORD_STDERR 4
+#define SPAWN_RECORD_LEN 5
+
+#define IO_BUFFER_SIZE 8192
+
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 29)
+#define HAVE_SPAWN_ADDCHDIR
+#endif
+#if __GLIBC_PREREQ(2, 34)
+#define HAVE_SPAWN_ADDCLOSEFROM
+#endif
+#endif
+
+/*
+ * Creates a pipe whose ends are not inherited by child processes, so that a child started concurrently by another thread does not hold
+ * this child's streams open.
+ */
+bool create_pipe(int fds[2]) {
+#ifdef __linux__
+    return pipe2(fds, O_CLOEXEC) == 0;
+#else
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+void close_pipe(int fds[2]) {
+    if (fds[0] >= 0) {
+        close(fds[0]);
+    }
+    if (fds[1] >= 0) {
+        close(fds[1]);
+    }
+}
+
+void free_string_array(char** chars) {
+    if (chars == NULL) {
+        return;
+    }
+    for (char** pos = chars; *pos != NULL; pos++) {
+        free(*pos);
+    }
+    free(chars);
+}
+
+/*
+ * Converts an array of Java strings to a NULL terminated array of C strings. Should call free_string_array() when finished.
+ *
+ * Returns NULL on failure, in which case the result has been marked.
+ */
+char** java_to_string_array(JNIEnv* env, jobjectArray strings, jobject result) {
+    jsize count = env->GetArrayLength(strings);
+    char** chars = (char**) calloc(count + 1, sizeof(char*));
+    if (chars == NULL) {
+        mark_failed_with_message(env, "could not allocate string array", result);
+        return NULL;
+    }
+    for (jsize i = 0; i < count; i++) {
+        jstring string = (jstring) env->GetObjectArrayElement(strings, i);
+        chars[i] = java_to_char(env, string, result);
+        env->DeleteLocalRef(string);
+        if (chars[i] == NULL) {
+            free_string_array(chars);
+            return NULL;
+        }
+    }
+    return chars;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_canSpawnInDirectory(JNIEnv* env, jclass target) {
+#ifdef HAVE_SPAWN_ADDCHDIR
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_spawn(JNIEnv* env, jclass target, jobjectArray command, jobjectArray environment, jstring directory, jboolean redirectErrorStream, jintArray record, jobject result) {
+    if (env->GetArrayLength(record) < SPAWN_RECORD_LEN) {
+        mark_failed_with_message(env, "record array too small", result);
+        return;
+    }
+#ifndef HAVE_SPAWN_ADDCHDIR
+    if (directory != NULL) {
+        mark_failed_with_message(env, "spawning a process in a working directory is not supported", result);
+        return;
+    }
+#endif
+
+    char** argv = java_to_string_array(env, command, result);
+    char** envp = argv == NULL ? NULL : java_to_string_array(env, environment, result);
+    char dirBuffer[STRING_BUFFER_SIZE];
+    char* dir = directory == NULL || envp == NULL ? NULL : java_to_char_buffer(env, directory, dirBuffer, sizeof(dirBuffer), result);
+    int stdinPipe[2] = { -1, -1 };
+    int stdoutPipe[2] = { -1, -1 };
+    int stderrPipe[2] = { -1, -1 };
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attributes;
+    bool actionsInitialized = false;
+    bool attributesInitialized = false;
+    pid_t pid = -1;
+    int error;
+
+    if (argv == NULL || envp == NULL || (directory != NULL && dir == NULL)) {
+        // Conversion failed, and the result has been marked
+        goto cleanup;
+    }
+    if (!create_pipe(stdinPipe) || !create_pipe(stdoutPipe) || (!redirectErrorStream && !create_pipe(stderrPipe))) {
+        mark_failed_with_errno(env, "could not create pipe", result);
+        goto cleanup;
+    }
+
+    error = posix_spawn_file_actions_init(&actions);
+    actionsInitialized = error == 0;
+    if (error == 0) {
+        // dup2() clears the close-on-exec flag of the target descriptor
+        error = posix_spawn_file_actions_adddup2(&actions, stdinPipe[0], STDIN_FILENO);
+    }
+    if (error == 0) {
+        error = posix_spawn_file_actions_adddup2(&actions, stdoutPipe[1], STDOUT_FILENO);
+    }
+    if (error == 0) {
+        error = posix_spawn_file_actions_adddup2(&actions, redirectErrorStream ? stdoutPipe[1] : stderrPipe[1], STDERR_FILENO);
+    }
+#ifdef HAVE_SPAWN_ADDCLOSEFROM
+    if (error == 0) {
+        // Also closes descriptors that were opened without close-on-exec, for example by the JDK's own launcher
+        error = posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+    }
+#endif
+#ifdef HAVE_SPAWN_ADDCHDIR
+    if (error == 0 && dir != NULL) {
+        error = posix_spawn_file_actions_addchdir_np(&actions, dir);
+    }
+#endif
+    if (error == 0) {
+        error = posix_spawnattr_init(&attributes);
+        attributesInitialized = error == 0;
+    }
+    if (error == 0) {
+        // Do not pass on the signal mask and dispositions of the JVM
+        sigset_t signals;
+        sigemptyset(&signals);
+        posix_spawnattr_setsigmask(&attributes, &signals);
+        sigfillset(&signals);
+        posix_spawnattr_setsigdefault(&attributes, &signals);
+        error = posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    }
+    if (error == 0) {
+        error = posix_spawnp(&pid, argv[0], &actions, &attributes, argv, envp);
+    }
+    if (error != 0) {
+        errno = error;
+        mark_failed_with_errno(env, "could not spawn process", result);
+        goto cleanup;
+    }
+
+    jint values[SPAWN_RECORD_LEN];
+    values[SPAWN_RECORD_PID] = pid;
+    values[SPAWN_RECORD_PIDFD] = -1;
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    // Only this process reaps the child, so the pid cannot have been reused yet. Older kernels do not support pidfds
+    values[SPAWN_RECORD_PIDFD] = syscall(SYS_pidfd_open, pid, 0);
+#endif
+    values[SPAWN_RECORD_STDIN] = stdinPipe[1];
+    values[SPAWN_RECORD_STDOUT] = stdoutPipe[0];
+    values[SPAWN_RECORD_STDERR] = stderrPipe[0];
+    env->SetIntArrayRegion(record, 0, SPAWN_RECORD_LEN, values);
+    // The parent keeps its ends of the pipes, and closes the child's ends
+    stdinPipe[1] = -1;
+    stdoutPipe[0] = -1;
+    stderrPipe[0] = -1;
+
+cleanup:
+    if (attributesInitialized) {
+        posix_spawnattr_destroy(&attributes);
+    }
+    if (actionsInitialized) {
+        posix_spawn_file_actions_destroy(&actions);
+    }
+    close_pipe(stdinPipe);
+    close_pipe(stdoutPipe);
+    close_pipe(stderrPipe);
+    if (dir != NULL) {
+        free_chars(dir, dirBuffer);
+    }
+    free_string_array(envp);
+    free_string_array(argv);
+}
+
+// Corresponds to the record layout of ChildProcessMonitor
+#define EXIT_RECORD_PID 0
+#define EXIT_RECORD_EXIT_VALUE 1
+#define EXIT_RECORD_USER_TIME 2
+#define EXIT_RECORD_SYSTEM_TIME 3
+#define EXIT_RECORD_MAX_RESIDENT 4
+#define EXIT_RECORD_LEN 5
+
+#define MAX_EXIT_BATCH 64
+
+int exit_value(int status) {
+    if (WIFSIGNALED(status)) {
+        // Same convention as the shell and the JDK
+        return 0x80 + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_waitForExit(JNIEnv* env, jclass target, jint pid, jobject result) {
+    // Wait without reaping the child, so that several threads can wait and the exit status is collected once by reap()
+    siginfo_t info;
+    while (waitid(P_PID, pid, &info, WEXITED | WNOWAIT) != 0) {
+        if (errno != EINTR) {
+            mark_failed_with_errno(env, "could not wait for process", result);
+            return;
+        }
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_reap(JNIEnv* env, jclass target, jint pid, jobject result) {
+    int status;
+    pid_t reaped;
+    do {
+        reaped = waitpid(pid, &status, WNOHANG);
+    } while (reaped == -1 && errno == EINTR);
+    if (reaped == -1) {
+        mark_failed_with_errno(env, "could not wait for process", result);
+        return -1;
+    }
+    if (reaped == 0) {
+        // Still running
+        return -1;
+    }
+    return exit_value(status);
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_kill(JNIEnv* env, jclass target, jint pid, jint pidfd, jint signal, jobject result) {
+    int retval;
+#if defined(__linux__) && defined(SYS_pidfd_send_signal)
+    if (pidfd >= 0) {
+        retval = syscall(SYS_pidfd_send_signal, pidfd, signal, NULL, 0);
+    } else {
+        retval = kill(pid, signal);
+    }
+#else
+    retval = kill(pid, signal);
+#endif
+    // The process may have exited already
+    if (retval != 0 && errno != ESRCH) {
+        mark_failed_with_errno(env, "could not signal process", result);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_openChildMonitor(JNIEnv* env, jclass target, jobject result) {
+#ifdef __linux__
+    int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd < 0) {
+        mark_failed_with_errno(env, "could not create epoll instance", result);
+    }
+    return fd;
+#else
+    mark_failed_with_message(env, "child monitor is not supported on this operating system", result);
+    return -1;
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_watchChild(JNIEnv* env, jclass target, jint monitorFd, jint pid, jint pidfd, jobject result) {
+#ifdef __linux__
+    // A pidfd becomes readable when the process exits, including when it has exited before it is added
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = ((uint64_t) (uint32_t) pidfd << 32) | (uint32_t) pid;
+    if (epoll_ctl(monitorFd, EPOLL_CTL_ADD, pidfd, &event) != 0) {
+        mark_failed_with_errno(env, "could not watch child process", result);
+    }
+#else
+    mark_failed_with_message(env, "child monitor is not supported on this operating system", result);
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_waitForChildren(JNIEnv* env, jclass target, jint monitorFd, jlongArray records, jobject result) {
+#ifdef __linux__
+    jsize maxEvents = env->GetArrayLength(records) / EXIT_RECORD_LEN;
+    if (maxEvents > MAX_EXIT_BATCH) {
+        maxEvents = MAX_EXIT_BATCH;
+    }
+    if (maxEvents == 0) {
+        mark_failed_with_message(env, "record array too small", result);
+        return -1;
+    }
+    struct epoll_event events[MAX_EXIT_BATCH];
+    int count;
+    do {
+        count = epoll_wait(monitorFd, events, maxEvents, -1);
+    } while (count == -1 && errno == EINTR);
+    if (count < 0) {
+        mark_failed_with_errno(env, "could not wait for child processes", result);
+        return -1;
+    }
+
+    jlong values[MAX_EXIT_BATCH * EXIT_RECORD_LEN];
+    jint exited = 0;
+    for (int i = 0; i < count; i++) {
+        pid_t pid = (pid_t) (events[i].data.u64 & 0xFFFFFFFF);
+        int pidfd = (int) (events[i].data.u64 >> 32);
+        int status;
+        struct rusage usage;
+        pid_t reaped;
+        do {
+            reaped = wait4(pid, &status, WNOHANG, &usage);
+        } while (reaped == -1 && errno == EINTR);
+        if (reaped == 0) {
+            // Not a zombie yet, the pidfd will be reported again
+            continue;
+        }
+        // The pidfd is closed by the owning process object
+        epoll_ctl(monitorFd, EPOLL_CTL_DEL, pidfd, NULL);
+        jlong* record = values + exited * EXIT_RECORD_LEN;
+        record[EXIT_RECORD_PID] = pid;
+        if (reaped < 0) {
+            // Reaped elsewhere, so the exit status and usage are lost
+            record[EXIT_RECORD_EXIT_VALUE] = -1;
+            record[EXIT_RECORD_USER_TIME] = -1;
+            record[EXIT_RECORD_SYSTEM_TIME] = -1;
+            record[EXIT_RECORD_MAX_RESIDENT] = -1;
+        } else {
+            record[EXIT_RECORD_EXIT_VALUE] = exit_value(status);
+            record[EXIT_RECORD_USER_TIME] = (jlong) usage.ru_utime.tv_sec * 1000000000LL + usage.ru_utime.tv_usec * 1000LL;
+            record[EXIT_RECORD_SYSTEM_TIME] = (jlong) usage.ru_stime.tv_sec * 1000000000LL + usage.ru_stime.tv_usec * 1000LL;
+            // ru_maxrss is reported in kB on Linux
+            record[EXIT_RECORD_MAX_RESIDENT] = (jlong) usage.ru_maxrss * 1024;
+        }
+        exited++;
+    }
+    env->SetLongArrayRegion(records, 0, exited * EXIT_RECORD_LEN, values);
+    return exited;
+#else
+    mark_failed_with_message(env, "child monitor is not supported on this operating system", result);
+    return -1;
+#endif
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_read(JNIEnv* env, jclass target, jint fd, jbyteArray buffer, jint offset, jint length, jobject result) {
+    jbyte chunk[IO_BUFFER_SIZE];
+    ssize_t count;
+    do {
+        count = read(fd, chunk, length < IO_BUFFER_SIZE ? length : IO_BUFFER_SIZE);
+    } while (count == -1 && errno == EINTR);
+    if (count < 0) {
+        mark_failed_with_errno(env, "could not read from process", result);
+        return -1;
+    }
+    if (count == 0) {
+        return -1;
+    }
+    env->SetByteArrayRegion(buffer, offset, count, chunk);
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_write(JNIEnv* env, jclass target, jint fd, jbyteArray buffer, jint offset, jint length, jobject result) {
+    jbyte chunk[IO_BUFFER_SIZE];
+    while (length > 0) {
+        jint chunkLength = length < IO_BUFFER_SIZE ? length : IO_BUFFER_SIZE;
+        env->GetByteArrayRegion(buffer, offset, chunkLength, chunk);
+        for (jint written = 0; written < chunkLength;) {
+            ssize_t count = write(fd, chunk + written, chunkLength - written);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                mark_failed_with_errno(env, "could not write to process", result);
+                return;
+            }
+            written += count;
+        }
+        offset += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixProcessFunctions_closeDescriptor(JNIEnv* env, jclass target, jint fd) {
+    close(fd);
+}
+
+/*
+ * File system functions
+ */
+
+// Corresponds to the record layout of DefaultFileSystemCapacity
+#define CAPACITY_RECORD_TOTAL 0
+#define CAPACITY_RECORD_FREE 1
+#define CAPACITY_RECORD_AVAILABLE 2
+#define CAPACITY_RECORD_TOTAL_INODES 3
+#define CAPACITY_RECORD_FREE_INODES 4
+#define CAPACITY_RECORD_AVAILABLE_INODES 5
+#define CAPACITY_RECORD_LEN 6
+
+// Corresponds to the layout of the buffer read by DefaultFileSystemCapacityMonitor. Each path has a slot holding a sequence number, which
+// is odd while the refresher updates the slot, followed by a capacity record
+#define CAPACITY_SLOT_SEQUENCE 0
+#define CAPACITY_SLOT_RECORD 1
+#define CAPACITY_SLOT_LEN (1 + CAPACITY_RECORD_LEN)
+
+/*
+ * Reads the capacity of the file system containing the given path into the given record. Returns false on failure, with errno set.
+ */
+bool read_capacity(const char* path, jlong* record) {
+    struct statvfs fileSystem;
+    int retval;
+    do {
+        retval = statvfs(path, &fileSystem);
+    } while (retval != 0 && errno == EINTR);
+    if (retval != 0) {
+        return false;
+    }
+    // The block counts are in units of the fragment size
+    jlong blockSize = fileSystem.f_frsize != 0 ? fileSystem.f_frsize : fileSystem.f_bsize;
+    record[CAPACITY_RECORD_TOTAL] = (jlong) fileSystem.f_blocks * blockSize;
+    record[CAPACITY_RECORD_FREE] = (jlong) fileSystem.f_bfree * blockSize;
+    record[CAPACITY_RECORD_AVAILABLE] = (jlong) fileSystem.f_bavail * blockSize;
+    record[CAPACITY_RECORD_TOTAL_INODES] = (jlong) fileSystem.f_files;
+    record[CAPACITY_RECORD_FREE_INODES] = (jlong) fileSystem.f_ffree;
+    record[CAPACITY_RECORD_AVAILABLE_INODES] = (jlong) fileSystem.f_favail;
+    return true;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_getCapacity(JNIEnv* env, jclass target, jstring path, jlongArray record, jobject result) {
+    char pathBuffer[STRING_BUFFER_SIZE];
+    char* pathStr = java_to_char_buffer(env, path, pathBuffer, sizeof(pathBuffer), result);
+    if (pathStr == NULL) {
+        return;
+    }
+    jlong values[CAPACITY_RECORD_LEN];
+    bool success = read_capacity(pathStr, values);
+    free_chars(pathStr, pathBuffer);
+    if (!success) {
+        mark_failed_with_errno(env, "could not query file system capacity", result);
+        return;
+    }
+    env->SetLongArrayRegion(record, 0, CAPACITY_RECORD_LEN, values);
+}
+
+#ifdef __APPLE__
+// macOS has no pthread_condattr_setclock(), so the refresher can only wait for a deadline on the realtime clock
+#define CAPACITY_REFRESHER_CLOCK CLOCK_REALTIME
+#else
+// Not affected by changes to the system time
+#define CAPACITY_REFRESHER_CLOCK CLOCK_MONOTONIC
+#endif
+
+/*
+ * Samples the capacity of a set of paths at a fixed rate into slots that are read without a lock.
+ */
+struct capacity_refresher {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    bool stopped;
+    jlong intervalMillis;
+    char** paths;
+    int pathCount;
+    // Followed by the remaining slots
+    jlong slots[CAPACITY_SLOT_LEN];
+};
+
+void refresh_capacity_slots(capacity_refresher* refresher) {
+    for (int i = 0; i < refresher->pathCount; i++) {
+        jlong* slot = refresher->slots + i * CAPACITY_SLOT_LEN;
+        jlong values[CAPACITY_RECORD_LEN];
+        if (!read_capacity(refresher->paths[i], values)) {
+            for (int j = 0; j < CAPACITY_RECORD_LEN; j++) {
+                values[j] = -1;
+            }
+        }
+        // There is a single writer, so a plain increment of the sequence number is enough
+        jlong sequence = __atomic_load_n(&slot[CAPACITY_SLOT_SEQUENCE], __ATOMIC_RELAXED);
+        __atomic_store_n(&slot[CAPACITY_SLOT_SEQUENCE], sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (int j = 0; j < CAPACITY_RECORD_LEN; j++) {
+            __atomic_store_n(&slot[CAPACITY_SLOT_RECORD + j], values[j], __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&slot[CAPACITY_SLOT_SEQUENCE], sequence + 2, __ATOMIC_RELEASE);
+    }
+}
+
+void* capacity_refresher_main(void* arg) {
+    capacity_refresher* refresher = (capacity_refresher*) arg;
+    pthread_mutex_lock(&refresher->lock);
+    while (!refresher->stopped) {
+        struct timespec now;
+        clock_gettime(CAPACITY_REFRESHER_CLOCK, &now);
+        jlong deadlineNanos = (jlong) now.tv_nsec + refresher->intervalMillis * 1000000LL;
+        struct timespec deadline;
+        deadline.tv_sec = now.tv_sec + deadlineNanos / 1000000000LL;
+        deadline.tv_nsec = deadlineNanos % 1000000000LL;
+        int retval = 0;
+        while (!refresher->stopped && retval != ETIMEDOUT) {
+            retval = pthread_cond_timedwait(&refresher->condition, &refresher->lock, &deadline);
+        }
+        if (refresher->stopped) {
+            break;
+        }
+        pthread_mutex_unlock(&refresher->lock);
+        refresh_capacity_slots(refresher);
+        pthread_mutex_lock(&refresher->lock);
+    }
+    pthread_mutex_unlock(&refresher->lock);
+    return NULL;
+}
+
+JNIEXPORT jobject JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_startCapacityRefresher(JNIEnv* env, jclass target, jobjectArray paths, jlong intervalMillis, jobject result) {
+    char** pathStrs = java_to_string_array(env, paths, result);
+    if (pathStrs == NULL) {
+        return NULL;
+    }
+    int pathCount = env->GetArrayLength(paths);
+    size_t slotsLen = (pathCount > 0 ? pathCount : 1) * CAPACITY_SLOT_LEN * sizeof(jlong);
+    capacity_refresher* refresher = (capacity_refresher*) calloc(1, offsetof(capacity_refresher, slots) + slotsLen);
+    if (refresher == NULL) {
+        mark_failed_with_message(env, "could not allocate capacity refresher", result);
+        free_string_array(pathStrs);
+        return NULL;
+    }
+    refresher->intervalMillis = intervalMillis;
+    refresher->paths = pathStrs;
+    refresher->pathCount = pathCount;
+    pthread_mutex_init(&refresher->lock, NULL);
+    pthread_condattr_t conditionAttributes;
+    pthread_condattr_init(&conditionAttributes);
+#ifndef __APPLE__
+    pthread_condattr_setclock(&conditionAttributes, CAPACITY_REFRESHER_CLOCK);
+#endif
+    pthread_cond_init(&refresher->condition, &conditionAttributes);
+    pthread_condattr_destroy(&conditionAttributes);
+    // Take the first sample before returning, so that the slots are valid as soon as Java can read them
+    refresh_capacity_slots(refresher);
+
+    // Block all signals in the refresher thread, so that they are handled by the threads of the JVM
+    sigset_t allSignals;
+    sigset_t previousMask;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousMask);
+    int error = pthread_create(&refresher->thread, NULL, capacity_refresher_main, refresher);
+    pthread_sigmask(SIG_SETMASK, &previousMask, NULL);
+    if (error != 0) {
+        errno = error;
+        mark_failed_with_errno(env, "could not start capacity refresher thread", result);
+        pthread_cond_destroy(&refresher->condition);
+        pthread_mutex_destroy(&refresher->lock);
+        free_string_array(pathStrs);
+        free(refresher);
+        return NULL;
+    }
+    return env->NewDirectByteBuffer(refresher->slots, pathCount * CAPACITY_SLOT_LEN * sizeof(jlong));
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_readCapacitySlot(JNIEnv* env, jclass target, jobject slots, jint index, jlongArray record) {
+    jlong* slot = (jlong*) env->GetDirectBufferAddress(slots) + index * CAPACITY_SLOT_LEN;
+    jlong values[CAPACITY_RECORD_LEN];
+    // Retry when the refresher updated the slot while it was read
+    while (true) {
+        jlong sequence = __atomic_load_n(&slot[CAPACITY_SLOT_SEQUENCE], __ATOMIC_ACQUIRE);
+        if ((sequence & 1) != 0) {
+            sched_yield();
+            continue;
+        }
+        for (int i = 0; i < CAPACITY_RECORD_LEN; i++) {
+            values[i] = __atomic_load_n(&slot[CAPACITY_SLOT_RECORD + i], __ATOMIC_RELAXED);
+        }
+        // Orders the reads of the record before the second read of the sequence number
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot[CAPACITY_SLOT_SEQUENCE], __ATOMIC_RELAXED) == sequence) {
+            break;
+        }
+    }
+    env->SetLongArrayRegion(record, 0, CAPACITY_RECORD_LEN, values);
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_stopCapacityRefresher(JNIEnv* env, jclass target, jobject slots) {
+    char* slotsAddress = (char*) env->GetDirectBufferAddress(slots);
+    if (slotsAddress == NULL) {
+        return;
+    }
+    capacity_refresher* refresher = (capacity_refresher*) (slotsAddress - offsetof(capacity_refresher, slots));
+    pthread_mutex_lock(&refresher->lock);
+    refresher->stopped = true;
+    pthread_cond_signal(&refresher->condition);
+    pthread_mutex_unlock(&refresher->lock);
+    pthread_join(refresher->thread, NULL);
+    pthread_cond_destroy(&refresher->condition);
+    pthread_mutex_destroy(&refresher->lock);
+    free_string_array(refresher->paths);
+    free(refresher);
+}
+
 /*
  * Terminal functions
  */
@@ -376,16 +1950,145 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_getTerminal
         mark_failed_with_errno(env, "could not fetch terminal size", result);
         return;
     }
-    jclass dimensionClass = env->GetObjectClass(dimension);
-    jfieldID widthField = env->GetFieldID(dimensionClass, "cols", "I");
-    env->SetIntField(dimension, widthField, screen_size.ws_col);
-    jfieldID heightField = env->GetFieldID(dimensionClass, "rows", "I");
-    env->SetIntField(dimension, heightField, screen_size.ws_row);
+    env->SetIntField(dimension, terminalSizeColsFieldId, screen_size.ws_col);
+    env->SetIntField(dimension, terminalSizeRowsFieldId, screen_size.ws_row);
+}
+
+// Corresponds to the layout of TerminalSizeWatcher's buffer
+#define TERMINAL_SIZE_GENERATION 0
+#define TERMINAL_SIZE_STDOUT 1
+#define TERMINAL_SIZE_STDERR 2
+#define TERMINAL_SIZE_LEN 3
+
+// Each size packs the rows into the high and the columns into the low 32 bits, so that Java can read it with a single load.
+// -1 when the size is not tracked, so that Java queries the terminal instead.
+static int64_t terminalSizes[TERMINAL_SIZE_LEN];
+static pthread_mutex_t terminalSizeLock = PTHREAD_MUTEX_INITIALIZER;
+static int terminalSizePipe[2] = { -1, -1 };
+static struct sigaction previousWinchAction;
+static struct sigaction previousContAction;
+
+int64_t query_terminal_size(int fd) {
+    // SIGWINCH is only sent to the foreground process group of the controlling terminal, so the size is not tracked while this process
+    // is in the background or the output is not its controlling terminal. Moving between foreground and background sends SIGCONT.
+    pid_t group = tcgetpgrp(fd);
+    if (group < 0 || group != getpgrp()) {
+        return -1;
+    }
+    struct winsize screen_size;
+    if (ioctl(fd, TIOCGWINSZ, &screen_size) != 0) {
+        return -1;
+    }
+    return ((int64_t) screen_size.ws_row << 32) | screen_size.ws_col;
+}
+
+// Must hold terminalSizeLock
+void update_terminal_sizes() {
+    __atomic_store_n(&terminalSizes[TERMINAL_SIZE_STDOUT], query_terminal_size(STDOUT_FILENO), __ATOMIC_RELAXED);
+    __atomic_store_n(&terminalSizes[TERMINAL_SIZE_STDERR], query_terminal_size(STDERR_FILENO), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&terminalSizes[TERMINAL_SIZE_GENERATION], 1, __ATOMIC_RELEASE);
+}
+
+// Only does async-signal-safe work: wakes the watcher thread, which queries the new sizes, then chains to any previous handler
+void terminal_size_changed(int signal, siginfo_t* info, void* context) {
+    int savedErrno = errno;
+    char wakeup = 0;
+    // The pipe is non-blocking, when it is full there is already a wakeup pending
+    ssize_t count = write(terminalSizePipe[1], &wakeup, 1);
+    (void) count;
+    errno = savedErrno;
+    struct sigaction* previous = signal == SIGCONT ? &previousContAction : &previousWinchAction;
+    if ((previous->sa_flags & SA_SIGINFO) != 0) {
+        if (previous->sa_sigaction != NULL) {
+            previous->sa_sigaction(signal, info, context);
+        }
+    } else if (previous->sa_handler != SIG_DFL && previous->sa_handler != SIG_IGN) {
+        previous->sa_handler(signal);
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_watchTerminalSize(JNIEnv* env, jclass target, jobject result) {
+    pthread_mutex_lock(&terminalSizeLock);
+    if (terminalSizePipe[0] < 0) {
+        int fds[2];
+        if (!create_pipe(fds)) {
+            mark_failed_with_errno(env, "could not create pipe", result);
+            pthread_mutex_unlock(&terminalSizeLock);
+            return NULL;
+        }
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        terminalSizePipe[0] = fds[0];
+        terminalSizePipe[1] = fds[1];
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = terminal_size_changed;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGWINCH, &action, &previousWinchAction) != 0) {
+            mark_failed_with_errno(env, "could not install SIGWINCH handler", result);
+            close(fds[0]);
+            close(fds[1]);
+            terminalSizePipe[0] = -1;
+            terminalSizePipe[1] = -1;
+            pthread_mutex_unlock(&terminalSizeLock);
+            return NULL;
+        }
+        if (sigaction(SIGCONT, &action, &previousContAction) != 0) {
+            mark_failed_with_errno(env, "could not install SIGCONT handler", result);
+            sigaction(SIGWINCH, &previousWinchAction, NULL);
+            close(fds[0]);
+            close(fds[1]);
+            terminalSizePipe[0] = -1;
+            terminalSizePipe[1] = -1;
+            pthread_mutex_unlock(&terminalSizeLock);
+            return NULL;
+        }
+        update_terminal_sizes();
+    }
+    pthread_mutex_unlock(&terminalSizeLock);
+    return env->NewDirectByteBuffer(terminalSizes, sizeof(terminalSizes));
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_waitForTerminalSizeChange(JNIEnv* env, jclass target, jobject result) {
+    // Drain all pending wakeups, so that a burst of signals results in a single update
+    char buffer[64];
+    ssize_t count;
+    do {
+        count = read(terminalSizePipe[0], buffer, sizeof(buffer));
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0) {
+        if (count == 0) {
+            errno = EPIPE;
+        }
+        mark_failed_with_errno(env, "could not wait for terminal size change", result);
+        return;
+    }
+    pthread_mutex_lock(&terminalSizeLock);
+    update_terminal_sizes();
+    pthread_mutex_unlock(&terminalSizeLock);
 }
 
 int input_init = 0;
 struct termios original_input_mode;
 
+void write_sequence(int fd, const char* sequence) {
+    size_t length = strlen(sequence);
+    while (length > 0) {
+        ssize_t count = write(fd, sequence, length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        sequence += count;
+        length -= count;
+    }
+}
+
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_rawInputMode(JNIEnv* env, jclass target, jobject result) {
     if (input_init == 0) {
@@ -395,7 +2098,14 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_rawInputMod
     struct termios new_mode;
     new_mode = original_input_mode;
     new_mode.c_lflag &= ~(ICANON | ECHO);
+    // Return from read() as soon as any input is available, timeouts are implemented using poll()
+    new_mode.c_cc[VMIN] = 1;
+    new_mode.c_cc[VTIME] = 0;
     tcsetattr(STDIN_FILENO, TCSANOW, &new_mode);
+    if (isatty(STDOUT_FILENO)) {
+        // Ask the terminal to mark pasted text, so that it is not interpreted as typed keys
+        write_sequence(STDOUT_FILENO, "\033[?2004h");
+    }
 }
 
 JNIEXPORT void JNICALL
@@ -404,6 +2114,49 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_resetInputM
         return;
     }
     tcsetattr(STDIN_FILENO, TCSANOW, &original_input_mode);
+    if (isatty(STDOUT_FILENO)) {
+        write_sequence(STDOUT_FILENO, "\033[?2004l");
+    }
+}
+
+/*
+ * Resolves the ids declared in posix_ids.h. Holds a global reference to each class, so that the ids remain valid.
+ *
+ * Returns false when an id cannot be resolved, with a Java exception pending.
+ */
+bool init_posix_ids(JNIEnv* env) {
+    jclass fileStatClass = find_global_class(env, "net/rubygrapefruit/platform/internal/FileStat");
+    jclass dirListClass = find_global_class(env, "net/rubygrapefruit/platform/internal/DirList");
+    jclass treeWalkClass = find_global_class(env, "net/rubygrapefruit/platform/internal/TreeWalk");
+    jclass fileSystemListClass = find_global_class(env, "net/rubygrapefruit/platform/internal/FileSystemList");
+    jclass systemInfoClass = find_global_class(env, "net/rubygrapefruit/platform/internal/MutableSystemInfo");
+    jclass typeInfoClass = find_global_class(env, "net/rubygrapefruit/platform/internal/MutableTypeInfo");
+    jclass terminalSizeClass = find_global_class(env, "net/rubygrapefruit/platform/internal/MutableTerminalSize");
+    if (fileStatClass == NULL || dirListClass == NULL || treeWalkClass == NULL || fileSystemListClass == NULL
+            || systemInfoClass == NULL || typeInfoClass == NULL || terminalSizeClass == NULL) {
+        return false;
+    }
+
+    fileStatDetailsMethodId = env->GetMethodID(fileStatClass, "details", "(IIIIJJI)V");
+    dirListAddFilesMethodId = env->GetMethodID(dirListClass, "addFiles", "([Ljava/lang/String;[I[J[J)V");
+    treeWalkChunkMethodId = env->GetMethodID(treeWalkClass, "chunk", "(I)V");
+    fileSystemListAddMethodId = env->GetMethodID(fileSystemListClass, "add", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ZZZ)V");
+    fileSystemListAddForUnknownCaseSensitivityMethodId = env->GetMethodID(fileSystemListClass, "addForUnknownCaseSensitivity", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Z)V");
+    fileSystemListAddMountMethodId = env->GetMethodID(fileSystemListClass, "addMount", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ZZZIIIILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V");
+    systemInfoOsNameFieldId = env->GetFieldID(systemInfoClass, "osName", "Ljava/lang/String;");
+    systemInfoOsVersionFieldId = env->GetFieldID(systemInfoClass, "osVersion", "Ljava/lang/String;");
+    systemInfoMachineArchitectureFieldId = env->GetFieldID(systemInfoClass, "machineArchitecture", "Ljava/lang/String;");
+    systemInfoHostnameFieldId = env->GetFieldID(systemInfoClass, "hostname", "Ljava/lang/String;");
+    typeInfoIntBytesFieldId = env->GetFieldID(typeInfoClass, "int_bytes", "I");
+    typeInfoULongBytesFieldId = env->GetFieldID(typeInfoClass, "u_long_bytes", "I");
+    typeInfoSizeTBytesFieldId = env->GetFieldID(typeInfoClass, "size_t_bytes", "I");
+    typeInfoUidTBytesFieldId = env->GetFieldID(typeInfoClass, "uid_t_bytes", "I");
+    typeInfoGidTBytesFieldId = env->GetFieldID(typeInfoClass, "gid_t_bytes", "I");
+    typeInfoOffTBytesFieldId = env->GetFieldID(typeInfoClass, "off_t_bytes", "I");
+    terminalSizeColsFieldId = env->GetFieldID(terminalSizeClass, "cols", "I");
+    terminalSizeRowsFieldId = env->GetFieldID(terminalSizeClass, "rows", "I");
+    // GetMethodID() and GetFieldID() throw NoSuchMethodError or NoSuchFieldError on failure
+    return !env->ExceptionCheck();
 }
 
 JNIEXPORT jint JNICALL
@@ -413,8 +2166,9 @@ JNI_OnLoad(JavaVM* jvm, void*) {
     if (ret != JNI_OK) {
         return -1;
     }
-    jclass destClass = env->FindClass("net/rubygrapefruit/platform/internal/FileStat");
-    fileStatDetailsMethodId = env->GetMethodID(destClass, "details", "(IIIIJJI)V");
+    if (!init_generic_ids(env) || !init_posix_ids(env)) {
+        return JNI_ERR;
+    }
     return JNI_VERSION_1_6;
 }
 
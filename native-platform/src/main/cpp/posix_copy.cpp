@@ -0,0 +1,390 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Copying of files, using the cheapest mechanism the platform and file system provide.
+ */
+#ifndef _WIN32
+
+#include "generic.h"
+#include "posix_workers.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixFileFunctions.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+// Corresponds to the ordinals of CopyStrategy, from cheapest to most expensive
+#define COPY_STRATEGY_CLONE 0
+#define COPY_STRATEGY_COPY_FILE_RANGE 1
+#define COPY_STRATEGY_SENDFILE 2
+#define COPY_STRATEGY_READ_WRITE 3
+
+// Corresponds to CopyOptions
+#define COPY_PRESERVE_MODE 1
+#define COPY_PRESERVE_LAST_MODIFIED 2
+
+#define COPY_BUFFER_SIZE (1024 * 1024)
+// Largest amount of data transferred by a single system call
+#define COPY_MAX_TRANSFER (1024 * 1024 * 1024)
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+// Set once copy_file_range() turns out not to be supported by the kernel
+volatile bool copyFileRangeUnavailable = false;
+#endif
+
+/*
+ * Returns true when the given error means that a copy mechanism is not supported for the given files, rather than a real failure.
+ */
+bool is_unsupported_copy_error(int error) {
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP || error == ENOTTY || error == EPERM;
+}
+
+/*
+ * Copies a range of the source file to the same position in the target file, falling back to more expensive mechanisms
+ * as required. The strategy is updated to the most expensive mechanism used.
+ *
+ * Returns 0 on success or the errno of the failure.
+ */
+int copy_file_data(int in, int out, off_t offset, off_t len, int* strategy) {
+    char* buffer = NULL;
+    int error = 0;
+    bool copied = false;
+    while (len > 0) {
+        size_t count = len < COPY_MAX_TRANSFER ? (size_t) len : COPY_MAX_TRANSFER;
+        ssize_t transferred = -1;
+#if defined(__linux__) && defined(__NR_copy_file_range)
+        if (*strategy <= COPY_STRATEGY_COPY_FILE_RANGE) {
+            loff_t inOffset = offset;
+            loff_t outOffset = offset;
+            transferred = syscall(__NR_copy_file_range, in, &inOffset, out, &outOffset, count, 0);
+            if (transferred < 0 && errno != EINTR) {
+                if (!is_unsupported_copy_error(errno)) {
+                    error = errno;
+                    break;
+                }
+                if (errno == ENOSYS) {
+                    copyFileRangeUnavailable = true;
+                }
+                *strategy = COPY_STRATEGY_SENDFILE;
+                continue;
+            }
+        }
+#endif
+#ifdef __linux__
+        if (*strategy == COPY_STRATEGY_SENDFILE) {
+            // sendfile() writes at the current position of the target
+            off_t inOffset = offset;
+            if (lseek(out, offset, SEEK_SET) < 0) {
+                error = errno;
+                break;
+            }
+            transferred = sendfile(out, in, &inOffset, count);
+            if (transferred < 0 && errno != EINTR) {
+                if (!is_unsupported_copy_error(errno)) {
+                    error = errno;
+                    break;
+                }
+                *strategy = COPY_STRATEGY_READ_WRITE;
+                continue;
+            }
+        }
+#endif
+        if (*strategy == COPY_STRATEGY_READ_WRITE) {
+            if (buffer == NULL) {
+                buffer = (char*) malloc(COPY_BUFFER_SIZE);
+                if (buffer == NULL) {
+                    error = ENOMEM;
+                    break;
+                }
+            }
+            transferred = pread(in, buffer, count < COPY_BUFFER_SIZE ? count : COPY_BUFFER_SIZE, offset);
+            if (transferred > 0) {
+                ssize_t written = 0;
+                while (written < transferred) {
+                    ssize_t n = pwrite(out, buffer + written, transferred - written, offset + written);
+                    if (n < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        error = errno;
+                        break;
+                    }
+                    written += n;
+                }
+                if (error != 0) {
+                    break;
+                }
+            } else if (transferred < 0 && errno != EINTR) {
+                error = errno;
+                break;
+            }
+        }
+        if (transferred == 0) {
+            if (!copied && *strategy < COPY_STRATEGY_READ_WRITE) {
+                // Some files, such as those on sysfs, procfs and some FUSE file systems, report a size but cannot be transferred by
+                // copy_file_range() or sendfile(), which copy nothing rather than fail
+                (*strategy)++;
+                continue;
+            }
+            // The source has been truncated while copying
+            break;
+        }
+        if (transferred > 0) {
+            copied = true;
+            offset += transferred;
+            len -= transferred;
+        }
+    }
+    free(buffer);
+    return error;
+}
+
+/*
+ * Copies the data of the source file to the target file, leaving the holes of a sparse source file as holes in the target.
+ */
+int copy_file_contents(int in, int out, struct stat* sourceInfo, int* strategy) {
+    off_t size = sourceInfo->st_size;
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    // Only look for holes when the file occupies fewer blocks than its size suggests
+    if ((off_t) sourceInfo->st_blocks * 512 < size) {
+        off_t offset = 0;
+        while (offset < size) {
+            off_t dataStart = lseek(in, offset, SEEK_DATA);
+            if (dataStart < 0) {
+                if (errno == ENXIO) {
+                    // No more data, the rest of the file is a hole
+                    break;
+                }
+                if (errno == EINVAL) {
+                    // Not supported by the file system, copy the whole file
+                    return copy_file_data(in, out, 0, size, strategy);
+                }
+                return errno;
+            }
+            off_t dataEnd = lseek(in, dataStart, SEEK_HOLE);
+            if (dataEnd < 0) {
+                return errno;
+            }
+            int error = copy_file_data(in, out, dataStart, dataEnd - dataStart, strategy);
+            if (error != 0) {
+                return error;
+            }
+            offset = dataEnd;
+        }
+        // Extend the target to include a trailing hole
+        if (ftruncate(out, size) != 0) {
+            return errno;
+        }
+        return 0;
+    }
+#endif
+    return copy_file_data(in, out, 0, size, strategy);
+}
+
+/*
+ * Copies a regular file. Does not call back into Java, so can be called from any thread.
+ *
+ * Returns 0 on success or the errno of the failure.
+ */
+int copy_file(const char* source, const char* target, int flags, int* strategy) {
+    // Both files are opened non-blocking, so that opening a FIFO does not hang the caller before it can be rejected below
+    int in = open(source, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+    if (in < 0) {
+        return errno;
+    }
+    struct stat sourceInfo;
+    if (fstat(in, &sourceInfo) != 0) {
+        int error = errno;
+        close(in);
+        return error;
+    }
+    if (!S_ISREG(sourceInfo.st_mode)) {
+        close(in);
+        return S_ISDIR(sourceInfo.st_mode) ? EISDIR : EINVAL;
+    }
+    // O_NONBLOCK is the only status flag set above
+    fcntl(in, F_SETFL, 0);
+    // Do not truncate the target until it is known to be a regular file that is not the source, or a hard link to it
+    int out = open(target, O_WRONLY | O_CREAT | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0666);
+    if (out < 0) {
+        int error = errno;
+        close(in);
+        return error;
+    }
+    struct stat targetInfo;
+    int error = 0;
+    if (fstat(out, &targetInfo) != 0) {
+        error = errno;
+    } else if (!S_ISREG(targetInfo.st_mode)) {
+        error = EINVAL;
+    } else if (targetInfo.st_dev == sourceInfo.st_dev && targetInfo.st_ino == sourceInfo.st_ino) {
+        error = EINVAL;
+    } else if (fcntl(out, F_SETFL, 0) != 0 || ftruncate(out, 0) != 0) {
+        error = errno;
+    }
+    if (error != 0) {
+        close(out);
+        close(in);
+        return error;
+    }
+
+    bool cloned = false;
+#if defined(__linux__) && defined(FICLONE)
+    // Shares the extents of the source with the target on file systems that support it, such as btrfs and xfs
+    if (ioctl(out, FICLONE, in) == 0) {
+        cloned = true;
+        *strategy = COPY_STRATEGY_CLONE;
+    }
+#endif
+    if (!cloned) {
+#if defined(__linux__) && defined(__NR_copy_file_range)
+        *strategy = copyFileRangeUnavailable ? COPY_STRATEGY_SENDFILE : COPY_STRATEGY_COPY_FILE_RANGE;
+#elif defined(__linux__)
+        *strategy = COPY_STRATEGY_SENDFILE;
+#else
+        *strategy = COPY_STRATEGY_READ_WRITE;
+#endif
+        error = copy_file_contents(in, out, &sourceInfo, strategy);
+    }
+
+    if (error == 0 && (flags & COPY_PRESERVE_MODE) && fchmod(out, sourceInfo.st_mode & 07777) != 0) {
+        error = errno;
+    }
+    if (error == 0 && (flags & COPY_PRESERVE_LAST_MODIFIED)) {
+        struct timespec times[2];
+        times[0].tv_sec = 0;
+        times[0].tv_nsec = UTIME_OMIT;
+#ifdef __linux__
+        times[1] = sourceInfo.st_mtim;
+#else
+        times[1] = sourceInfo.st_mtimespec;
+#endif
+        if (futimens(out, times) != 0) {
+            error = errno;
+        }
+    }
+    if (close(out) != 0 && error == 0) {
+        error = errno;
+    }
+    close(in);
+    return error;
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_copy(JNIEnv* env, jclass target, jstring source, jstring dest, jint flags, jobject result) {
+    char sourceBuffer[STRING_BUFFER_SIZE];
+    char* sourceStr = java_to_char_buffer(env, source, sourceBuffer, sizeof(sourceBuffer), result);
+    if (sourceStr == NULL) {
+        return 0;
+    }
+    char destBuffer[STRING_BUFFER_SIZE];
+    char* destStr = java_to_char_buffer(env, dest, destBuffer, sizeof(destBuffer), result);
+    if (destStr == NULL) {
+        free_chars(sourceStr, sourceBuffer);
+        return 0;
+    }
+    int strategy = COPY_STRATEGY_READ_WRITE;
+    int error = copy_file(sourceStr, destStr, flags, &strategy);
+    free_chars(sourceStr, sourceBuffer);
+    free_chars(destStr, destBuffer);
+    if (error != 0) {
+        errno = error;
+        mark_failed_with_errno(env, "could not copy file", result);
+    }
+    return strategy;
+}
+
+typedef struct bulk_copy {
+    char** sources;
+    char** targets;
+    int flags;
+    jint* strategies;
+    jint* errors;
+} bulk_copy_t;
+
+void bulk_copy_task(void* context, size_t index) {
+    bulk_copy_t* bulk = (bulk_copy_t*) context;
+    int strategy = COPY_STRATEGY_READ_WRITE;
+    bulk->errors[index] = copy_file(bulk->sources[index], bulk->targets[index], bulk->flags, &strategy);
+    bulk->strategies[index] = strategy;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_copyAll(JNIEnv* env, jclass target, jobjectArray sources, jobjectArray targets, jint flags, jintArray strategies, jintArray errors, jobject result) {
+    jsize count = env->GetArrayLength(sources);
+    if (env->GetArrayLength(targets) != count || env->GetArrayLength(strategies) < count || env->GetArrayLength(errors) < count) {
+        mark_failed_with_message(env, "array lengths do not match", result);
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    bulk_copy_t bulk;
+    bulk.flags = flags;
+    bulk.sources = (char**) calloc(count, sizeof(char*));
+    bulk.targets = (char**) calloc(count, sizeof(char*));
+    bulk.strategies = (jint*) malloc(count * sizeof(jint));
+    bulk.errors = (jint*) malloc(count * sizeof(jint));
+    if (bulk.sources == NULL || bulk.targets == NULL || bulk.strategies == NULL || bulk.errors == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for copy results", result);
+        free(bulk.sources);
+        free(bulk.targets);
+        free(bulk.strategies);
+        free(bulk.errors);
+        return;
+    }
+
+    // Convert all paths up front, the worker threads cannot use JNI
+    bool converted = true;
+    for (jsize i = 0; i < count && converted; i++) {
+        jstring source = (jstring) env->GetObjectArrayElement(sources, i);
+        bulk.sources[i] = java_to_char(env, source, result);
+        env->DeleteLocalRef(source);
+        jstring dest = (jstring) env->GetObjectArrayElement(targets, i);
+        bulk.targets[i] = bulk.sources[i] == NULL ? NULL : java_to_char(env, dest, result);
+        env->DeleteLocalRef(dest);
+        converted = bulk.targets[i] != NULL;
+    }
+
+    if (converted) {
+        run_in_parallel(bulk_copy_task, &bulk, count, 1);
+        env->SetIntArrayRegion(strategies, 0, count, bulk.strategies);
+        env->SetIntArrayRegion(errors, 0, count, bulk.errors);
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        free(bulk.sources[i]);
+        free(bulk.targets[i]);
+    }
+    free(bulk.sources);
+    free(bulk.targets);
+    free(bulk.strategies);
+    free(bulk.errors);
+}
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Hashing of file contents.
+ */
+#ifndef _WIN32
+
+#include "generic.h"
+#include "hashing.h"
+#include "posix_workers.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixFileFunctions.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Files up to this size are read with a single read into a buffer on the stack
+#define HASH_SMALL_BUFFER_SIZE (16 * 1024)
+// Buffer size used to read larger files
+#define HASH_LARGE_BUFFER_SIZE (1024 * 1024)
+// Number of files a worker thread claims at a time
+#define HASH_CHUNK_SIZE 4
+
+typedef struct bulk_hash {
+    const hash_algorithm_t* algorithm;
+    char** paths;
+    unsigned char* digests;
+    jint* errors;
+} bulk_hash_t;
+
+/*
+ * Reads the given file into the hash. Does not call back into Java, so can be called from any thread. Only regular files can be
+ * hashed, as reading a device or FIFO may never finish.
+ *
+ * The file is read with pread() rather than mapped into memory, as a file that is truncated while mapped
+ * causes a SIGBUS, which would take down the JVM.
+ *
+ * Returns 0 on success or the errno of the failure.
+ */
+int hash_file(const char* path, const hash_algorithm_t* algorithm, void* state) {
+    // Opened non-blocking, so that opening a FIFO without a writer does not hang the caller before it can be rejected below
+    int fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return errno;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0) {
+        int error = errno;
+        close(fd);
+        return error;
+    }
+    if (!S_ISREG(fileInfo.st_mode)) {
+        close(fd);
+        return S_ISDIR(fileInfo.st_mode) ? EISDIR : EINVAL;
+    }
+    // O_NONBLOCK is the only status flag set above
+    fcntl(fd, F_SETFL, 0);
+
+    algorithm->init(state);
+    unsigned char smallBuffer[HASH_SMALL_BUFFER_SIZE];
+    unsigned char* buffer = smallBuffer;
+    size_t bufferSize = sizeof(smallBuffer);
+    if (fileInfo.st_size > (off_t) sizeof(smallBuffer)) {
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        unsigned char* largeBuffer = (unsigned char*) malloc(HASH_LARGE_BUFFER_SIZE);
+        if (largeBuffer != NULL) {
+            buffer = largeBuffer;
+            bufferSize = HASH_LARGE_BUFFER_SIZE;
+        }
+    }
+
+    int error = 0;
+    off_t offset = 0;
+    while (true) {
+        ssize_t count = pread(fd, buffer, bufferSize, offset);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = errno;
+            break;
+        }
+        if (count == 0) {
+            break;
+        }
+        algorithm->update(state, buffer, count);
+        offset += count;
+    }
+
+    if (buffer != smallBuffer) {
+        free(buffer);
+    }
+    close(fd);
+    return error;
+}
+
+void bulk_hash_task(void* context, size_t index) {
+    bulk_hash_t* bulk = (bulk_hash_t*) context;
+    const hash_algorithm_t* algorithm = bulk->algorithm;
+    union {
+        unsigned char bytes[MAX_HASH_STATE_SIZE];
+        uint64_t align;
+    } state;
+    unsigned char* digest = bulk->digests + index * algorithm->digestLen;
+    int error = hash_file(bulk->paths[index], algorithm, state.bytes);
+    if (error == 0) {
+        algorithm->digest(state.bytes, digest);
+    } else {
+        memset(digest, 0, algorithm->digestLen);
+    }
+    bulk->errors[index] = error;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_hashAll(JNIEnv* env, jclass target, jobjectArray paths, jint algorithmId, jbyteArray digests, jintArray errors, jobject result) {
+    const hash_algorithm_t* algorithm = hash_algorithm(algorithmId);
+    if (algorithm == NULL || algorithm->stateSize > MAX_HASH_STATE_SIZE) {
+        mark_failed_with_message(env, "unsupported hash algorithm", result);
+        return;
+    }
+    jsize count = env->GetArrayLength(paths);
+    if (env->GetArrayLength(digests) < (jsize) (count * algorithm->digestLen) || env->GetArrayLength(errors) < count) {
+        mark_failed_with_message(env, "result array too small", result);
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    bulk_hash_t bulk;
+    bulk.algorithm = algorithm;
+    bulk.paths = (char**) calloc(count, sizeof(char*));
+    bulk.digests = (unsigned char*) malloc(count * algorithm->digestLen);
+    bulk.errors = (jint*) malloc(count * sizeof(jint));
+    if (bulk.paths == NULL || bulk.digests == NULL || bulk.errors == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for hash results", result);
+        free(bulk.paths);
+        free(bulk.digests);
+        free(bulk.errors);
+        return;
+    }
+
+    // Convert all paths up front, the worker threads cannot use JNI
+    bool converted = true;
+    for (jsize i = 0; i < count; i++) {
+        jstring path = (jstring) env->GetObjectArrayElement(paths, i);
+        bulk.paths[i] = java_to_char(env, path, result);
+        env->DeleteLocalRef(path);
+        if (bulk.paths[i] == NULL) {
+            converted = false;
+            break;
+        }
+    }
+
+    if (converted) {
+        run_in_parallel(bulk_hash_task, &bulk, count, HASH_CHUNK_SIZE);
+        env->SetByteArrayRegion(digests, 0, count * algorithm->digestLen, (jbyte*) bulk.digests);
+        env->SetIntArrayRegion(errors, 0, count, bulk.errors);
+    }
+
+    for (jsize i = 0; i < count; i++) {
+        free(bulk.paths[i]);
+    }
+    free(bulk.paths);
+    free(bulk.digests);
+    free(bulk.errors);
+}
+
+#endif
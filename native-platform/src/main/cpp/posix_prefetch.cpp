@@ -0,0 +1,183 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Hints to the kernel about files that are about to be read, or that are no longer required, issued from a background thread.
+ */
+#ifndef _WIN32
+
+#include "generic.h"
+#include "posix_workers.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixFileFunctions.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Corresponds to the advice constants of DefaultPosixFiles
+#define ADVICE_WILLNEED 0
+#define ADVICE_DONTNEED 1
+
+// Number of files each worker thread takes at a time
+#define ADVICE_CHUNK_SIZE 16
+
+typedef struct file_advice {
+    char** paths;
+    size_t count;
+    int advice;
+    struct file_advice* next;
+} file_advice_t;
+
+// Batches waiting to be applied. A single background thread applies them in order, one batch at a time, so that many calls do not each
+// start their own set of threads
+static pthread_mutex_t adviceLock = PTHREAD_MUTEX_INITIALIZER;
+static file_advice_t* adviceHead = NULL;
+static file_advice_t* adviceTail = NULL;
+static bool adviceThreadRunning = false;
+
+void free_file_advice(file_advice_t* advice) {
+    for (size_t i = 0; i < advice->count; i++) {
+        free(advice->paths[i]);
+    }
+    free(advice->paths);
+    free(advice);
+}
+
+/*
+ * Applies the advice to a single file. This is a hint only, so failures are ignored.
+ */
+void advise_file_task(void* context, size_t index) {
+    file_advice_t* advice = (file_advice_t*) context;
+    int fd = open(advice->paths[index], O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return;
+    }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode) && fileInfo.st_size > 0) {
+#if defined(POSIX_FADV_WILLNEED)
+        // On Linux, this starts asynchronous readahead of the whole file, the same as readahead()
+        posix_fadvise(fd, 0, 0, advice->advice == ADVICE_WILLNEED ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED);
+#elif defined(F_RDADVISE)
+        // macOS has no equivalent of DONTNEED
+        if (advice->advice == ADVICE_WILLNEED) {
+            struct radvisory hint;
+            hint.ra_offset = 0;
+            hint.ra_count = fileInfo.st_size > INT_MAX ? INT_MAX : (int) fileInfo.st_size;
+            fcntl(fd, F_RDADVISE, &hint);
+        }
+#endif
+    }
+    close(fd);
+}
+
+/*
+ * Applies the queued batches, exiting once the queue is empty.
+ */
+void* advise_files_main(void* arg) {
+    while (true) {
+        pthread_mutex_lock(&adviceLock);
+        file_advice_t* advice = adviceHead;
+        if (advice == NULL) {
+            adviceThreadRunning = false;
+            pthread_mutex_unlock(&adviceLock);
+            return NULL;
+        }
+        adviceHead = advice->next;
+        if (adviceHead == NULL) {
+            adviceTail = NULL;
+        }
+        pthread_mutex_unlock(&adviceLock);
+
+        run_in_parallel(advise_file_task, advice, advice->count, ADVICE_CHUNK_SIZE);
+        free_file_advice(advice);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_adviseAll(JNIEnv* env, jclass target, jobjectArray files, jint adviceType, jobject result) {
+    jsize count = env->GetArrayLength(files);
+    if (count == 0) {
+        return;
+    }
+
+    file_advice_t* advice = (file_advice_t*) malloc(sizeof(file_advice_t));
+    char** paths = (char**) calloc(count, sizeof(char*));
+    if (advice == NULL || paths == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for file advice", result);
+        free(advice);
+        free(paths);
+        return;
+    }
+    advice->paths = paths;
+    advice->count = count;
+    advice->advice = adviceType;
+    advice->next = NULL;
+
+    // Convert all paths up front, the background threads cannot use JNI
+    for (jsize i = 0; i < count; i++) {
+        jstring path = (jstring) env->GetObjectArrayElement(files, i);
+        paths[i] = java_to_char(env, path, result);
+        env->DeleteLocalRef(path);
+        if (paths[i] == NULL) {
+            free_file_advice(advice);
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&adviceLock);
+    if (adviceTail != NULL) {
+        adviceTail->next = advice;
+    } else {
+        adviceHead = advice;
+    }
+    adviceTail = advice;
+    if (adviceThreadRunning) {
+        pthread_mutex_unlock(&adviceLock);
+        return;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    // Signals should be delivered to the JVM's threads, not this one. The worker threads inherit the mask.
+    sigset_t signals;
+    sigset_t previous;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_SETMASK, &signals, &previous);
+    pthread_t thread;
+    int error = pthread_create(&thread, &attr, advise_files_main, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+        // Nothing else can be queued while the thread is not running
+        adviceHead = NULL;
+        adviceTail = NULL;
+        pthread_mutex_unlock(&adviceLock);
+        free_file_advice(advice);
+        errno = error;
+        mark_failed_with_errno(env, "could not start thread", result);
+        return;
+    }
+    adviceThreadRunning = true;
+    pthread_mutex_unlock(&adviceLock);
+}
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Comparison of directory snapshots.
+ */
+#ifndef _WIN32
+
+#include "generic.h"
+#include "posix_workers.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixFileFunctions.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Corresponds to the layout documented on DirectorySnapshot.
+// A snapshot starts with the number of entries (int32), followed by the entries sorted by path.
+// Each entry is: type (int32), path length (int32), size (int64), last modified (int64), path bytes
+#define SNAPSHOT_HEADER_LEN 4
+#define SNAPSHOT_RECORD_HEADER_LEN 24
+
+// Corresponds to DefaultDirectorySnapshotDiff
+#define DIFF_ADDED 0
+#define DIFF_REMOVED 1
+#define DIFF_MODIFIED 2
+
+// Number of entries of the previous snapshot compared by a worker thread at a time
+#define DIFF_PARTITION_SIZE 4096
+
+typedef struct snapshot {
+    jint count;
+    // Start of each entry
+    const char** entries;
+} snapshot_t;
+
+typedef struct snapshot_diff {
+    snapshot_t* previous;
+    snapshot_t* current;
+    // Boundaries of each partition in both snapshots, there is one more boundary than partitions
+    jint* previousBounds;
+    jint* currentBounds;
+    // Changes of each partition, as (kind, index) pairs. Partition i starts at 2 * (previousBounds[i] + currentBounds[i])
+    jint* changes;
+    jint* changeCounts;
+} snapshot_diff_t;
+
+inline jint entry_path_len(const char* entry) {
+    jint len;
+    memcpy(&len, entry + 4, sizeof(jint));
+    return len;
+}
+
+/*
+ * Compares entry paths as unsigned bytes. This is plain byte order, so the children of a directory do not necessarily sort directly after
+ * it, for example "a" < "a-b" < "a/c".
+ */
+int compare_entry_paths(const char* a, const char* b) {
+    jint aLen = entry_path_len(a);
+    jint bLen = entry_path_len(b);
+    int result = memcmp(a + SNAPSHOT_RECORD_HEADER_LEN, b + SNAPSHOT_RECORD_HEADER_LEN, aLen < bLen ? aLen : bLen);
+    if (result != 0) {
+        return result;
+    }
+    return aLen < bLen ? -1 : (aLen > bLen ? 1 : 0);
+}
+
+/*
+ * Locates the entries of a snapshot, checking that they lie within the buffer and are sorted.
+ */
+bool index_snapshot(JNIEnv* env, const char* data, jlong len, snapshot_t* snapshot, jobject result) {
+    snapshot->entries = NULL;
+    if (data == NULL || len < SNAPSHOT_HEADER_LEN) {
+        mark_failed_with_message(env, "snapshot is not a direct buffer or is truncated", result);
+        return false;
+    }
+    memcpy(&snapshot->count, data, sizeof(jint));
+    if (snapshot->count < 0 || snapshot->count > (len - SNAPSHOT_HEADER_LEN) / SNAPSHOT_RECORD_HEADER_LEN) {
+        mark_failed_with_message(env, "snapshot has an invalid number of entries", result);
+        return false;
+    }
+    snapshot->entries = (const char**) malloc((snapshot->count + 1) * sizeof(const char*));
+    if (snapshot->entries == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for snapshot", result);
+        return false;
+    }
+    jlong offset = SNAPSHOT_HEADER_LEN;
+    for (jint i = 0; i < snapshot->count; i++) {
+        if (offset + SNAPSHOT_RECORD_HEADER_LEN > len) {
+            mark_failed_with_message(env, "snapshot is truncated", result);
+            return false;
+        }
+        const char* entry = data + offset;
+        jint pathLen = entry_path_len(entry);
+        if (pathLen < 0 || offset + SNAPSHOT_RECORD_HEADER_LEN + pathLen > len) {
+            mark_failed_with_message(env, "snapshot is truncated", result);
+            return false;
+        }
+        if (i > 0 && compare_entry_paths(snapshot->entries[i - 1], entry) >= 0) {
+            mark_failed_with_message(env, "snapshot entries are not sorted by path", result);
+            return false;
+        }
+        snapshot->entries[i] = entry;
+        offset += SNAPSHOT_RECORD_HEADER_LEN + pathLen;
+    }
+    return true;
+}
+
+/*
+ * Returns the index of the first entry whose path is not less than the path of the given entry.
+ */
+jint lower_bound_entry(snapshot_t* snapshot, const char* entry) {
+    jint low = 0;
+    jint high = snapshot->count;
+    while (low < high) {
+        jint mid = low + (high - low) / 2;
+        if (compare_entry_paths(snapshot->entries[mid], entry) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+inline void add_change(jint* changes, jint* count, jint kind, jint index) {
+    changes[2 * *count] = kind;
+    changes[2 * *count + 1] = index;
+    (*count)++;
+}
+
+/*
+ * Merges one partition of both snapshots. Does not call back into Java, so can be called from any thread.
+ */
+void diff_partition(void* context, size_t partition) {
+    snapshot_diff_t* diff = (snapshot_diff_t*) context;
+    jint i = diff->previousBounds[partition];
+    jint previousEnd = diff->previousBounds[partition + 1];
+    jint j = diff->currentBounds[partition];
+    jint currentEnd = diff->currentBounds[partition + 1];
+    jint* changes = diff->changes + 2 * (i + j);
+    jint count = 0;
+
+    while (i < previousEnd && j < currentEnd) {
+        const char* previous = diff->previous->entries[i];
+        const char* current = diff->current->entries[j];
+        int order = compare_entry_paths(previous, current);
+        if (order < 0) {
+            add_change(changes, &count, DIFF_REMOVED, i++);
+        } else if (order > 0) {
+            add_change(changes, &count, DIFF_ADDED, j++);
+        } else {
+            // Same path, compare type, size and last modified time in one go
+            if (memcmp(previous, current, 4) != 0 || memcmp(previous + 8, current + 8, 16) != 0) {
+                add_change(changes, &count, DIFF_MODIFIED, j);
+            }
+            i++;
+            j++;
+        }
+    }
+    while (i < previousEnd) {
+        add_change(changes, &count, DIFF_REMOVED, i++);
+    }
+    while (j < currentEnd) {
+        add_change(changes, &count, DIFF_ADDED, j++);
+    }
+    diff->changeCounts[partition] = count;
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileFunctions_diffSnapshots(JNIEnv* env, jclass target, jobject previousBuffer, jint previousLen, jobject currentBuffer, jint currentLen, jintArray changes, jobject result) {
+    snapshot_t previous;
+    snapshot_t current;
+    current.entries = NULL;
+    jint total = 0;
+    if (!index_snapshot(env, (const char*) env->GetDirectBufferAddress(previousBuffer), previousLen, &previous, result)
+        || !index_snapshot(env, (const char*) env->GetDirectBufferAddress(currentBuffer), currentLen, &current, result)) {
+        free(previous.entries);
+        free(current.entries);
+        return 0;
+    }
+    if (env->GetArrayLength(changes) < 2 * (previous.count + current.count)) {
+        mark_failed_with_message(env, "change array too small", result);
+        free(previous.entries);
+        free(current.entries);
+        return 0;
+    }
+
+    // Split the previous snapshot into partitions of equal size, and the current snapshot at the same paths
+    jint partitions = (previous.count + DIFF_PARTITION_SIZE - 1) / DIFF_PARTITION_SIZE;
+    if (partitions == 0) {
+        partitions = 1;
+    }
+    snapshot_diff_t diff;
+    diff.previous = &previous;
+    diff.current = &current;
+    diff.previousBounds = (jint*) malloc((partitions + 1) * sizeof(jint));
+    diff.currentBounds = (jint*) malloc((partitions + 1) * sizeof(jint));
+    diff.changeCounts = (jint*) malloc(partitions * sizeof(jint));
+    diff.changes = (jint*) malloc((2 * (previous.count + current.count) + 1) * sizeof(jint));
+    if (diff.previousBounds == NULL || diff.currentBounds == NULL || diff.changeCounts == NULL || diff.changes == NULL) {
+        mark_failed_with_message(env, "could not allocate memory for snapshot diff", result);
+    } else {
+        diff.previousBounds[0] = 0;
+        diff.currentBounds[0] = 0;
+        for (jint p = 1; p < partitions; p++) {
+            diff.previousBounds[p] = p * DIFF_PARTITION_SIZE;
+            diff.currentBounds[p] = lower_bound_entry(&current, previous.entries[p * DIFF_PARTITION_SIZE]);
+        }
+        diff.previousBounds[partitions] = previous.count;
+        diff.currentBounds[partitions] = current.count;
+
+        run_in_parallel(diff_partition, &diff, partitions, 1);
+
+        for (jint p = 0; p < partitions; p++) {
+            jint count = diff.changeCounts[p];
+            env->SetIntArrayRegion(changes, 2 * total, 2 * count, diff.changes + 2 * (diff.previousBounds[p] + diff.currentBounds[p]));
+            total += count;
+        }
+    }
+
+    free(diff.previousBounds);
+    free(diff.currentBounds);
+    free(diff.changeCounts);
+    free(diff.changes);
+    free(previous.entries);
+    free(current.entries);
+    return total;
+}
+
+#endif
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Terminal input: bulk reads from stdin with a timeout, and decoding of the bytes read into key events.
+ */
+#ifndef _WIN32
+
+#include "generic.h"
+#include "net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions.h"
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define INPUT_BUFFER_SIZE 4096
+
+// Corresponds to the record layout of PosixTerminalInput
+#define DECODE_CONSUMED 0
+#define DECODE_EVENT_COUNT 1
+#define DECODE_IN_PASTE 2
+#define DECODE_EVENTS 3
+
+// Each event is a (type, value) pair
+#define EVENT_CHARACTER 0
+#define EVENT_CONTROL_KEY 1
+#define EVENT_END_INPUT 2
+
+// Corresponds to the ordinals of TerminalInputListener.Key
+#define KEY_ENTER 0
+#define KEY_UP_ARROW 1
+#define KEY_DOWN_ARROW 2
+#define KEY_LEFT_ARROW 3
+#define KEY_RIGHT_ARROW 4
+#define KEY_HOME 5
+#define KEY_END 6
+#define KEY_ERASE_BACK 7
+#define KEY_ERASE_FORWARD 8
+#define KEY_BACK_TAB 9
+#define KEY_PAGE_UP 10
+#define KEY_PAGE_DOWN 11
+
+// Results of decoding an escape sequence, other than a key
+#define SEQUENCE_UNKNOWN -1
+#define SEQUENCE_PASTE_START -2
+#define SEQUENCE_PASTE_END -3
+
+// Longest CSI sequence that is recognized, longer sequences are treated as plain input
+#define MAX_SEQUENCE_LENGTH 32
+
+#define ESCAPE 0x1b
+
+int key_for_final_byte(unsigned char finalByte) {
+    switch (finalByte) {
+        case 'A':
+            return KEY_UP_ARROW;
+        case 'B':
+            return KEY_DOWN_ARROW;
+        case 'C':
+            return KEY_RIGHT_ARROW;
+        case 'D':
+            return KEY_LEFT_ARROW;
+        case 'H':
+            return KEY_HOME;
+        case 'F':
+            return KEY_END;
+        case 'Z':
+            return KEY_BACK_TAB;
+        default:
+            return SEQUENCE_UNKNOWN;
+    }
+}
+
+int key_for_tilde_sequence(int code) {
+    switch (code) {
+        case 1:
+        case 7:
+            return KEY_HOME;
+        case 3:
+            return KEY_ERASE_FORWARD;
+        case 4:
+        case 8:
+            return KEY_END;
+        case 5:
+            return KEY_PAGE_UP;
+        case 6:
+            return KEY_PAGE_DOWN;
+        case 200:
+            return SEQUENCE_PASTE_START;
+        case 201:
+            return SEQUENCE_PASTE_END;
+        default:
+            return SEQUENCE_UNKNOWN;
+    }
+}
+
+/*
+ * Decodes the escape sequence at the start of the given bytes, which start with ESC. Returns the length of the sequence and sets key to the
+ * key or SEQUENCE_* value of the sequence. Returns 0 when more bytes are required, and -1 when the bytes do not start a sequence.
+ *
+ * Handles CSI sequences, including those with modifier parameters such as ESC [ 1 ; 5 A, and SS3 sequences.
+ */
+int decode_escape_sequence(const unsigned char* bytes, int length, int* key) {
+    if (length < 2) {
+        return 0;
+    }
+    if (bytes[1] == 'O') {
+        if (length < 3) {
+            return 0;
+        }
+        *key = key_for_final_byte(bytes[2]);
+        return 3;
+    }
+    if (bytes[1] != '[') {
+        return -1;
+    }
+    // Only the first parameter is used, to select the key for ESC [ n ~ sequences
+    int code = 0;
+    bool firstParameter = true;
+    for (int i = 2; i < length; i++) {
+        unsigned char ch = bytes[i];
+        if (i >= MAX_SEQUENCE_LENGTH) {
+            return -1;
+        }
+        if (ch >= '0' && ch <= '9') {
+            if (firstParameter && code < 1000) {
+                code = code * 10 + (ch - '0');
+            }
+        } else if (ch >= 0x3a && ch <= 0x3f) {
+            firstParameter = false;
+        } else if (ch >= 0x20 && ch <= 0x2f) {
+            // An intermediate byte
+            firstParameter = false;
+        } else if (ch >= 0x40 && ch <= 0x7e) {
+            *key = ch == '~' ? key_for_tilde_sequence(code) : key_for_final_byte(ch);
+            return i + 1;
+        } else {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Decodes the UTF-8 encoded character at the start of the given bytes. Returns the length of the encoding and sets codePoint. Returns 0
+ * when more bytes are required, and -1 when the bytes are not valid UTF-8.
+ */
+int decode_utf8(const unsigned char* bytes, int length, int* codePoint) {
+    unsigned char lead = bytes[0];
+    int count;
+    int value;
+    int min;
+    if (lead >= 0xc2 && lead <= 0xdf) {
+        count = 2;
+        value = lead & 0x1f;
+        min = 0x80;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+        count = 3;
+        value = lead & 0x0f;
+        min = 0x800;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+        count = 4;
+        value = lead & 0x07;
+        min = 0x10000;
+    } else {
+        return -1;
+    }
+    for (int i = 1; i < count; i++) {
+        if (i >= length) {
+            return 0;
+        }
+        if ((bytes[i] & 0xc0) != 0x80) {
+            return -1;
+        }
+        value = (value << 6) | (bytes[i] & 0x3f);
+    }
+    if (value < min || value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff)) {
+        return -1;
+    }
+    *codePoint = value;
+    return count;
+}
+
+JNIEXPORT jint JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_readInput(JNIEnv* env, jclass target, jbyteArray buffer, jint offset, jint length, jint timeoutMillis, jobject result) {
+    struct pollfd pollFd;
+    pollFd.fd = STDIN_FILENO;
+    pollFd.events = POLLIN;
+    int ready;
+    do {
+        ready = poll(&pollFd, 1, timeoutMillis);
+    } while (ready < 0 && errno == EINTR);
+    if (ready < 0) {
+        mark_failed_with_errno(env, "could not wait for terminal input", result);
+        return -1;
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    jbyte chunk[INPUT_BUFFER_SIZE];
+    ssize_t count;
+    do {
+        count = read(STDIN_FILENO, chunk, length < INPUT_BUFFER_SIZE ? length : INPUT_BUFFER_SIZE);
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) {
+        mark_failed_with_errno(env, "could not read from terminal", result);
+        return -1;
+    }
+    if (count == 0) {
+        return -1;
+    }
+    env->SetByteArrayRegion(buffer, offset, count, chunk);
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixTerminalFunctions_decodeInput(JNIEnv* env, jclass target, jbyteArray buffer, jint offset, jint length, jboolean flush, jintArray record) {
+    unsigned char bytes[INPUT_BUFFER_SIZE];
+    if (length > INPUT_BUFFER_SIZE) {
+        length = INPUT_BUFFER_SIZE;
+    }
+    env->GetByteArrayRegion(buffer, offset, length, (jbyte*) bytes);
+
+    jint inPaste;
+    env->GetIntArrayRegion(record, DECODE_IN_PASTE, 1, &inPaste);
+    // Each byte produces at most one event, apart from a 4 byte UTF-8 encoding which produces two
+    int capacity = (env->GetArrayLength(record) - DECODE_EVENTS) / 2;
+    jint events[2 * INPUT_BUFFER_SIZE];
+    int eventCount = 0;
+
+    int pos = 0;
+    while (pos < length && eventCount + 2 <= capacity) {
+        unsigned char ch = bytes[pos];
+        int type = EVENT_CHARACTER;
+        int value = ch;
+        int consumed = 1;
+        if (ch == ESCAPE) {
+            int key = SEQUENCE_UNKNOWN;
+            int sequenceLength = decode_escape_sequence(bytes + pos, length - pos, &key);
+            if (sequenceLength == 0 && !flush) {
+                // Wait for the remainder of the sequence, a lone ESC is only decoded as a character when no more input arrives in time
+                break;
+            }
+            if (sequenceLength > 0) {
+                pos += sequenceLength;
+                if (key == SEQUENCE_PASTE_START) {
+                    inPaste = 1;
+                } else if (key == SEQUENCE_PASTE_END) {
+                    inPaste = 0;
+                } else if (key >= 0) {
+                    events[2 * eventCount] = EVENT_CONTROL_KEY;
+                    events[2 * eventCount + 1] = key;
+                    eventCount++;
+                }
+                continue;
+            }
+        } else if (inPaste) {
+            // Deliver pasted text as characters, so that a pasted line separator does not submit the input
+        } else if (ch == '\n') {
+            type = EVENT_CONTROL_KEY;
+            value = KEY_ENTER;
+        } else if (ch == 127 || ch == 8) {
+            type = EVENT_CONTROL_KEY;
+            value = KEY_ERASE_BACK;
+        } else if (ch == 4) {
+            // ctrl-d
+            type = EVENT_END_INPUT;
+        }
+        if (ch >= 0x80) {
+            int codePoint;
+            int encodedLength = decode_utf8(bytes + pos, length - pos, &codePoint);
+            if (encodedLength == 0 && !flush) {
+                break;
+            }
+            // Invalid or truncated UTF-8 is delivered byte by byte
+            if (encodedLength > 0) {
+                consumed = encodedLength;
+                if (codePoint >= 0x10000) {
+                    codePoint -= 0x10000;
+                    events[2 * eventCount] = EVENT_CHARACTER;
+                    events[2 * eventCount + 1] = 0xd800 + (codePoint >> 10);
+                    eventCount++;
+                    value = 0xdc00 + (codePoint & 0x3ff);
+                } else {
+                    value = codePoint;
+                }
+            }
+        }
+        events[2 * eventCount] = type;
+        events[2 * eventCount + 1] = value;
+        eventCount++;
+        pos += consumed;
+    }
+
+    jint header[DECODE_EVENTS];
+    header[DECODE_CONSUMED] = pos;
+    header[DECODE_EVENT_COUNT] = eventCount;
+    header[DECODE_IN_PASTE] = inPaste;
+    env->SetIntArrayRegion(record, 0, DECODE_EVENTS, header);
+    env->SetIntArrayRegion(record, DECODE_EVENTS, 2 * eventCount, events);
+}
+
+#endif
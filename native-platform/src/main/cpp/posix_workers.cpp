@@ -0,0 +1,89 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * POSIX native worker threads.
+ */
+#ifndef _WIN32
+
+#include "posix_workers.h"
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct parallel_run {
+    parallel_task_t task;
+    void* context;
+    size_t count;
+    size_t chunkSize;
+    size_t next;
+} parallel_run_t;
+
+int worker_count(size_t count, size_t chunkSize) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) {
+        cpus = 1;
+    }
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+    size_t workers = (size_t) cpus < chunks ? (size_t) cpus : chunks;
+    if (workers > MAX_WORKER_THREADS) {
+        workers = MAX_WORKER_THREADS;
+    }
+    return workers < 1 ? 1 : (int) workers;
+}
+
+void* run_chunks(void* arg) {
+    parallel_run_t* run = (parallel_run_t*) arg;
+    while (true) {
+        size_t start = __sync_fetch_and_add(&run->next, run->chunkSize);
+        if (start >= run->count) {
+            break;
+        }
+        size_t end = start + run->chunkSize < run->count ? start + run->chunkSize : run->count;
+        for (size_t i = start; i < end; i++) {
+            run->task(run->context, i);
+        }
+    }
+    return NULL;
+}
+
+void run_in_parallel(parallel_task_t task, void* context, size_t count, size_t chunkSize) {
+    if (chunkSize == 0) {
+        chunkSize = 1;
+    }
+    parallel_run_t run;
+    run.task = task;
+    run.context = context;
+    run.count = count;
+    run.chunkSize = chunkSize;
+    run.next = 0;
+
+    int workers = worker_count(count, chunkSize);
+    pthread_t threads[MAX_WORKER_THREADS];
+    int started = 0;
+    for (int i = 1; i < workers; i++) {
+        // When we cannot start a thread, carry on with the threads we've got
+        if (pthread_create(&threads[started], NULL, run_chunks, &run) != 0) {
+            break;
+        }
+        started++;
+    }
+    run_chunks(&run);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+#endif
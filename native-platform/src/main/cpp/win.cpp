@@ -427,6 +427,38 @@ Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_listFileS
     free(fileSystemName);
 }
 
+// Corresponds to the record layout of DefaultFileSystemCapacity
+#define CAPACITY_RECORD_TOTAL 0
+#define CAPACITY_RECORD_FREE 1
+#define CAPACITY_RECORD_AVAILABLE 2
+#define CAPACITY_RECORD_TOTAL_INODES 3
+#define CAPACITY_RECORD_FREE_INODES 4
+#define CAPACITY_RECORD_AVAILABLE_INODES 5
+#define CAPACITY_RECORD_LEN 6
+
+JNIEXPORT void JNICALL
+Java_net_rubygrapefruit_platform_internal_jni_PosixFileSystemFunctions_getCapacity(JNIEnv* env, jclass target, jstring path, jlongArray record, jobject result) {
+    wchar_t* pathStr = java_to_wchar_path(env, path);
+    ULARGE_INTEGER availableBytes;
+    ULARGE_INTEGER totalBytes;
+    ULARGE_INTEGER freeBytes;
+    BOOL ok = GetDiskFreeSpaceExW(pathStr, &availableBytes, &totalBytes, &freeBytes);
+    free(pathStr);
+    if (!ok) {
+        mark_failed_with_errno(env, "could not query file system capacity", result);
+        return;
+    }
+    jlong values[CAPACITY_RECORD_LEN];
+    values[CAPACITY_RECORD_TOTAL] = (jlong) totalBytes.QuadPart;
+    values[CAPACITY_RECORD_FREE] = (jlong) freeBytes.QuadPart;
+    values[CAPACITY_RECORD_AVAILABLE] = (jlong) availableBytes.QuadPart;
+    // NTFS does not have a fixed number of file records
+    values[CAPACITY_RECORD_TOTAL_INODES] = -1;
+    values[CAPACITY_RECORD_FREE_INODES] = -1;
+    values[CAPACITY_RECORD_AVAILABLE_INODES] = -1;
+    env->SetLongArrayRegion(record, 0, CAPACITY_RECORD_LEN, values);
+}
+
 JNIEXPORT void JNICALL
 Java_net_rubygrapefruit_platform_internal_jni_WindowsFileFunctions_stat(JNIEnv* env, jclass target, jstring path, jboolean followLink, jobject dest, jobject result) {
     jclass destClass = env->GetObjectClass(dest);
@@ -1083,4 +1115,17 @@ Java_net_rubygrapefruit_platform_internal_jni_WindowsRegistryFunctions_getValueN
     return true;
 }
 
+JNIEXPORT jint JNICALL
+JNI_OnLoad(JavaVM* jvm, void*) {
+    JNIEnv* env;
+    jint ret = jvm->GetEnv((void**) &env, JNI_VERSION_1_6);
+    if (ret != JNI_OK) {
+        return -1;
+    }
+    if (!init_generic_ids(env)) {
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_6;
+}
+
 #endif
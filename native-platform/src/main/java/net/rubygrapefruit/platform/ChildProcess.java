@@ -0,0 +1,40 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+import javax.annotation.Nullable;
+
+/**
+ * Additional details of a {@link java.lang.Process} started by {@link ProcessLauncher}, on platforms where processes are started natively.
+ * Check whether the returned process implements this interface before using it.
+ */
+@ThreadSafe
+public interface ChildProcess {
+    /**
+     * Returns the process identifier of the child.
+     */
+    @ThreadSafe
+    int getPid();
+
+    /**
+     * Returns the resources used by the child, once it has exited. Returns null while the child is running, or when the usage is not
+     * collected on this platform.
+     */
+    @Nullable
+    @ThreadSafe
+    ChildProcessUsage getResourceUsage();
+}
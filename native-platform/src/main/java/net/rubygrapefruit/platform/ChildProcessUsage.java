@@ -0,0 +1,38 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * The resources used by a child process over its lifetime, as reported when it was reaped.
+ */
+@ThreadSafe
+public interface ChildProcessUsage {
+    /**
+     * Returns the CPU time the child spent in user mode, in nanoseconds.
+     */
+    long getUserCpuTime();
+
+    /**
+     * Returns the CPU time the child spent in kernel mode, in nanoseconds.
+     */
+    long getSystemCpuTime();
+
+    /**
+     * Returns the peak resident memory of the child, in bytes.
+     */
+    long getMaxResidentMemory();
+}
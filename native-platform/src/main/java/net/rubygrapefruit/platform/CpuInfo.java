@@ -0,0 +1,83 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * Describes the CPUs that are available to the current process, taking its CPU affinity and the CPU quota of its cgroup into account. Use this
+ * to size thread pools instead of the total number of processors of the machine, which overestimates the parallelism in a container.
+ */
+@ThreadSafe
+public interface CpuInfo {
+    /**
+     * Returns the number of processors that are online in the machine.
+     */
+    int getOnlineProcessorCount();
+
+    /**
+     * Returns the number of processors that the current process may run on, as restricted by its affinity mask and cpuset.
+     */
+    int getAvailableProcessorCount();
+
+    /**
+     * Returns the number of distinct physical cores among the available processors.
+     */
+    int getCoreCount();
+
+    /**
+     * Returns the number of distinct processor packages (sockets) among the available processors.
+     */
+    int getPackageCount();
+
+    /**
+     * Returns the number of NUMA nodes that contain at least one of the available processors.
+     */
+    int getNumaNodeCount();
+
+    /**
+     * Returns the CPU time in microseconds that the cgroup of the current process may use per period, from {@literal cpu.max} or
+     * {@literal cpu.cfs_quota_us}, or -1 when there is no quota.
+     */
+    long getCgroupCpuQuota();
+
+    /**
+     * Returns the length in microseconds of the period of the CPU quota, or -1 when there is no quota.
+     */
+    long getCgroupCpuPeriod();
+
+    /**
+     * Returns the number of processors that the CPU quota of the cgroup allows, which may be fractional, or -1 when there is no quota.
+     */
+    double getCgroupCpuLimit();
+
+    /**
+     * Returns the number of processors that the current process can effectively use, which is the smaller of the available processors and
+     * the CPU quota of the cgroup.
+     */
+    double getEffectiveProcessorCount();
+
+    /**
+     * Returns the recommended number of threads for a pool that runs CPU bound tasks. This is the effective processor count rounded up, and
+     * at least 1.
+     */
+    int getRecommendedCpuBoundParallelism();
+
+    /**
+     * Returns the recommended number of threads for a pool that runs tasks that mostly block on I/O. This is a fixed multiple of
+     * {@link #getRecommendedCpuBoundParallelism()}, which is a reasonable starting point when the ratio of waiting to computing is not known.
+     */
+    int getRecommendedIoBoundParallelism();
+}
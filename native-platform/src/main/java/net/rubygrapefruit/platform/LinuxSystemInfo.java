@@ -0,0 +1,50 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * Provides Linux specific system information, including the CPUs that are available to the current process.
+ */
+@ThreadSafe
+public interface LinuxSystemInfo extends SystemInfo {
+    /**
+     * Queries the CPUs that are available to the current process. This is not a snapshot, as the affinity and the cgroup of the process can change
+     * while it runs, so each call queries the current state.
+     *
+     * @throws NativeException On failure.
+     */
+    @ThreadSafe
+    CpuInfo getCpuInfo() throws NativeException;
+
+    /**
+     * Opens a sampler for the resource usage of the current process and the pressure on the system. The sampler should be closed when no
+     * longer required.
+     *
+     * @throws NativeException On failure.
+     */
+    @ThreadSafe
+    ProcessResourceSampler openProcessResourceSampler() throws NativeException;
+
+    /**
+     * Queries the resource usage of the given process and all of its descendants. Walks the process tree using /proc, so a tree of a
+     * few hundred processes takes milliseconds.
+     *
+     * @throws NativeException On failure, or when the given process does not exist.
+     */
+    @ThreadSafe
+    ProcessTree getProcessTree(int pid) throws NativeException;
+}
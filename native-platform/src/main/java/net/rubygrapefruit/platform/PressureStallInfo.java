@@ -0,0 +1,51 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * The pressure stall information of a resource, as reported by {@literal /proc/pressure}. The "some" values describe the share of time in
+ * which at least one task was stalled on the resource, and the "full" values the share of time in which all non-idle tasks were stalled.
+ * Averages are percentages over the last 10, 60 and 300 seconds, and are -1 when not available.
+ */
+public interface PressureStallInfo {
+    /**
+     * Returns true when the kernel reports pressure for this resource.
+     */
+    boolean isAvailable();
+
+    double getSomeAverage10();
+
+    double getSomeAverage60();
+
+    double getSomeAverage300();
+
+    /**
+     * Returns the total time in microseconds that some tasks were stalled.
+     */
+    long getSomeTotal();
+
+    double getFullAverage10();
+
+    double getFullAverage60();
+
+    double getFullAverage300();
+
+    /**
+     * Returns the total time in microseconds that all non-idle tasks were stalled, or -1 when not available.
+     */
+    long getFullTotal();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * A sample of the resource usage of the current process. Values that are not available are reported as -1.
+ */
+public interface ProcessResourceSample {
+    /**
+     * Returns the time the sample was taken, in nanoseconds of the monotonic clock used by {@link System#nanoTime()}.
+     */
+    long getTimestamp();
+
+    /**
+     * Returns the CPU time the process has spent in user mode, in nanoseconds.
+     */
+    long getUserCpuTime();
+
+    /**
+     * Returns the CPU time the process has spent in kernel mode, in nanoseconds.
+     */
+    long getSystemCpuTime();
+
+    /**
+     * Returns the number of threads of the process.
+     */
+    int getThreadCount();
+
+    /**
+     * Returns the resident memory of the process, in bytes.
+     */
+    long getResidentMemory();
+
+    /**
+     * Returns the peak resident memory of the process, in bytes.
+     */
+    long getPeakResidentMemory();
+
+    /**
+     * Returns the number of bytes the process has read through system calls, including reads served from the page cache.
+     */
+    long getReadChars();
+
+    /**
+     * Returns the number of bytes the process has written through system calls.
+     */
+    long getWrittenChars();
+
+    /**
+     * Returns the number of bytes the process has caused to be read from storage.
+     */
+    long getReadBytes();
+
+    /**
+     * Returns the number of bytes the process has caused to be written to storage.
+     */
+    long getWrittenBytes();
+
+    /**
+     * Returns the system wide CPU pressure.
+     */
+    PressureStallInfo getCpuPressure();
+
+    /**
+     * Returns the system wide memory pressure.
+     */
+    PressureStallInfo getMemoryPressure();
+
+    /**
+     * Returns the system wide I/O pressure.
+     */
+    PressureStallInfo getIoPressure();
+}
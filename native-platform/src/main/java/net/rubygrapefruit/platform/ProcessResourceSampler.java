@@ -0,0 +1,44 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * Samples the resource usage of the current process and the pressure on the system. The underlying files are kept open until the sampler
+ * is closed, and each sample is written into a reusable {@link ProcessResourceSample}, so that sampling many times per second does not
+ * allocate.
+ *
+ * <p>A sampler is not thread safe, and should be used by a single thread.</p>
+ */
+public interface ProcessResourceSampler {
+    /**
+     * Creates a sample that can be passed to {@link #sample(ProcessResourceSample)} any number of times.
+     */
+    ProcessResourceSample newSample();
+
+    /**
+     * Samples the current state into the given sample, which must have been created by {@link #newSample()}.
+     *
+     * @throws ResourceClosedException When this sampler has been closed.
+     * @throws NativeException On failure.
+     */
+    void sample(ProcessResourceSample sample) throws NativeException;
+
+    /**
+     * Closes this sampler and the files it holds open.
+     */
+    void close();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+import java.util.List;
+
+/**
+ * A snapshot of the resource usage of a process and all of its descendants. The totals only include the processes for which a value
+ * is available.
+ */
+public interface ProcessTree {
+    /**
+     * Returns the processes of the tree. The root process is first, and each process is listed before its children.
+     */
+    List<ProcessTreeEntry> getProcesses();
+
+    /**
+     * Returns the total CPU time the processes have spent in user mode, in nanoseconds.
+     */
+    long getUserCpuTime();
+
+    /**
+     * Returns the total CPU time the processes have spent in kernel mode, in nanoseconds.
+     */
+    long getSystemCpuTime();
+
+    /**
+     * Returns the total resident memory of the processes, in bytes. This counts memory shared between the processes more than once.
+     */
+    long getResidentMemory();
+
+    /**
+     * Returns the total proportional set size of the processes, in bytes.
+     */
+    long getProportionalMemory();
+
+    /**
+     * Returns the total number of bytes the processes have caused to be read from storage.
+     */
+    long getReadBytes();
+
+    /**
+     * Returns the total number of bytes the processes have caused to be written to storage.
+     */
+    long getWrittenBytes();
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform;
+
+/**
+ * The resource usage of a single process of a {@link ProcessTree}. Values that are not available are reported as -1.
+ */
+public interface ProcessTreeEntry {
+    /**
+     * Returns the process identifier.
+     */
+    int getPid();
+
+    /**
+     * Returns the process identifier of the parent.
+     */
+    int getParentPid();
+
+    /**
+     * Returns the CPU time the process has spent in user mode, in nanoseconds.
+     */
+    long getUserCpuTime();
+
+    /**
+     * Returns the CPU time the process has spent in kernel mode, in nanoseconds.
+     */
+    long getSystemCpuTime();
+
+    /**
+     * Returns the resident memory of the process, in bytes.
+     */
+    long getResidentMemory();
+
+    /**
+     * Returns the proportional set size of the process, in bytes. This divides memory shared with other processes between the
+     * processes that share it, so it can be summed over processes. Only available for processes the caller is allowed to trace.
+     */
+    long getProportionalMemory();
+
+    /**
+     * Returns the number of bytes the process has caused to be read from storage. Only available for processes the caller is allowed to
+     * trace.
+     */
+    long getReadBytes();
+
+    /**
+     * Returns the number of bytes the process has caused to be written to storage. Only available for processes the caller is allowed to
+     * trace.
+     */
+    long getWrittenBytes();
+}
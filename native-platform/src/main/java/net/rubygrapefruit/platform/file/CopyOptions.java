@@ -0,0 +1,50 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * Options to control the copying of files.
+ */
+public class CopyOptions {
+    private boolean preserveMode;
+    private boolean preserveLastModifiedTime;
+
+    /**
+     * Specifies whether to copy the mode of the source file to the target file. When false, the target file is created
+     * with the default mode. Defaults to false.
+     */
+    public CopyOptions preserveMode(boolean preserveMode) {
+        this.preserveMode = preserveMode;
+        return this;
+    }
+
+    /**
+     * Specifies whether to copy the last modified time of the source file to the target file. Defaults to false.
+     */
+    public CopyOptions preserveLastModifiedTime(boolean preserveLastModifiedTime) {
+        this.preserveLastModifiedTime = preserveLastModifiedTime;
+        return this;
+    }
+
+    public boolean isPreserveMode() {
+        return preserveMode;
+    }
+
+    public boolean isPreserveLastModifiedTime() {
+        return preserveLastModifiedTime;
+    }
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * The outcome of copying a list of files, as returned by {@link PosixFiles#copy(java.util.List, java.util.List, CopyOptions)}.
+ */
+public interface CopyResults {
+    /**
+     * Returns the number of files.
+     */
+    int size();
+
+    /**
+     * Returns the most expensive strategy used to copy the given file.
+     */
+    CopyStrategy getStrategy(int index);
+
+    /**
+     * Returns the errno value of the failure to copy the given file, or 0 when the file was copied successfully.
+     */
+    int getErrorCode(int index);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * The mechanism used to copy a file, from cheapest to most expensive.
+ */
+public enum CopyStrategy {
+    // Order is significant here, see posix_copy.cpp
+
+    /**
+     * The target shares the data of the source, which is copied lazily when either file is modified. Requires a file system that supports reflinks, such as btrfs or xfs.
+     */
+    Clone,
+
+    /**
+     * The data was copied within the kernel using {@code copy_file_range()}, which some file systems can offload.
+     */
+    CopyFileRange,
+
+    /**
+     * The data was copied within the kernel using {@code sendfile()}.
+     */
+    SendFile,
+
+    /**
+     * The data was copied by reading it into a buffer and writing it out again.
+     */
+    ReadWrite
+}
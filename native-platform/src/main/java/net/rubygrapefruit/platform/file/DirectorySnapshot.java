@@ -0,0 +1,82 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+import java.nio.ByteBuffer;
+
+/**
+ * An immutable snapshot of the entries of a directory or a file tree, which can be compared with another snapshot
+ * using {@link PosixFiles#diff(DirectorySnapshot, DirectorySnapshot)}.
+ *
+ * <p>A snapshot is stored in a direct buffer, using native byte order, with the following layout:</p>
+ *
+ * <ul>
+ * <li>The number of entries, as an int.</li>
+ * <li>For each entry: the type as an int (the ordinal of {@link FileInfo.Type}), the length of the path in bytes as an int,
+ * the size as a long, the last modified time as a long, and then the bytes of the path.</li>
+ * </ul>
+ *
+ * <p>The entries are sorted by path, comparing the bytes of the paths as unsigned values. Paths are encoded using the
+ * encoding the JVM uses for file names. Entries are not padded.</p>
+ */
+@ThreadSafe
+public interface DirectorySnapshot {
+    /**
+     * Returns the number of entries in this snapshot.
+     */
+    int size();
+
+    /**
+     * Returns the path of the given entry.
+     */
+    String getPath(int index);
+
+    /**
+     * Returns the type of the given entry.
+     */
+    FileInfo.Type getType(int index);
+
+    /**
+     * Returns the size of the given entry, in bytes.
+     */
+    long getSize(int index);
+
+    /**
+     * Returns the last modification time of the given entry, in ms since epoch.
+     */
+    long getLastModifiedTime(int index);
+
+    /**
+     * Returns a read-only view of the contents of this snapshot, for example to store it. The snapshot can be recreated
+     * from these contents using {@link PosixFiles#loadSnapshot(ByteBuffer)}.
+     */
+    ByteBuffer getContents();
+
+    /**
+     * Collects entries into a snapshot. The entries can be added in any order, but each path can only be added once.
+     */
+    interface Builder {
+        Builder add(String path, FileInfo.Type type, long size, long lastModifiedTime);
+
+        /**
+         * @throws IllegalArgumentException When a path was added more than once.
+         */
+        DirectorySnapshot build();
+    }
+}
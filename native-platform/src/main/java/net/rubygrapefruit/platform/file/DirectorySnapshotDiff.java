@@ -0,0 +1,39 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import java.util.List;
+
+/**
+ * The differences between two {@link DirectorySnapshot}s.
+ */
+public interface DirectorySnapshotDiff {
+    /**
+     * Returns the paths of the entries present in the current snapshot only, sorted by path.
+     */
+    List<String> getAdded();
+
+    /**
+     * Returns the paths of the entries present in the previous snapshot only, sorted by path.
+     */
+    List<String> getRemoved();
+
+    /**
+     * Returns the paths of the entries present in both snapshots whose type, size or last modification time has changed, sorted by path.
+     */
+    List<String> getModified();
+}
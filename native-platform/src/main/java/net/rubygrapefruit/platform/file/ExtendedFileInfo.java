@@ -0,0 +1,68 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+/**
+ * Provides extended information about a file on a Posix file system. This is a snapshot and does not change.
+ *
+ * <p>A snapshot can be fetched using {@link PosixFiles#stat(java.io.File, boolean, java.util.Set, boolean)}. Only the fields
+ * that were requested are guaranteed to be available, use {@link #isAvailable(StatField)} to check. An unavailable field is reported as 0.</p>
+ */
+@ThreadSafe
+public interface ExtendedFileInfo extends PosixFileInfo {
+    /**
+     * Returns true when the given field was provided by the file system.
+     */
+    boolean isAvailable(StatField field);
+
+    /**
+     * Returns the ID of the device that contains this file.
+     */
+    long getDevice();
+
+    /**
+     * Returns the inode number of this file.
+     */
+    long getInode();
+
+    /**
+     * Returns the number of hard links to this file.
+     */
+    long getLinkCount();
+
+    /**
+     * Returns the last access time of this file, in ns since epoch.
+     */
+    long getLastAccessTimeNanos();
+
+    /**
+     * Returns the last modification time of this file, in ns since epoch.
+     */
+    long getLastModifiedTimeNanos();
+
+    /**
+     * Returns the last status change time of this file, in ns since epoch.
+     */
+    long getChangeTimeNanos();
+
+    /**
+     * Returns the creation time of this file, in ns since epoch. This is not available on all platforms and file systems.
+     */
+    long getCreationTimeNanos();
+}
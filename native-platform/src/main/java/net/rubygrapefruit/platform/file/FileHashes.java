@@ -0,0 +1,47 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * The hashes of the contents of a list of files, as returned by {@link PosixFiles#hash(java.util.List, HashAlgorithm)}.
+ */
+public interface FileHashes {
+    /**
+     * Returns the algorithm used to calculate the hashes.
+     */
+    HashAlgorithm getAlgorithm();
+
+    /**
+     * Returns the number of files.
+     */
+    int size();
+
+    /**
+     * Returns the digest of the given file. The digest consists of zeros when the file could not be read.
+     */
+    byte[] getHash(int index);
+
+    /**
+     * Returns the errno value of the failure to read the given file, or 0 when the file was read successfully.
+     */
+    int getErrorCode(int index);
+
+    /**
+     * Returns the digests of all files, packed one after the other in the order of the files. Each digest is {@link HashAlgorithm#getDigestLength()} bytes long.
+     */
+    byte[] getHashes();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+/**
+ * The capacity of a file system. This is a snapshot view and does not change. Values that are not available are reported as -1.
+ */
+@ThreadSafe
+public interface FileSystemCapacity {
+    /**
+     * Returns the size of the file system, in bytes.
+     */
+    long getTotalBytes();
+
+    /**
+     * Returns the number of free bytes, including those reserved for privileged users.
+     */
+    long getFreeBytes();
+
+    /**
+     * Returns the number of bytes available to unprivileged users.
+     */
+    long getAvailableBytes();
+
+    /**
+     * Returns the number of inodes of the file system. Not available on Windows. Some file systems allocate inodes dynamically and
+     * report 0.
+     */
+    long getTotalInodes();
+
+    /**
+     * Returns the number of free inodes, including those reserved for privileged users. Not available on Windows.
+     */
+    long getFreeInodes();
+
+    /**
+     * Returns the number of inodes available to unprivileged users. Not available on Windows.
+     */
+    long getAvailableInodes();
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ResourceClosedException;
+import net.rubygrapefruit.platform.ThreadSafe;
+
+import java.io.File;
+
+/**
+ * Samples the capacity of a fixed set of file systems at a fixed rate from a native thread. Querying the capacity reads the latest sample
+ * from memory shared with the native thread, so it is cheap enough to do before every write.
+ *
+ * <p>To create an instance use {@link FileSystems#startCapacityMonitor(java.util.List, long, java.util.concurrent.TimeUnit)}.</p>
+ */
+@ThreadSafe
+public interface FileSystemCapacityMonitor {
+    /**
+     * Returns the latest sample of the capacity of the file system containing the given file, which must be one of the files this monitor
+     * was started with. All values are -1 when the capacity could not be queried.
+     *
+     * @throws ResourceClosedException When this monitor has been closed.
+     */
+    FileSystemCapacity getCapacity(File file) throws NativeException;
+
+    /**
+     * Stops sampling.
+     */
+    void close();
+}
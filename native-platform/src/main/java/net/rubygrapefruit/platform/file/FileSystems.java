@@ -20,7 +20,10 @@ import net.rubygrapefruit.platform.NativeException;
 import net.rubygrapefruit.platform.NativeIntegration;
 import net.rubygrapefruit.platform.ThreadSafe;
 
+import javax.annotation.Nullable;
+import java.io.File;
 import java.util.List;
+import java.util.concurrent.TimeUnit;
 
 /**
  * Provides access to the file systems of the current machine.
@@ -35,4 +38,33 @@ public interface FileSystems extends NativeIntegration {
      */
     @ThreadSafe
     List<FileSystemInfo> getFileSystems() throws NativeException;
+
+    /**
+     * Returns the file system that contains the given file, which is the file system with the longest mount point that is an ancestor of the file.
+     * The file does not need to exist. Symlinks in the path of the file are resolved, so the file system that contains the target of a symlink
+     * is returned.
+     *
+     * @return The file system, or null when no file system contains the file.
+     * @throws NativeException On failure.
+     */
+    @ThreadSafe
+    @Nullable
+    FileSystemInfo fileSystemFor(File file) throws NativeException;
+
+    /**
+     * Queries the capacity of the file system that contains the given file, which must exist.
+     *
+     * @throws NativeException On failure.
+     */
+    @ThreadSafe
+    FileSystemCapacity getCapacity(File file) throws NativeException;
+
+    /**
+     * Starts a native thread that samples the capacity of the file systems containing the given files at the given interval, so that the
+     * capacity can be checked frequently without a system call each time. The monitor should be closed when no longer required.
+     *
+     * @throws NativeException On failure, or on Windows, where this is not supported.
+     */
+    @ThreadSafe
+    FileSystemCapacityMonitor startCapacityMonitor(List<File> files, long interval, TimeUnit unit) throws NativeException;
 }
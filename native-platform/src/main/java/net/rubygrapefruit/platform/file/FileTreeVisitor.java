@@ -0,0 +1,32 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * Receives the entries of a file tree, as visited by {@link PosixFiles#walk(java.io.File, WalkOptions, FileTreeVisitor)}.
+ */
+public interface FileTreeVisitor {
+    /**
+     * Called for each entry of the file tree, except the root. Entries are visited in no particular order, but all calls are made from the thread that started the walk.
+     *
+     * @param relativePath The path of the entry relative to the root, using '/' as separator.
+     * @param type The type of the entry.
+     * @param size The size of the entry, in bytes. 0 when the entry is not a regular file.
+     * @param lastModifiedTime The last modification time of the entry, in ms since epoch.
+     */
+    void visitEntry(String relativePath, FileInfo.Type type, long size, long lastModifiedTime);
+}
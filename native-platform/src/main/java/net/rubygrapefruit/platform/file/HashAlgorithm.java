@@ -0,0 +1,52 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * The algorithms that can be used to hash the contents of files.
+ */
+public enum HashAlgorithm {
+    // Order is significant here, see hashing.h
+
+    /**
+     * XXH3, 64 bit variant. A fast non-cryptographic hash.
+     */
+    Xxh3(8),
+
+    /**
+     * SHA-256.
+     */
+    Sha256(32),
+
+    /**
+     * BLAKE3, with 256 bit output. A cryptographic hash that is considerably faster than SHA-256.
+     */
+    Blake3(32);
+
+    private final int digestLength;
+
+    HashAlgorithm(int digestLength) {
+        this.digestLength = digestLength;
+    }
+
+    /**
+     * Returns the length of the digests produced by this algorithm, in bytes.
+     */
+    public int getDigestLength() {
+        return digestLength;
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+/**
+ * Provides details about a mounted file system on Linux, as reported by {@code /proc/self/mountinfo}.
+ */
+@ThreadSafe
+public interface LinuxFileSystemInfo extends FileSystemInfo {
+    /**
+     * Returns the unique id of this mount.
+     */
+    int getMountId();
+
+    /**
+     * Returns the id of the parent mount, or of this mount for the root of the mount tree.
+     */
+    int getParentMountId();
+
+    /**
+     * Returns the major number of the device that holds this file system.
+     */
+    int getDeviceMajor();
+
+    /**
+     * Returns the minor number of the device that holds this file system.
+     */
+    int getDeviceMinor();
+
+    /**
+     * Returns the directory within the file system that is mounted, which is {@code "/"} except for bind mounts.
+     */
+    String getRoot();
+
+    /**
+     * Returns the per-mount options, such as {@code "rw,noatime"}.
+     */
+    String getMountOptions();
+
+    /**
+     * Returns the propagation fields of this mount separated by spaces, such as {@code "shared:1 master:2"}, or an empty string for a private mount.
+     */
+    String getPropagation();
+
+    /**
+     * Returns the per-file system options, which apply to all mounts of this file system.
+     */
+    String getSuperOptions();
+}
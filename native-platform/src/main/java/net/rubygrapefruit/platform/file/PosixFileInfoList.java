@@ -0,0 +1,39 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+import java.util.List;
+
+/**
+ * Provides information about a list of files on a Posix file system. This is a snapshot and does not change.
+ *
+ * <p>A snapshot can be fetched using {@link PosixFiles#stat(List, boolean)}. The entries are in the same order as the
+ * files that were queried.</p>
+ *
+ * <p>A failure to query a file does not fail the whole query. Instead, the entry for the file is reported with type
+ * {@link FileInfo.Type#Missing} and a non-zero error code.</p>
+ */
+@ThreadSafe
+public interface PosixFileInfoList extends List<PosixFileInfo> {
+    /**
+     * Returns the system error code (errno) of querying the file at the given index, or 0 when the file was queried
+     * successfully. A file that does not exist is not an error.
+     */
+    int getErrorCode(int index);
+}
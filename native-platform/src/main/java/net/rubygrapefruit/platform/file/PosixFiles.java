@@ -21,6 +21,9 @@ import net.rubygrapefruit.platform.NativeIntegration;
 import net.rubygrapefruit.platform.ThreadSafe;
 
 import java.io.File;
+import java.nio.ByteBuffer;
+import java.util.List;
+import java.util.Set;
 
 /**
  * Functions to query and modify files on a Posix file system.
@@ -59,6 +62,83 @@ public interface PosixFiles extends Files, NativeIntegration {
     @ThreadSafe
     String readLink(File link) throws NativeException;
 
+    /**
+     * Hashes the contents of each of the given files. The files are read and hashed in a single native call using several
+     * native threads, without copying their contents to the Java heap.
+     *
+     * <p>A failure to read one of the files is reported by {@link FileHashes#getErrorCode(int)}, rather than by throwing an exception.</p>
+     *
+     * @param files The files to hash.
+     * @param algorithm The hash algorithm to use.
+     * @return The hashes of the files, in the same order as the given files.
+     * @throws NativeException On failure to hash the files as a whole.
+     */
+    @ThreadSafe
+    FileHashes hash(List<File> files, HashAlgorithm algorithm) throws NativeException;
+
+    /**
+     * Copies a regular file, using the cheapest mechanism supported by the platform and file systems. Tries a reflink clone first,
+     * then {@code copy_file_range()}, then {@code sendfile()} and finally reads and writes the data. Holes in a sparse source file are preserved.
+     * Replaces the target file if it exists.
+     *
+     * @return The most expensive strategy used to copy the file.
+     * @throws NativeException On failure.
+     */
+    @ThreadSafe
+    CopyStrategy copy(File source, File target, CopyOptions options) throws NativeException;
+
+    /**
+     * Copies each of the given source files to the corresponding target file, as for {@link #copy(File, File, CopyOptions)}.
+     * The files are copied in a single native call using several native threads.
+     *
+     * <p>A failure to copy one of the files is reported by {@link CopyResults#getErrorCode(int)}, rather than by throwing an exception.</p>
+     *
+     * @throws NativeException On failure to copy the files as a whole.
+     */
+    @ThreadSafe
+    CopyResults copy(List<File> sources, List<File> targets, CopyOptions options) throws NativeException;
+
+    /**
+     * Asks the operating system to start reading the contents of the given files into the page cache, in preparation for reading them soon.
+     * The files are opened and hinted by background native threads, and this method returns without waiting for the reads to start or complete.
+     *
+     * <p>This is a hint only. Files that cannot be opened, such as missing files, are ignored, as are platforms that do not support it.
+     * Uses {@code posix_fadvise(POSIX_FADV_WILLNEED)}, or {@code F_RDADVISE} on macOS.</p>
+     *
+     * @throws NativeException On failure to start the background threads.
+     */
+    @ThreadSafe
+    void prefetch(List<File> files) throws NativeException;
+
+    /**
+     * Tells the operating system that the contents of the given files will not be read again soon, so that their clean pages can be dropped from
+     * the page cache. This avoids one-off reads of many files pushing more useful data out of the cache. The files are hinted by background
+     * native threads, and this method returns without waiting.
+     *
+     * <p>This is a hint only. Files that cannot be opened are ignored, as are platforms that do not support it, including macOS. Uses
+     * {@code posix_fadvise(POSIX_FADV_DONTNEED)}.</p>
+     *
+     * @throws NativeException On failure to start the background threads.
+     */
+    @ThreadSafe
+    void evict(List<File> files) throws NativeException;
+
+    /**
+     * Lists the names and types of the entries of the given directory. This is cheaper than {@link #listDir(File, boolean)},
+     * as the type of most entries is provided by the directory itself and the entries do not need to be queried one by one.
+     *
+     * <p>The returned entries do not carry a size or last modified time, both are reported as 0.</p>
+     *
+     * @param dir The path of the directory to list. Follows symlinks to this directory.
+     * @param linkTarget When true and a directory entry is a symlink, return the type of the target of the symlink instead of the symlink itself.
+     * @throws NativeException On failure.
+     * @throws NoSuchFileException When the specified directory does not exist.
+     * @throws NotADirectoryException When the specified file is not a directory.
+     * @throws FilePermissionException When the user has insufficient permissions to list the entries
+     */
+    @ThreadSafe
+    List<? extends DirEntry> listDirTypes(File dir, boolean linkTarget) throws NativeException;
+
     /**
      * {@inheritDoc}
      */
@@ -70,4 +150,98 @@ public interface PosixFiles extends Files, NativeIntegration {
      */
     @ThreadSafe
     PosixFileInfo stat(File file, boolean linkTarget) throws NativeException;
+
+    /**
+     * Returns extended information about the given file, such as its inode, link count and timestamps with nanosecond precision.
+     *
+     * <p>Only the requested fields are queried where the platform supports this, which can be cheaper on some file systems.
+     * Other fields may be provided as well. Uses {@code statx()} on Linux, falling back to {@code stat()} on kernels that do not support it.</p>
+     *
+     * @param file The path of the file to get details of. Follows symlinks to the parent directory of this file.
+     * @param linkTarget When true and the file is a symlink, return details of the target of the symlink instead of details of the symlink itself.
+     * @param fields The fields to query. The type of the file is always queried.
+     * @param allowStale When true, allows a network file system to return cached attributes rather than synchronizing with the server.
+     * @return Details of the file. Returns details with type {@link FileInfo.Type#Missing} for a file that does not exist.
+     * @throws NativeException On failure.
+     * @throws FilePermissionException When the user has insufficient permissions to query the file.
+     */
+    @ThreadSafe
+    ExtendedFileInfo stat(File file, boolean linkTarget, Set<StatField> fields, boolean allowStale) throws NativeException;
+
+    /**
+     * Returns basic information about each of the given files. This is more efficient than querying the files
+     * one by one, as the files are queried in a single native call using several native threads.
+     *
+     * <p>A failure to query one of the files is reported by {@link PosixFileInfoList#getErrorCode(int)}, rather than
+     * by throwing an exception.</p>
+     *
+     * @param files The paths of the files to get details of. Follows symlinks to the parent directory of each file.
+     * @param linkTarget When true and a file is a symlink, return details of the target of the symlink instead of details of the symlink itself.
+     * @return Details of the files, in the same order as the given files.
+     * @throws NativeException On failure to query the files as a whole.
+     */
+    @ThreadSafe
+    PosixFileInfoList stat(List<File> files, boolean linkTarget) throws NativeException;
+
+    /**
+     * Creates a holder for the details of a file, which can be passed to {@link #stat(File, boolean, ReusablePosixFileInfo)} many times.
+     */
+    @ThreadSafe
+    ReusablePosixFileInfo newFileInfo();
+
+    /**
+     * Queries basic information about the given file into the given holder, replacing its previous contents. Unlike
+     * {@link #stat(File, boolean)}, this method does not allocate and does not throw an exception on failure, which makes it
+     * suitable for querying many files in a tight loop.
+     *
+     * @param file The path of the file to get details of. Follows symlinks to the parent directory of this file.
+     * @param linkTarget When true and the file is a symlink, return details of the target of the symlink instead of details of the symlink itself.
+     * @param info The holder to query into, created by {@link #newFileInfo()}.
+     * @return 0 on success, including when the file does not exist, in which case the type is {@link FileInfo.Type#Missing}. Otherwise, the error
+     * code (errno) of the failure, in which case the other details are undefined.
+     */
+    @ThreadSafe
+    int stat(File file, boolean linkTarget, ReusablePosixFileInfo info);
+
+    /**
+     * Walks the file tree with the given root, reporting each entry to the given visitor. The directories of the tree are listed
+     * in parallel by several native threads. The visitor is called from the calling thread only.
+     *
+     * <p>Directories that cannot be listed, for example because of insufficient permissions, are skipped.</p>
+     *
+     * @param root The root directory of the tree. Follows symlinks to this directory.
+     * @param options The options to control the walk.
+     * @param visitor The visitor to receive the entries of the tree. An exception thrown by the visitor stops the walk and is rethrown.
+     * @throws NativeException On failure.
+     * @throws NoSuchFileException When the root directory does not exist.
+     * @throws NotADirectoryException When the root is not a directory.
+     * @throws FilePermissionException When the user has insufficient permissions to list the root directory.
+     */
+    @ThreadSafe
+    void walk(File root, WalkOptions options, FileTreeVisitor visitor) throws NativeException;
+
+    /**
+     * Creates a builder for a {@link DirectorySnapshot}.
+     */
+    @ThreadSafe
+    DirectorySnapshot.Builder newSnapshotBuilder();
+
+    /**
+     * Recreates a snapshot from its contents, as returned by {@link DirectorySnapshot#getContents()} or produced by other means
+     * using the layout documented on {@link DirectorySnapshot}. The snapshot is backed by the given buffer, from its position to its limit.
+     *
+     * @param contents The contents of the snapshot. Must be a direct buffer.
+     * @throws NativeException When the buffer is not a direct buffer or is truncated.
+     */
+    @ThreadSafe
+    DirectorySnapshot loadSnapshot(ByteBuffer contents) throws NativeException;
+
+    /**
+     * Compares two snapshots, returning the added, removed and modified entries. The comparison is made natively on the
+     * contents of the snapshots, and several native threads are used for large snapshots.
+     *
+     * @throws NativeException On failure, for example when a snapshot is malformed.
+     */
+    @ThreadSafe
+    DirectorySnapshotDiff diff(DirectorySnapshot previous, DirectorySnapshot current) throws NativeException;
 }
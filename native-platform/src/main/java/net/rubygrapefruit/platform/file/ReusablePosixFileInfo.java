@@ -0,0 +1,30 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+/**
+ * Details of a file that are replaced in place by each call to {@link PosixFiles#stat(File, boolean, ReusablePosixFileInfo)}, so that
+ * many files can be queried without allocating. Create instances using {@link PosixFiles#newFileInfo()}.
+ *
+ * <p>Instances are not thread safe. Each thread should use its own instance.</p>
+ */
+public interface ReusablePosixFileInfo extends PosixFileInfo {
+    /**
+     * Returns the error code (errno) of the most recent query, or 0 when it succeeded.
+     */
+    int getErrorCode();
+}
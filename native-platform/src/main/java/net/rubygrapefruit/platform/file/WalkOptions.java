@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.file;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+
+/**
+ * Options to control a walk of a file tree.
+ */
+public class WalkOptions {
+    private int maxDepth = -1;
+    private boolean followLinks;
+    private final List<String> excludes = new ArrayList<String>();
+
+    /**
+     * Limits the walk to the given depth. The entries of the root directory have depth 1. A negative value means no limit, which is the default.
+     */
+    public WalkOptions withMaxDepth(int maxDepth) {
+        this.maxDepth = maxDepth;
+        return this;
+    }
+
+    /**
+     * Specifies whether to follow symlinks. When true, the target of a symlink is reported instead of the symlink itself, and symlinks to directories are walked into.
+     * Each directory is visited at most once, so that cycles are not followed. Defaults to false.
+     */
+    public WalkOptions followLinks(boolean followLinks) {
+        this.followLinks = followLinks;
+        return this;
+    }
+
+    /**
+     * Excludes the entries whose name matches any of the given glob patterns, as used by the shell. Excluded directories are not walked into.
+     */
+    public WalkOptions exclude(String... patterns) {
+        Collections.addAll(excludes, patterns);
+        return this;
+    }
+
+    public int getMaxDepth() {
+        return maxDepth;
+    }
+
+    public boolean isFollowLinks() {
+        return followLinks;
+    }
+
+    public List<String> getExcludes() {
+        return Collections.unmodifiableList(excludes);
+    }
+}
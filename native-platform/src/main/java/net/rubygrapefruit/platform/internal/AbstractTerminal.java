@@ -17,7 +17,9 @@
 package net.rubygrapefruit.platform.internal;
 
 import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.terminal.TerminalFrameRenderer;
 import net.rubygrapefruit.platform.terminal.TerminalOutput;
+import net.rubygrapefruit.platform.terminal.TerminalSizeListener;
 import net.rubygrapefruit.platform.terminal.Terminals;
 
 import java.io.FileDescriptor;
@@ -30,6 +32,24 @@ public abstract class AbstractTerminal implements TerminalOutput {
 
     protected abstract void init();
 
+    /**
+     * Returns a terminal that writes the same control sequences as this terminal to the given stream, or null when this terminal is not
+     * controlled through its output stream.
+     */
+    protected AbstractTerminal redirectTo(OutputStream outputStream) {
+        return null;
+    }
+
+    public TerminalFrameRenderer newFrameRenderer() {
+        return new DefaultTerminalFrameRenderer(this);
+    }
+
+    public void addSizeListener(TerminalSizeListener listener) throws NativeException {
+    }
+
+    public void removeSizeListener(TerminalSizeListener listener) {
+    }
+
     protected static OutputStream streamForOutput(Terminals.Output output) {
         return output == Terminals.Output.Stdout ? new FileOutputStream(FileDescriptor.out) : new FileOutputStream(FileDescriptor.err);
     }
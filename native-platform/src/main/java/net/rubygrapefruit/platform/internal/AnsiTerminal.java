@@ -70,6 +70,11 @@ public class AnsiTerminal extends AbstractTerminal {
     protected void init() {
     }
 
+    @Override
+    protected AbstractTerminal redirectTo(OutputStream outputStream) {
+        return new AnsiTerminal(outputStream, output);
+    }
+
     public boolean supportsTextAttributes() {
         return true;
     }
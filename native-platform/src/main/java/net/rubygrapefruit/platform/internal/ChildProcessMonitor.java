@@ -0,0 +1,122 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.internal.jni.PosixProcessFunctions;
+
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Reaps the children started by {@link PosixProcessLauncher} using a single thread, which waits for the pidfds of all children in one epoll
+ * instance, rather than using a thread per child.
+ */
+class ChildProcessMonitor implements Runnable {
+    // Record layout, order is important - see posix.cpp
+    private static final int PID = 0;
+    private static final int EXIT_VALUE = 1;
+    private static final int USER_TIME = 2;
+    private static final int SYSTEM_TIME = 3;
+    private static final int MAX_RESIDENT = 4;
+    private static final int RECORD_SIZE = 5;
+
+    private static final int BATCH_SIZE = 64;
+
+    private final Map<Integer, SpawnedProcess> processes = new ConcurrentHashMap<Integer, SpawnedProcess>();
+    private final Object startLock = new Object();
+    private int monitorFd = -1;
+    // Set once waiting has failed, after which children are reaped by their callers
+    private boolean failed;
+
+    /**
+     * Starts watching the given child. Returns false when the child cannot be watched, in which case it should be reaped by the caller.
+     * Once watching, the monitor may still give up on the child by calling {@link SpawnedProcess#unmonitored()}.
+     */
+    boolean watch(SpawnedProcess process, int pid, int pidfd) {
+        int fd;
+        synchronized (startLock) {
+            if (failed) {
+                return false;
+            }
+            if (monitorFd < 0) {
+                FunctionResult result = new FunctionResult();
+                int newFd = PosixProcessFunctions.openChildMonitor(result);
+                if (result.isFailed()) {
+                    return false;
+                }
+                monitorFd = newFd;
+                Thread thread = new Thread(this, "native-platform child process monitor");
+                thread.setDaemon(true);
+                thread.start();
+            }
+            fd = monitorFd;
+            // Register while holding the lock, so that a failure of the monitor thread cannot miss the child
+            processes.put(pid, process);
+        }
+        FunctionResult result = new FunctionResult();
+        PosixProcessFunctions.watchChild(fd, pid, pidfd, result);
+        if (result.isFailed()) {
+            processes.remove(pid);
+            return false;
+        }
+        return true;
+    }
+
+    public void run() {
+        int fd;
+        synchronized (startLock) {
+            fd = monitorFd;
+        }
+        long[] records = new long[BATCH_SIZE * RECORD_SIZE];
+        while (true) {
+            FunctionResult result = new FunctionResult();
+            int count = PosixProcessFunctions.waitForChildren(fd, records, result);
+            if (result.isFailed()) {
+                giveUp();
+                return;
+            }
+            for (int i = 0; i < count; i++) {
+                int offset = i * RECORD_SIZE;
+                SpawnedProcess process = processes.remove((int) records[offset + PID]);
+                if (process == null) {
+                    continue;
+                }
+                DefaultChildProcessUsage usage = null;
+                if (records[offset + USER_TIME] >= 0) {
+                    usage = new DefaultChildProcessUsage(records[offset + USER_TIME], records[offset + SYSTEM_TIME], records[offset + MAX_RESIDENT]);
+                }
+                process.exited((int) records[offset + EXIT_VALUE], usage);
+            }
+        }
+    }
+
+    /**
+     * Stops watching all children after a failure to wait for them, so that they are reaped by their callers instead. Otherwise, nothing
+     * would report their exit and anything waiting for them would block forever.
+     */
+    private void giveUp() {
+        synchronized (startLock) {
+            failed = true;
+        }
+        for (Integer pid : processes.keySet()) {
+            SpawnedProcess process = processes.remove(pid);
+            if (process != null) {
+                process.unmonitored();
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.CopyOptions;
+import net.rubygrapefruit.platform.file.CopyResults;
+import net.rubygrapefruit.platform.file.CopyStrategy;
+
+public class CopyResultList implements CopyResults {
+    // Flags, order is important - see posix_copy.cpp
+    private static final int PRESERVE_MODE = 1;
+    private static final int PRESERVE_LAST_MODIFIED = 2;
+
+    private final int[] strategies;
+    private final int[] errors;
+
+    public CopyResultList(int count) {
+        this.strategies = new int[count];
+        this.errors = new int[count];
+    }
+
+    public static int toFlags(CopyOptions options) {
+        int flags = 0;
+        if (options.isPreserveMode()) {
+            flags |= PRESERVE_MODE;
+        }
+        if (options.isPreserveLastModifiedTime()) {
+            flags |= PRESERVE_LAST_MODIFIED;
+        }
+        return flags;
+    }
+
+    public int[] getStrategies() {
+        return strategies;
+    }
+
+    public int[] getErrors() {
+        return errors;
+    }
+
+    public int size() {
+        return errors.length;
+    }
+
+    public CopyStrategy getStrategy(int index) {
+        checkIndex(index);
+        return CopyStrategy.values()[strategies[index]];
+    }
+
+    public int getErrorCode(int index) {
+        checkIndex(index);
+        return errors[index];
+    }
+
+    private void checkIndex(int index) {
+        if (index < 0 || index >= errors.length) {
+            throw new IndexOutOfBoundsException(String.format("Index: %s, Size: %s", index, errors.length));
+        }
+    }
+}
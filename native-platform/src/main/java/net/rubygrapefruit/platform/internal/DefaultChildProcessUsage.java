@@ -0,0 +1,43 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.ChildProcessUsage;
+
+public class DefaultChildProcessUsage implements ChildProcessUsage {
+    private final long userCpuTime;
+    private final long systemCpuTime;
+    private final long maxResidentMemory;
+
+    public DefaultChildProcessUsage(long userCpuTime, long systemCpuTime, long maxResidentMemory) {
+        this.userCpuTime = userCpuTime;
+        this.systemCpuTime = systemCpuTime;
+        this.maxResidentMemory = maxResidentMemory;
+    }
+
+    public long getUserCpuTime() {
+        return userCpuTime;
+    }
+
+    public long getSystemCpuTime() {
+        return systemCpuTime;
+    }
+
+    public long getMaxResidentMemory() {
+        return maxResidentMemory;
+    }
+}
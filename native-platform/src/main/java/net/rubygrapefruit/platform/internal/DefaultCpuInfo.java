@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.CpuInfo;
+
+public class DefaultCpuInfo implements CpuInfo {
+    // Record layout, order is important - see linux_cpu.cpp
+    private static final int ONLINE_PROCESSORS = 0;
+    private static final int AVAILABLE_PROCESSORS = 1;
+    private static final int CORES = 2;
+    private static final int PACKAGES = 3;
+    private static final int NUMA_NODES = 4;
+    private static final int CGROUP_QUOTA = 5;
+    private static final int CGROUP_PERIOD = 6;
+    private static final int RECORD_SIZE = 7;
+
+    // Threads per processor for pools that mostly wait on I/O
+    private static final int IO_BOUND_FACTOR = 4;
+
+    private final long[] record = new long[RECORD_SIZE];
+
+    public long[] getRecord() {
+        return record;
+    }
+
+    public int getOnlineProcessorCount() {
+        return (int) record[ONLINE_PROCESSORS];
+    }
+
+    public int getAvailableProcessorCount() {
+        return (int) record[AVAILABLE_PROCESSORS];
+    }
+
+    public int getCoreCount() {
+        return (int) record[CORES];
+    }
+
+    public int getPackageCount() {
+        return (int) record[PACKAGES];
+    }
+
+    public int getNumaNodeCount() {
+        return (int) record[NUMA_NODES];
+    }
+
+    public long getCgroupCpuQuota() {
+        return record[CGROUP_QUOTA];
+    }
+
+    public long getCgroupCpuPeriod() {
+        return record[CGROUP_PERIOD];
+    }
+
+    public double getCgroupCpuLimit() {
+        if (record[CGROUP_QUOTA] < 0) {
+            return -1;
+        }
+        return (double) record[CGROUP_QUOTA] / record[CGROUP_PERIOD];
+    }
+
+    public double getEffectiveProcessorCount() {
+        double count = record[AVAILABLE_PROCESSORS];
+        if (record[CGROUP_QUOTA] >= 0) {
+            count = Math.min(count, getCgroupCpuLimit());
+        }
+        return count;
+    }
+
+    public int getRecommendedCpuBoundParallelism() {
+        return Math.max(1, (int) Math.ceil(getEffectiveProcessorCount()));
+    }
+
+    public int getRecommendedIoBoundParallelism() {
+        return getRecommendedCpuBoundParallelism() * IO_BOUND_FACTOR;
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.DirectorySnapshot;
+import net.rubygrapefruit.platform.file.DirectorySnapshotDiff;
+
+import java.util.ArrayList;
+import java.util.List;
+
+public class DefaultDirectorySnapshotDiff implements DirectorySnapshotDiff {
+    // Kinds of change, order is important - see posix_snapshot.cpp
+    public static final int ADDED = 0;
+    public static final int REMOVED = 1;
+    public static final int MODIFIED = 2;
+
+    private final List<String> added = new ArrayList<String>();
+    private final List<String> removed = new ArrayList<String>();
+    private final List<String> modified = new ArrayList<String>();
+
+    /**
+     * @param changes The changes, as pairs of kind and entry index. The index refers to the previous snapshot for removed entries, and to the current snapshot otherwise.
+     */
+    public DefaultDirectorySnapshotDiff(DirectorySnapshot previous, DirectorySnapshot current, int[] changes, int count) {
+        for (int i = 0; i < count; i++) {
+            int kind = changes[2 * i];
+            int index = changes[2 * i + 1];
+            switch (kind) {
+                case ADDED:
+                    added.add(current.getPath(index));
+                    break;
+                case REMOVED:
+                    removed.add(previous.getPath(index));
+                    break;
+                default:
+                    modified.add(current.getPath(index));
+            }
+        }
+    }
+
+    public List<String> getAdded() {
+        return added;
+    }
+
+    public List<String> getRemoved() {
+        return removed;
+    }
+
+    public List<String> getModified() {
+        return modified;
+    }
+}
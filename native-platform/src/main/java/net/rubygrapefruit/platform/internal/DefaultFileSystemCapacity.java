@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.FileSystemCapacity;
+
+public class DefaultFileSystemCapacity implements FileSystemCapacity {
+    // Record layout, order is important - see posix.cpp
+    private static final int TOTAL = 0;
+    private static final int FREE = 1;
+    private static final int AVAILABLE = 2;
+    private static final int TOTAL_INODES = 3;
+    private static final int FREE_INODES = 4;
+    private static final int AVAILABLE_INODES = 5;
+    static final int RECORD_SIZE = 6;
+
+    private final long[] record = new long[RECORD_SIZE];
+
+    public long[] getRecord() {
+        return record;
+    }
+
+    public long getTotalBytes() {
+        return record[TOTAL];
+    }
+
+    public long getFreeBytes() {
+        return record[FREE];
+    }
+
+    public long getAvailableBytes() {
+        return record[AVAILABLE];
+    }
+
+    public long getTotalInodes() {
+        return record[TOTAL_INODES];
+    }
+
+    public long getFreeInodes() {
+        return record[FREE_INODES];
+    }
+
+    public long getAvailableInodes() {
+        return record[AVAILABLE_INODES];
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ResourceClosedException;
+import net.rubygrapefruit.platform.file.FileSystemCapacity;
+import net.rubygrapefruit.platform.file.FileSystemCapacityMonitor;
+import net.rubygrapefruit.platform.internal.jni.PosixFileSystemFunctions;
+
+import java.io.File;
+import java.nio.ByteBuffer;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+public class DefaultFileSystemCapacityMonitor implements FileSystemCapacityMonitor {
+    private final Map<String, Integer> slotIndexes = new HashMap<String, Integer>();
+    private final Object lock = new Object();
+    private ByteBuffer slots;
+
+    public DefaultFileSystemCapacityMonitor(List<File> files, long intervalMillis) {
+        String[] paths = new String[files.size()];
+        for (int i = 0; i < paths.length; i++) {
+            paths[i] = files.get(i).getAbsolutePath();
+            slotIndexes.put(paths[i], i);
+        }
+        FunctionResult result = new FunctionResult();
+        ByteBuffer slots = PosixFileSystemFunctions.startCapacityRefresher(paths, intervalMillis, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not start file system capacity monitor: %s", result.getMessage()));
+        }
+        this.slots = slots;
+    }
+
+    public FileSystemCapacity getCapacity(File file) throws NativeException {
+        Integer index = slotIndexes.get(file.getAbsolutePath());
+        if (index == null) {
+            throw new IllegalArgumentException(String.format("File %s is not monitored.", file));
+        }
+        DefaultFileSystemCapacity capacity = new DefaultFileSystemCapacity();
+        synchronized (lock) {
+            if (slots == null) {
+                throw new ResourceClosedException("This monitor has been closed.");
+            }
+            // The slot is read natively, as reading it consistently requires ordering guarantees that ByteBuffer does not provide
+            PosixFileSystemFunctions.readCapacitySlot(slots, index, capacity.getRecord());
+            return capacity;
+        }
+    }
+
+    public void close() {
+        synchronized (lock) {
+            if (slots != null) {
+                PosixFileSystemFunctions.stopCapacityRefresher(slots);
+                slots = null;
+            }
+        }
+    }
+}
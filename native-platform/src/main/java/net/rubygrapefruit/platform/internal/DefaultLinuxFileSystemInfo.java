@@ -0,0 +1,78 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.CaseSensitivity;
+import net.rubygrapefruit.platform.file.LinuxFileSystemInfo;
+
+import java.io.File;
+
+public class DefaultLinuxFileSystemInfo extends DefaultFileSystemInfo implements LinuxFileSystemInfo {
+    private final int mountId;
+    private final int parentMountId;
+    private final int deviceMajor;
+    private final int deviceMinor;
+    private final String root;
+    private final String mountOptions;
+    private final String propagation;
+    private final String superOptions;
+
+    public DefaultLinuxFileSystemInfo(File mountPoint, String fileSystemType, String deviceName, boolean remote, CaseSensitivity caseSensitivity,
+                                      int mountId, int parentMountId, int deviceMajor, int deviceMinor, String root, String mountOptions, String propagation, String superOptions) {
+        super(mountPoint, fileSystemType, deviceName, remote, caseSensitivity);
+        this.mountId = mountId;
+        this.parentMountId = parentMountId;
+        this.deviceMajor = deviceMajor;
+        this.deviceMinor = deviceMinor;
+        this.root = root;
+        this.mountOptions = mountOptions;
+        this.propagation = propagation;
+        this.superOptions = superOptions;
+    }
+
+    public int getMountId() {
+        return mountId;
+    }
+
+    public int getParentMountId() {
+        return parentMountId;
+    }
+
+    public int getDeviceMajor() {
+        return deviceMajor;
+    }
+
+    public int getDeviceMinor() {
+        return deviceMinor;
+    }
+
+    public String getRoot() {
+        return root;
+    }
+
+    public String getMountOptions() {
+        return mountOptions;
+    }
+
+    public String getPropagation() {
+        return propagation;
+    }
+
+    public String getSuperOptions() {
+        return superOptions;
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.memory.LinuxMemoryInfo;
+
+public class DefaultLinuxMemoryInfo implements LinuxMemoryInfo {
+    // Record layout, order is important - see linux_memory.cpp
+    private static final int TOTAL = 0;
+    private static final int AVAILABLE = 1;
+    private static final int CGROUP_VERSION = 2;
+    private static final int CGROUP_LIMIT = 3;
+    private static final int CGROUP_HIGH = 4;
+    private static final int CGROUP_USAGE = 5;
+    private static final int RECORD_SIZE = 6;
+
+    private final long[] record = new long[RECORD_SIZE];
+
+    public long[] getRecord() {
+        return record;
+    }
+
+    public long getTotalPhysicalMemory() {
+        return record[TOTAL];
+    }
+
+    public long getAvailablePhysicalMemory() {
+        return record[AVAILABLE];
+    }
+
+    public int getCgroupVersion() {
+        return (int) record[CGROUP_VERSION];
+    }
+
+    public long getCgroupMemoryLimit() {
+        return record[CGROUP_LIMIT];
+    }
+
+    public long getCgroupMemoryHigh() {
+        return record[CGROUP_HIGH];
+    }
+
+    public long getCgroupMemoryUsage() {
+        return record[CGROUP_USAGE];
+    }
+
+    public long getEffectiveMemoryLimit() {
+        long limit = record[TOTAL];
+        if (record[CGROUP_LIMIT] >= 0) {
+            limit = Math.min(limit, record[CGROUP_LIMIT]);
+        }
+        if (record[CGROUP_HIGH] >= 0) {
+            limit = Math.min(limit, record[CGROUP_HIGH]);
+        }
+        return limit;
+    }
+
+    public long getEffectiveAvailableMemory() {
+        long available = record[AVAILABLE];
+        if (record[CGROUP_USAGE] >= 0) {
+            available = Math.min(available, Math.max(0, getEffectiveMemoryLimit() - record[CGROUP_USAGE]));
+        }
+        return available;
+    }
+}
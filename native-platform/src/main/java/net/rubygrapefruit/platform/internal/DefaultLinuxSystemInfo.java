@@ -0,0 +1,57 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.CpuInfo;
+import net.rubygrapefruit.platform.LinuxSystemInfo;
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ProcessResourceSampler;
+import net.rubygrapefruit.platform.ProcessTree;
+import net.rubygrapefruit.platform.internal.jni.LinuxCpuFunctions;
+import net.rubygrapefruit.platform.internal.jni.LinuxResourceFunctions;
+
+public class DefaultLinuxSystemInfo extends DefaultSystemInfo implements LinuxSystemInfo {
+    public CpuInfo getCpuInfo() throws NativeException {
+        FunctionResult result = new FunctionResult();
+        DefaultCpuInfo cpuInfo = new DefaultCpuInfo();
+        LinuxCpuFunctions.getCpuInfo(cpuInfo.getRecord(), result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not get CPU info: %s", result.getMessage()));
+        }
+        return cpuInfo;
+    }
+
+    public ProcessResourceSampler openProcessResourceSampler() throws NativeException {
+        return new DefaultProcessResourceSampler();
+    }
+
+    public ProcessTree getProcessTree(int pid) throws NativeException {
+        long[] records = new long[64 * DefaultProcessTree.RECORD_SIZE];
+        while (true) {
+            FunctionResult result = new FunctionResult();
+            int count = LinuxResourceFunctions.getProcessTree(pid, records, result);
+            if (result.isFailed()) {
+                throw new NativeException(String.format("Could not get process tree of process %d: %s", pid, result.getMessage()));
+            }
+            if (count * DefaultProcessTree.RECORD_SIZE <= records.length) {
+                return new DefaultProcessTree(records, count);
+            }
+            // The tree grew while it was walked, so allow some headroom
+            records = new long[(count + count / 2) * DefaultProcessTree.RECORD_SIZE];
+        }
+    }
+}
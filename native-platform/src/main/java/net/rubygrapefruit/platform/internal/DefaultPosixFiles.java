@@ -17,16 +17,35 @@
 package net.rubygrapefruit.platform.internal;
 
 import net.rubygrapefruit.platform.*;
+import net.rubygrapefruit.platform.file.CopyOptions;
+import net.rubygrapefruit.platform.file.CopyResults;
+import net.rubygrapefruit.platform.file.CopyStrategy;
 import net.rubygrapefruit.platform.file.DirEntry;
+import net.rubygrapefruit.platform.file.DirectorySnapshot;
+import net.rubygrapefruit.platform.file.DirectorySnapshotDiff;
+import net.rubygrapefruit.platform.file.ExtendedFileInfo;
+import net.rubygrapefruit.platform.file.FileHashes;
 import net.rubygrapefruit.platform.file.FilePermissionException;
+import net.rubygrapefruit.platform.file.FileTreeVisitor;
+import net.rubygrapefruit.platform.file.HashAlgorithm;
 import net.rubygrapefruit.platform.file.PosixFileInfo;
+import net.rubygrapefruit.platform.file.PosixFileInfoList;
 import net.rubygrapefruit.platform.file.PosixFiles;
+import net.rubygrapefruit.platform.file.ReusablePosixFileInfo;
+import net.rubygrapefruit.platform.file.StatField;
+import net.rubygrapefruit.platform.file.WalkOptions;
 import net.rubygrapefruit.platform.internal.jni.PosixFileFunctions;
 
 import java.io.File;
+import java.nio.ByteBuffer;
 import java.util.List;
+import java.util.Set;
 
 public class DefaultPosixFiles extends AbstractFiles implements PosixFiles {
+    // Advice, value is important - see posix_prefetch.cpp
+    private static final int WILLNEED = 0;
+    private static final int DONTNEED = 1;
+
     public PosixFileInfo stat(File file) throws NativeException {
         return stat(file, false);
     }
@@ -44,20 +63,166 @@ public class DefaultPosixFiles extends AbstractFiles implements PosixFiles {
         return stat;
     }
 
+    public ExtendedFileInfo stat(File file, boolean linkTarget, Set<StatField> fields, boolean allowStale) throws NativeException {
+        FunctionResult result = new FunctionResult();
+        ExtendedFileStat stat = new ExtendedFileStat(file.getPath());
+        PosixFileFunctions.statx(file.getPath(), linkTarget, ExtendedFileStat.toMask(fields), allowStale, stat.getRecord(), result);
+        if (result.isFailed()) {
+            if (result.getFailure() == FunctionResult.Failure.Permissions) {
+                throw new FilePermissionException(String.format("Could not get file details of %s: permission denied", file));
+            }
+            throw new NativeException(String.format("Could not get file details of %s: %s", file, result.getMessage()));
+        }
+        return stat;
+    }
+
+    public ReusablePosixFileInfo newFileInfo() {
+        return new FileStatBuffer();
+    }
+
+    public int stat(File file, boolean linkTarget, ReusablePosixFileInfo info) {
+        if (!(info instanceof FileStatBuffer)) {
+            throw new IllegalArgumentException("File info was not created by newFileInfo().");
+        }
+        FileStatBuffer buffer = (FileStatBuffer) info;
+        String path = file.getPath();
+        buffer.setPath(path);
+        return PosixFileFunctions.statInto(path, linkTarget, buffer.getBuffer());
+    }
+
+    public PosixFileInfoList stat(List<File> files, boolean linkTarget) throws NativeException {
+        String[] paths = new String[files.size()];
+        int index = 0;
+        for (File file : files) {
+            paths[index++] = file.getPath();
+        }
+        FunctionResult result = new FunctionResult();
+        FileStatList stats = new FileStatList(paths);
+        PosixFileFunctions.statAll(paths, linkTarget, stats.getRecords(), result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not get file details: %s", result.getMessage()));
+        }
+        return stats;
+    }
+
+    public FileHashes hash(List<File> files, HashAlgorithm algorithm) throws NativeException {
+        String[] paths = new String[files.size()];
+        int index = 0;
+        for (File file : files) {
+            paths[index++] = file.getPath();
+        }
+        FunctionResult result = new FunctionResult();
+        FileHashList hashes = new FileHashList(algorithm, paths.length);
+        PosixFileFunctions.hashAll(paths, algorithm.ordinal(), hashes.getHashes(), hashes.getErrors(), result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not hash files: %s", result.getMessage()));
+        }
+        return hashes;
+    }
+
+    public CopyStrategy copy(File source, File target, CopyOptions options) throws NativeException {
+        FunctionResult result = new FunctionResult();
+        int strategy = PosixFileFunctions.copy(source.getPath(), target.getPath(), CopyResultList.toFlags(options), result);
+        if (result.isFailed()) {
+            if (result.getFailure() == FunctionResult.Failure.Permissions) {
+                throw new FilePermissionException(String.format("Could not copy %s to %s: permission denied", source, target));
+            }
+            throw new NativeException(String.format("Could not copy %s to %s: %s", source, target, result.getMessage()));
+        }
+        return CopyStrategy.values()[strategy];
+    }
+
+    public CopyResults copy(List<File> sources, List<File> targets, CopyOptions options) throws NativeException {
+        if (sources.size() != targets.size()) {
+            throw new IllegalArgumentException("The number of source and target files must be the same.");
+        }
+        String[] sourcePaths = new String[sources.size()];
+        String[] targetPaths = new String[targets.size()];
+        for (int i = 0; i < sourcePaths.length; i++) {
+            sourcePaths[i] = sources.get(i).getPath();
+            targetPaths[i] = targets.get(i).getPath();
+        }
+        FunctionResult result = new FunctionResult();
+        CopyResultList results = new CopyResultList(sourcePaths.length);
+        PosixFileFunctions.copyAll(sourcePaths, targetPaths, CopyResultList.toFlags(options), results.getStrategies(), results.getErrors(), result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not copy files: %s", result.getMessage()));
+        }
+        return results;
+    }
+
+    public void prefetch(List<File> files) throws NativeException {
+        advise(files, WILLNEED, "prefetch");
+    }
+
+    public void evict(List<File> files) throws NativeException {
+        advise(files, DONTNEED, "evict");
+    }
+
+    private void advise(List<File> files, int advice, String operation) {
+        String[] paths = new String[files.size()];
+        for (int i = 0; i < paths.length; i++) {
+            paths[i] = files.get(i).getPath();
+        }
+        FunctionResult result = new FunctionResult();
+        PosixFileFunctions.adviseAll(paths, advice, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not %s files: %s", operation, result.getMessage()));
+        }
+    }
+
     public List<DirEntry> listDir(File dir) throws NativeException {
         return listDir(dir, false);
     }
 
     public List<DirEntry> listDir(File dir, boolean linkTarget) throws NativeException {
+        return readdir(dir, linkTarget, false);
+    }
+
+    public List<DirEntry> listDirTypes(File dir, boolean linkTarget) throws NativeException {
+        return readdir(dir, linkTarget, true);
+    }
+
+    private List<DirEntry> readdir(File dir, boolean linkTarget, boolean typeOnly) {
         FunctionResult result = new FunctionResult();
         DirList dirList = new DirList();
-        PosixFileFunctions.readdir(dir.getPath(), linkTarget, dirList, result);
+        PosixFileFunctions.readdir(dir.getPath(), linkTarget, typeOnly, dirList, result);
         if (result.isFailed()) {
             throw listDirFailure(dir, result);
         }
         return dirList.files;
     }
 
+    public void walk(File root, WalkOptions options, FileTreeVisitor visitor) throws NativeException {
+        FunctionResult result = new FunctionResult();
+        TreeWalk walk = new TreeWalk(visitor);
+        List<String> excludes = options.getExcludes();
+        PosixFileFunctions.walk(root.getPath(), options.getMaxDepth(), options.isFollowLinks(), excludes.toArray(new String[0]), walk.getBuffer(), walk, result);
+        if (result.isFailed()) {
+            throw listDirFailure(root, result);
+        }
+    }
+
+    public DirectorySnapshot.Builder newSnapshotBuilder() {
+        return new PackedDirectorySnapshot.Builder();
+    }
+
+    public DirectorySnapshot loadSnapshot(ByteBuffer contents) throws NativeException {
+        return new PackedDirectorySnapshot(contents);
+    }
+
+    public DirectorySnapshotDiff diff(DirectorySnapshot previous, DirectorySnapshot current) throws NativeException {
+        PackedDirectorySnapshot previousSnapshot = (PackedDirectorySnapshot) previous;
+        PackedDirectorySnapshot currentSnapshot = (PackedDirectorySnapshot) current;
+        FunctionResult result = new FunctionResult();
+        int[] changes = new int[2 * (previous.size() + current.size())];
+        int count = PosixFileFunctions.diffSnapshots(previousSnapshot.getBuffer(), previousSnapshot.getLength(), currentSnapshot.getBuffer(), currentSnapshot.getLength(), changes, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not compare snapshots: %s", result.getMessage()));
+        }
+        return new DefaultDirectorySnapshotDiff(previous, current, changes, count);
+    }
+
     public void setMode(File file, int perms) {
         FunctionResult result = new FunctionResult();
         PosixFileFunctions.chmod(file.getPath(), perms, result);
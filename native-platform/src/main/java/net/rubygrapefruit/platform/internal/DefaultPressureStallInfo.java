@@ -0,0 +1,82 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.PressureStallInfo;
+
+/**
+ * A view of the pressure values of one resource in a {@link DefaultProcessResourceSample} record.
+ */
+class DefaultPressureStallInfo implements PressureStallInfo {
+    // Record layout relative to the offset, order is important - see linux_resources.cpp
+    private static final int SOME = 0;
+    private static final int FULL = 4;
+    private static final int AVG10 = 0;
+    private static final int AVG60 = 1;
+    private static final int AVG300 = 2;
+    private static final int TOTAL = 3;
+
+    private final long[] record;
+    private final int offset;
+
+    DefaultPressureStallInfo(long[] record, int offset) {
+        this.record = record;
+        this.offset = offset;
+    }
+
+    private double average(int index) {
+        long value = record[offset + index];
+        // Averages are stored in hundredths of a percent
+        return value < 0 ? -1 : value / 100.0;
+    }
+
+    public boolean isAvailable() {
+        return record[offset + SOME + TOTAL] >= 0;
+    }
+
+    public double getSomeAverage10() {
+        return average(SOME + AVG10);
+    }
+
+    public double getSomeAverage60() {
+        return average(SOME + AVG60);
+    }
+
+    public double getSomeAverage300() {
+        return average(SOME + AVG300);
+    }
+
+    public long getSomeTotal() {
+        return record[offset + SOME + TOTAL];
+    }
+
+    public double getFullAverage10() {
+        return average(FULL + AVG10);
+    }
+
+    public double getFullAverage60() {
+        return average(FULL + AVG60);
+    }
+
+    public double getFullAverage300() {
+        return average(FULL + AVG300);
+    }
+
+    public long getFullTotal() {
+        return record[offset + FULL + TOTAL];
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.PressureStallInfo;
+import net.rubygrapefruit.platform.ProcessResourceSample;
+
+public class DefaultProcessResourceSample implements ProcessResourceSample {
+    // Record layout, order is important - see linux_resources.cpp
+    private static final int TIMESTAMP = 0;
+    private static final int USER_TIME = 1;
+    private static final int SYSTEM_TIME = 2;
+    private static final int THREADS = 3;
+    private static final int RESIDENT = 4;
+    private static final int PEAK_RESIDENT = 5;
+    private static final int READ_CHARS = 6;
+    private static final int WRITE_CHARS = 7;
+    private static final int READ_BYTES = 8;
+    private static final int WRITE_BYTES = 9;
+    private static final int PRESSURE_CPU = 10;
+    private static final int PRESSURE_MEMORY = 18;
+    private static final int PRESSURE_IO = 26;
+    private static final int RECORD_SIZE = 34;
+
+    private final long[] record = new long[RECORD_SIZE];
+    private final DefaultPressureStallInfo cpuPressure = new DefaultPressureStallInfo(record, PRESSURE_CPU);
+    private final DefaultPressureStallInfo memoryPressure = new DefaultPressureStallInfo(record, PRESSURE_MEMORY);
+    private final DefaultPressureStallInfo ioPressure = new DefaultPressureStallInfo(record, PRESSURE_IO);
+
+    public long[] getRecord() {
+        return record;
+    }
+
+    public long getTimestamp() {
+        return record[TIMESTAMP];
+    }
+
+    public long getUserCpuTime() {
+        return record[USER_TIME];
+    }
+
+    public long getSystemCpuTime() {
+        return record[SYSTEM_TIME];
+    }
+
+    public int getThreadCount() {
+        return (int) record[THREADS];
+    }
+
+    public long getResidentMemory() {
+        return record[RESIDENT];
+    }
+
+    public long getPeakResidentMemory() {
+        return record[PEAK_RESIDENT];
+    }
+
+    public long getReadChars() {
+        return record[READ_CHARS];
+    }
+
+    public long getWrittenChars() {
+        return record[WRITE_CHARS];
+    }
+
+    public long getReadBytes() {
+        return record[READ_BYTES];
+    }
+
+    public long getWrittenBytes() {
+        return record[WRITE_BYTES];
+    }
+
+    public PressureStallInfo getCpuPressure() {
+        return cpuPressure;
+    }
+
+    public PressureStallInfo getMemoryPressure() {
+        return memoryPressure;
+    }
+
+    public PressureStallInfo getIoPressure() {
+        return ioPressure;
+    }
+}
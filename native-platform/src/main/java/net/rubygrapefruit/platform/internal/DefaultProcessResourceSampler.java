@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ProcessResourceSample;
+import net.rubygrapefruit.platform.ProcessResourceSampler;
+import net.rubygrapefruit.platform.ResourceClosedException;
+import net.rubygrapefruit.platform.internal.jni.LinuxResourceFunctions;
+
+public class DefaultProcessResourceSampler implements ProcessResourceSampler {
+    // File descriptor layout, order is important - see linux_resources.cpp
+    private static final int STAT = 0;
+    private static final int FD_COUNT = 6;
+
+    private final int[] fds = new int[FD_COUNT];
+    // Reused, so that sampling does not allocate
+    private final FunctionResult sampleResult = new FunctionResult();
+
+    public DefaultProcessResourceSampler() {
+        FunctionResult result = new FunctionResult();
+        LinuxResourceFunctions.openSampler(fds, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not open process resource sampler: %s", result.getMessage()));
+        }
+    }
+
+    public ProcessResourceSample newSample() {
+        return new DefaultProcessResourceSample();
+    }
+
+    public void sample(ProcessResourceSample sample) throws NativeException {
+        if (!(sample instanceof DefaultProcessResourceSample)) {
+            throw new IllegalArgumentException("Sample was not created by newSample().");
+        }
+        if (fds[STAT] < 0) {
+            throw new ResourceClosedException("This sampler has been closed.");
+        }
+        sampleResult.reset();
+        LinuxResourceFunctions.sample(fds, ((DefaultProcessResourceSample) sample).getRecord(), sampleResult);
+        if (sampleResult.isFailed()) {
+            throw new NativeException(String.format("Could not sample process resources: %s", sampleResult.getMessage()));
+        }
+    }
+
+    public void close() {
+        if (fds[STAT] >= 0) {
+            LinuxResourceFunctions.closeSampler(fds);
+        }
+    }
+}
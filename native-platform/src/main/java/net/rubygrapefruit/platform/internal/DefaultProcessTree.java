@@ -0,0 +1,141 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.ProcessTree;
+import net.rubygrapefruit.platform.ProcessTreeEntry;
+
+import java.util.AbstractList;
+import java.util.List;
+
+public class DefaultProcessTree implements ProcessTree {
+    // Record layout, order is important - see linux_resources.cpp
+    private static final int PID = 0;
+    private static final int PARENT_PID = 1;
+    private static final int USER_TIME = 2;
+    private static final int SYSTEM_TIME = 3;
+    private static final int RESIDENT = 4;
+    private static final int PROPORTIONAL = 5;
+    private static final int READ_BYTES = 6;
+    private static final int WRITE_BYTES = 7;
+    static final int RECORD_SIZE = 8;
+
+    private final long[] records;
+    private final int count;
+
+    public DefaultProcessTree(long[] records, int count) {
+        this.records = records;
+        this.count = count;
+    }
+
+    public List<ProcessTreeEntry> getProcesses() {
+        return new AbstractList<ProcessTreeEntry>() {
+            @Override
+            public ProcessTreeEntry get(int index) {
+                if (index < 0 || index >= count) {
+                    throw new IndexOutOfBoundsException(String.valueOf(index));
+                }
+                return new Entry(index * RECORD_SIZE);
+            }
+
+            @Override
+            public int size() {
+                return count;
+            }
+        };
+    }
+
+    public long getUserCpuTime() {
+        return total(USER_TIME);
+    }
+
+    public long getSystemCpuTime() {
+        return total(SYSTEM_TIME);
+    }
+
+    public long getResidentMemory() {
+        return total(RESIDENT);
+    }
+
+    public long getProportionalMemory() {
+        return total(PROPORTIONAL);
+    }
+
+    public long getReadBytes() {
+        return total(READ_BYTES);
+    }
+
+    public long getWrittenBytes() {
+        return total(WRITE_BYTES);
+    }
+
+    private long total(int field) {
+        long total = 0;
+        for (int i = 0; i < count; i++) {
+            long value = records[i * RECORD_SIZE + field];
+            if (value > 0) {
+                total += value;
+            }
+        }
+        return total;
+    }
+
+    private class Entry implements ProcessTreeEntry {
+        private final int offset;
+
+        Entry(int offset) {
+            this.offset = offset;
+        }
+
+        public int getPid() {
+            return (int) records[offset + PID];
+        }
+
+        public int getParentPid() {
+            return (int) records[offset + PARENT_PID];
+        }
+
+        public long getUserCpuTime() {
+            return records[offset + USER_TIME];
+        }
+
+        public long getSystemCpuTime() {
+            return records[offset + SYSTEM_TIME];
+        }
+
+        public long getResidentMemory() {
+            return records[offset + RESIDENT];
+        }
+
+        public long getProportionalMemory() {
+            return records[offset + PROPORTIONAL];
+        }
+
+        public long getReadBytes() {
+            return records[offset + READ_BYTES];
+        }
+
+        public long getWrittenBytes() {
+            return records[offset + WRITE_BYTES];
+        }
+
+        @Override
+        public String toString() {
+            return String.format("process %d", getPid());
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.terminal.TerminalFrameRenderer;
+import net.rubygrapefruit.platform.terminal.TerminalOutput;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+
+public class DefaultTerminalFrameRenderer implements TerminalFrameRenderer {
+    private final AbstractTerminal terminal;
+    private final ByteArrayOutputStream buffer = new ByteArrayOutputStream();
+    // Writes the control sequences into the buffer, or directly to the terminal when it does not use control sequences
+    private final TerminalOutput frameOutput;
+    private final Object lock = new Object();
+    private List<String> previous = new ArrayList<String>();
+    private int cursorRow;
+    private boolean atStartOfLine = true;
+
+    public DefaultTerminalFrameRenderer(AbstractTerminal terminal) {
+        this.terminal = terminal;
+        TerminalOutput redirected = terminal.redirectTo(buffer);
+        this.frameOutput = redirected != null ? redirected : terminal;
+    }
+
+    public void render(List<? extends CharSequence> lines) throws NativeException {
+        synchronized (lock) {
+            if (!terminal.supportsCursorMotion()) {
+                throw new NativeException(String.format("Cursor motion not supported for %s", terminal));
+            }
+            int cols = terminal.getTerminalSize().getCols();
+            List<String> current = new ArrayList<String>(lines.size());
+            for (CharSequence line : lines) {
+                current.add(truncate(line.toString(), cols));
+            }
+
+            buffer.reset();
+            int rows = Math.max(previous.size(), current.size());
+            for (int row = 0; row < rows; row++) {
+                String oldLine = row < previous.size() ? previous.get(row) : null;
+                String newLine = row < current.size() ? current.get(row) : "";
+                if (newLine.equals(oldLine)) {
+                    continue;
+                }
+                moveToRow(row);
+                if (oldLine == null) {
+                    frameOutput.write(newLine);
+                } else {
+                    drawChanges(oldLine, newLine);
+                }
+                atStartOfLine = false;
+            }
+            moveToRow(current.size());
+            previous = current;
+
+            if (frameOutput != terminal && buffer.size() > 0) {
+                try {
+                    buffer.writeTo(terminal.getOutputStream());
+                } catch (IOException e) {
+                    throw new NativeException(String.format("Could not write frame to %s.", terminal), e);
+                }
+            }
+        }
+    }
+
+    public void detach() {
+        synchronized (lock) {
+            previous = new ArrayList<String>();
+            cursorRow = 0;
+            atStartOfLine = true;
+        }
+    }
+
+    private static String truncate(String line, int cols) {
+        // Leave the last column empty, as some terminals wrap as soon as it is written
+        if (cols > 0 && line.length() >= cols) {
+            return line.substring(0, cols - 1);
+        }
+        return line;
+    }
+
+    /**
+     * Redraws the cells of the line that differ, with the cursor at the start of the line.
+     */
+    private void drawChanges(String oldLine, String newLine) {
+        int common = Math.min(oldLine.length(), newLine.length());
+        int start = 0;
+        while (start < common && oldLine.charAt(start) == newLine.charAt(start)) {
+            start++;
+        }
+        frameOutput.cursorRight(start);
+        if (oldLine.length() == newLine.length()) {
+            // Skip the unchanged tail of the line
+            int end = newLine.length();
+            while (end > start && oldLine.charAt(end - 1) == newLine.charAt(end - 1)) {
+                end--;
+            }
+            frameOutput.write(newLine.substring(start, end));
+        } else {
+            frameOutput.write(newLine.substring(start));
+            if (newLine.length() < oldLine.length()) {
+                frameOutput.clearToEndOfLine();
+            }
+        }
+    }
+
+    /**
+     * Moves the cursor to the start of the given row of the frame. Uses new lines to move down, so that the terminal scrolls when the frame
+     * grows past the bottom of the screen.
+     */
+    private void moveToRow(int row) {
+        if (row < cursorRow) {
+            frameOutput.cursorUp(cursorRow - row);
+            if (!atStartOfLine) {
+                frameOutput.cursorStartOfLine();
+            }
+        } else if (row == cursorRow) {
+            if (!atStartOfLine) {
+                frameOutput.cursorStartOfLine();
+            }
+        } else {
+            for (int i = cursorRow; i < row; i++) {
+                frameOutput.newline();
+            }
+        }
+        cursorRow = row;
+        atStartOfLine = true;
+    }
+}
@@ -32,6 +32,15 @@ public class DirList {
         files.add(fileStat);
     }
 
+    // Called from native code
+    @SuppressWarnings("UnusedDeclaration")
+    public void addFiles(String[] names, int[] types, long[] sizes, long[] lastModified) {
+        FileInfo.Type[] typeValues = FileInfo.Type.values();
+        for (int i = 0; i < names.length; i++) {
+            files.add(new DefaultDirEntry(names[i], typeValues[types[i]], sizes[i], lastModified[i]));
+        }
+    }
+
     private static class DefaultDirEntry implements DirEntry {
         private final String name;
         private final Type type;
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.ExtendedFileInfo;
+import net.rubygrapefruit.platform.file.StatField;
+
+import java.util.Set;
+
+public class ExtendedFileStat implements ExtendedFileInfo {
+    // Record layout, order is important - see posix.cpp
+    public static final int TYPE = 0;
+    public static final int MODE = 1;
+    public static final int UID = 2;
+    public static final int GID = 3;
+    public static final int SIZE = 4;
+    public static final int BLOCK_SIZE = 5;
+    public static final int DEVICE = 6;
+    public static final int INODE = 7;
+    public static final int LINK_COUNT = 8;
+    public static final int ACCESS_TIME = 9;
+    public static final int MODIFIED_TIME = 10;
+    public static final int CHANGE_TIME = 11;
+    public static final int CREATION_TIME = 12;
+    public static final int FIELDS = 13;
+    public static final int RECORD_SIZE = 14;
+
+    private static final long NANOS_PER_MILLI = 1000000L;
+
+    private final String path;
+    private final long[] record = new long[RECORD_SIZE];
+
+    public ExtendedFileStat(String path) {
+        this.path = path;
+    }
+
+    public static int toMask(Set<StatField> fields) {
+        int mask = 0;
+        for (StatField field : fields) {
+            mask |= 1 << field.ordinal();
+        }
+        return mask;
+    }
+
+    public long[] getRecord() {
+        return record;
+    }
+
+    @Override
+    public String toString() {
+        return path;
+    }
+
+    public boolean isAvailable(StatField field) {
+        return (record[FIELDS] & (1 << field.ordinal())) != 0;
+    }
+
+    public Type getType() {
+        return Type.values()[(int) record[TYPE]];
+    }
+
+    public int getMode() {
+        return (int) record[MODE];
+    }
+
+    public int getUid() {
+        return (int) record[UID];
+    }
+
+    public int getGid() {
+        return (int) record[GID];
+    }
+
+    public long getSize() {
+        return record[SIZE];
+    }
+
+    public long getBlockSize() {
+        return record[BLOCK_SIZE];
+    }
+
+    public long getDevice() {
+        return record[DEVICE];
+    }
+
+    public long getInode() {
+        return record[INODE];
+    }
+
+    public long getLinkCount() {
+        return record[LINK_COUNT];
+    }
+
+    public long getLastModifiedTime() {
+        long nanos = record[MODIFIED_TIME];
+        long millis = nanos / NANOS_PER_MILLI;
+        // Round towards negative infinity, for times before the epoch
+        return nanos < 0 && millis * NANOS_PER_MILLI != nanos ? millis - 1 : millis;
+    }
+
+    public long getLastAccessTimeNanos() {
+        return record[ACCESS_TIME];
+    }
+
+    public long getLastModifiedTimeNanos() {
+        return record[MODIFIED_TIME];
+    }
+
+    public long getChangeTimeNanos() {
+        return record[CHANGE_TIME];
+    }
+
+    public long getCreationTimeNanos() {
+        return record[CREATION_TIME];
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.FileHashes;
+import net.rubygrapefruit.platform.file.HashAlgorithm;
+
+public class FileHashList implements FileHashes {
+    private final HashAlgorithm algorithm;
+    private final byte[] hashes;
+    private final int[] errors;
+
+    public FileHashList(HashAlgorithm algorithm, int count) {
+        this.algorithm = algorithm;
+        this.hashes = new byte[count * algorithm.getDigestLength()];
+        this.errors = new int[count];
+    }
+
+    public HashAlgorithm getAlgorithm() {
+        return algorithm;
+    }
+
+    public int size() {
+        return errors.length;
+    }
+
+    public byte[] getHash(int index) {
+        checkIndex(index);
+        int length = algorithm.getDigestLength();
+        byte[] hash = new byte[length];
+        System.arraycopy(hashes, index * length, hash, 0, length);
+        return hash;
+    }
+
+    public int getErrorCode(int index) {
+        checkIndex(index);
+        return errors[index];
+    }
+
+    public byte[] getHashes() {
+        return hashes;
+    }
+
+    public int[] getErrors() {
+        return errors;
+    }
+
+    private void checkIndex(int index) {
+        if (index < 0 || index >= errors.length) {
+            throw new IndexOutOfBoundsException(String.format("Index: %s, Size: %s", index, errors.length));
+        }
+    }
+}
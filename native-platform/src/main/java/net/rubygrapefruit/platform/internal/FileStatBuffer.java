@@ -0,0 +1,86 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.ReusablePosixFileInfo;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * A view over a single record with the layout of {@link FileStatList}, held in a direct buffer that native code writes into.
+ */
+public class FileStatBuffer implements ReusablePosixFileInfo {
+    private static final Type[] TYPES = Type.values();
+
+    private final ByteBuffer buffer;
+    private String path;
+
+    public FileStatBuffer() {
+        buffer = ByteBuffer.allocateDirect(FileStatList.RECORD_SIZE * 8).order(ByteOrder.nativeOrder());
+        buffer.putLong(FileStatList.TYPE * 8, Type.Missing.ordinal());
+    }
+
+    public ByteBuffer getBuffer() {
+        return buffer;
+    }
+
+    public void setPath(String path) {
+        this.path = path;
+    }
+
+    @Override
+    public String toString() {
+        return path;
+    }
+
+    private long field(int index) {
+        return buffer.getLong(index * 8);
+    }
+
+    public Type getType() {
+        return TYPES[(int) field(FileStatList.TYPE)];
+    }
+
+    public int getMode() {
+        return (int) field(FileStatList.MODE);
+    }
+
+    public int getUid() {
+        return (int) field(FileStatList.UID);
+    }
+
+    public int getGid() {
+        return (int) field(FileStatList.GID);
+    }
+
+    public long getSize() {
+        return field(FileStatList.SIZE);
+    }
+
+    public long getBlockSize() {
+        return field(FileStatList.BLOCK_SIZE);
+    }
+
+    public long getLastModifiedTime() {
+        return field(FileStatList.LAST_MODIFIED);
+    }
+
+    public int getErrorCode() {
+        return (int) field(FileStatList.ERRNO);
+    }
+}
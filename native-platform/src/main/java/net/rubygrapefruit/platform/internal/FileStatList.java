@@ -0,0 +1,81 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.PosixFileInfo;
+import net.rubygrapefruit.platform.file.PosixFileInfoList;
+
+import java.util.AbstractList;
+
+/**
+ * Details of a list of files, packed into a single array with one fixed size record per file.
+ */
+public class FileStatList extends AbstractList<PosixFileInfo> implements PosixFileInfoList {
+    // Record layout, order is important - see posix.cpp
+    public static final int TYPE = 0;
+    public static final int MODE = 1;
+    public static final int UID = 2;
+    public static final int GID = 3;
+    public static final int SIZE = 4;
+    public static final int LAST_MODIFIED = 5;
+    public static final int BLOCK_SIZE = 6;
+    public static final int ERRNO = 7;
+    public static final int RECORD_SIZE = 8;
+
+    private final String[] paths;
+    private final long[] records;
+
+    public FileStatList(String[] paths) {
+        this.paths = paths;
+        this.records = new long[paths.length * RECORD_SIZE];
+    }
+
+    public long[] getRecords() {
+        return records;
+    }
+
+    @Override
+    public int size() {
+        return paths.length;
+    }
+
+    @Override
+    public PosixFileInfo get(int index) {
+        int offset = recordOffset(index);
+        FileStat stat = new FileStat(paths[index]);
+        stat.details(
+            (int) records[offset + TYPE],
+            (int) records[offset + MODE],
+            (int) records[offset + UID],
+            (int) records[offset + GID],
+            records[offset + SIZE],
+            records[offset + LAST_MODIFIED],
+            (int) records[offset + BLOCK_SIZE]);
+        return stat;
+    }
+
+    public int getErrorCode(int index) {
+        return (int) records[recordOffset(index) + ERRNO];
+    }
+
+    private int recordOffset(int index) {
+        if (index < 0 || index >= paths.length) {
+            throw new IndexOutOfBoundsException(String.format("Index: %s, Size: %s", index, paths.length));
+        }
+        return index * RECORD_SIZE;
+    }
+}
@@ -31,6 +31,14 @@ public class FileSystemList {
         fileSystems.add(new DefaultFileSystemInfo(new File(mountPoint), fileSystemType, deviceName, remote, new DefaultCaseSensitivity(caseSensitive, casePreserving)));
     }
 
+    // Called from native code
+    @SuppressWarnings("UnusedDeclaration")
+    public void addMount(String mountPoint, String fileSystemType, String deviceName, boolean remote, boolean caseSensitive, boolean casePreserving,
+                         int mountId, int parentMountId, int deviceMajor, int deviceMinor, String root, String mountOptions, String propagation, String superOptions) {
+        fileSystems.add(new DefaultLinuxFileSystemInfo(new File(mountPoint), fileSystemType, deviceName, remote, new DefaultCaseSensitivity(caseSensitive, casePreserving),
+            mountId, parentMountId, deviceMajor, deviceMinor, root, mountOptions, propagation, superOptions));
+    }
+
     public void addForUnknownCaseSensitivity(String mountPoint, @Nullable String fileSystemType, String deviceName, boolean remote) {
         fileSystems.add(new DefaultFileSystemInfo(new File(mountPoint), fileSystemType == null ? "unknown" : fileSystemType, deviceName, remote, null));
     }
@@ -44,6 +44,16 @@ public class FunctionResult {
         this.message = message;
     }
 
+    /**
+     * Clears any failure, so that this result can be passed to another call.
+     */
+    public void reset() {
+        message = null;
+        failure = Failure.Generic;
+        errno = 0;
+        errorCodeDescription = null;
+    }
+
     public boolean isFailed() {
         return message != null;
     }
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.FileSystemInfo;
+import net.rubygrapefruit.platform.internal.jni.LinuxFileSystemFunctions;
+
+import java.util.Collections;
+import java.util.List;
+
+/**
+ * Caches the mount table, and reads it again only once the kernel reports that a file system has been mounted or unmounted.
+ */
+public class LinuxFileSystems extends PosixFileSystems {
+    private static final int NOT_OPENED = -2;
+
+    private final Object lock = new Object();
+    private int watchFd = NOT_OPENED;
+    private List<FileSystemInfo> fileSystems;
+
+    @Override
+    public List<FileSystemInfo> getFileSystems() {
+        synchronized (lock) {
+            if (watchFd == NOT_OPENED) {
+                // Start watching before the first read, so that no change is missed
+                watchFd = LinuxFileSystemFunctions.openMountTableWatch(new FunctionResult());
+            }
+            if (fileSystems == null || hasChanged()) {
+                fileSystems = Collections.unmodifiableList(super.getFileSystems());
+            }
+            return fileSystems;
+        }
+    }
+
+    private boolean hasChanged() {
+        if (watchFd < 0) {
+            // Cannot watch the mount table, so do not cache it
+            return true;
+        }
+        FunctionResult result = new FunctionResult();
+        boolean changed = LinuxFileSystemFunctions.mountTableChanged(watchFd, result);
+        return changed || result.isFailed();
+    }
+}
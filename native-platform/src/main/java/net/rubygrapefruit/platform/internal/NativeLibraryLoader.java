@@ -21,6 +21,7 @@ import net.rubygrapefruit.platform.NativeIntegrationLinkageException;
 import net.rubygrapefruit.platform.NativeIntegrationUnavailableException;
 
 import java.io.File;
+import java.io.IOException;
 import java.util.HashSet;
 import java.util.List;
 import java.util.Set;
@@ -42,15 +43,20 @@ public class NativeLibraryLoader {
         try {
             UnsatisfiedLinkError loadFailure = null;
             for (String platformId : platforms) {
-                File libFile = nativeLibraryLocator.find(new LibraryDef(libraryFileName, platformId));
+                LibraryDef libraryDef = new LibraryDef(libraryFileName, platformId);
+                File libFile = nativeLibraryLocator.find(libraryDef);
                 if (libFile == null) {
                     continue;
                 }
 
-                try {
-                    System.load(libFile.getCanonicalPath());
-                } catch (UnsatisfiedLinkError e) {
-                    loadFailure = e;
+                UnsatisfiedLinkError failure = tryLoad(libFile);
+                if (failure != null && nativeLibraryLocator.disableInMemory()) {
+                    // Shared memory is often mounted noexec, for example in Docker containers, so retry with a copy on disk
+                    libFile = nativeLibraryLocator.find(libraryDef);
+                    failure = tryLoad(libFile);
+                }
+                if (failure != null) {
+                    loadFailure = failure;
                     continue;
                 }
 
@@ -67,4 +73,15 @@ public class NativeLibraryLoader {
             throw new NativeException(String.format("Failed to load native library '%s' for %s.", libraryFileName, platform), t);
         }
     }
+
+    private UnsatisfiedLinkError tryLoad(File libFile) throws IOException {
+        try {
+            System.load(libFile.getCanonicalPath());
+            return null;
+        } catch (UnsatisfiedLinkError e) {
+            return e;
+        } finally {
+            nativeLibraryLocator.release(libFile);
+        }
+    }
 }
@@ -23,61 +23,145 @@ import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
-import java.io.RandomAccessFile;
+import java.net.JarURLConnection;
 import java.net.URL;
-import java.nio.channels.FileLock;
+import java.net.URLConnection;
+import java.util.Collections;
+import java.util.HashSet;
+import java.util.Set;
+import java.util.jar.JarEntry;
+import java.util.zip.CRC32;
 
 public class NativeLibraryLocator {
+    /**
+     * When set to true on Linux, libraries are extracted to shared memory and removed once loaded, so that nothing is written to disk.
+     * Falls back to extracting to disk when a library cannot be loaded from shared memory, for example because it is mounted noexec.
+     */
+    public static final String IN_MEMORY_PROPERTY = "net.rubygrapefruit.platform.library.inMemory";
+    private static final File SHARED_MEMORY_DIR = new File("/dev/shm");
+    private static final int COPY_BUFFER_SIZE = 64 * 1024;
+
     private final File extractDir;
     private final String version;
+    private volatile boolean inMemory;
+    private final Set<File> transientFiles = Collections.synchronizedSet(new HashSet<File>());
 
     public NativeLibraryLocator(File extractDir, String version) {
+        this(extractDir, version, Boolean.getBoolean(IN_MEMORY_PROPERTY) && Platform.current().isLinux() && SHARED_MEMORY_DIR.isDirectory());
+    }
+
+    NativeLibraryLocator(File extractDir, String version, boolean inMemory) {
         this.extractDir = extractDir;
         this.version = version;
+        this.inMemory = inMemory;
     }
 
     public File find(LibraryDef libraryDef) throws IOException {
         String resourceName = String.format("net/rubygrapefruit/platform/%s/%s", libraryDef.platform, libraryDef.name);
+        URL resource = getClass().getClassLoader().getResource(resourceName);
+        if (resource == null) {
+            return null;
+        }
+        if (inMemory) {
+            return extractTransient(resource, libraryDef, SHARED_MEMORY_DIR);
+        }
         if (extractDir != null) {
-            File libFile = new File(extractDir, String.format("%s/%s/%s", version, libraryDef.platform, libraryDef.name));
-            File lockFile = new File(libFile.getParentFile(), libFile.getName() + ".lock");
-            lockFile.getParentFile().mkdirs();
-            lockFile.createNewFile();
-            RandomAccessFile lockFileAccess = new RandomAccessFile(lockFile, "rw");
-            try {
-                // Take exclusive lock on lock file
-                FileLock lock = lockFileAccess.getChannel().lock();
-                if (lockFile.length() > 0 && lockFileAccess.readBoolean()) {
-                    // Library has been extracted
-                    return libFile;
-                }
-                URL resource = getClass().getClassLoader().getResource(resourceName);
-                if (resource != null) {
-                    // Extract library and write marker to lock file
-                    libFile.getParentFile().mkdirs();
-                    copy(resource, libFile);
-                    lockFileAccess.seek(0);
-                    lockFileAccess.writeBoolean(true);
-                    return libFile;
-                }
-            } finally {
-                // Also releases lock
-                lockFileAccess.close();
+            return extractToCache(resource, libraryDef);
+        }
+        return extractTransient(resource, libraryDef, null);
+    }
+
+    /**
+     * Stops extracting libraries to shared memory. Called when a library extracted there could not be loaded.
+     *
+     * @return true when libraries were being extracted to shared memory, in which case they should be located again.
+     */
+    public boolean disableInMemory() {
+        boolean wasInMemory = inMemory;
+        inMemory = false;
+        return wasInMemory;
+    }
+
+    /**
+     * Called once the given library has been loaded, or has failed to load. Removes the library when it was extracted for this process
+     * only. The library remains mapped after it has been removed, except on Windows where it is removed on exit instead.
+     */
+    public void release(File libFile) {
+        if (!transientFiles.remove(libFile) || Platform.current().isWindows()) {
+            return;
+        }
+        libFile.delete();
+        libFile.getParentFile().delete();
+    }
+
+    /**
+     * Extracts the library into a cache directory keyed by the content of the library. The library is written to a temporary file and
+     * renamed into place, so a library in the cache is always complete and can be used without taking a lock.
+     */
+    private File extractToCache(URL resource, LibraryDef libraryDef) throws IOException {
+        File libFile = new File(extractDir, String.format("%s/%s/%s/%s", version, libraryDef.platform, contentKey(resource), libraryDef.name));
+        if (libFile.isFile()) {
+            return libFile;
+        }
+        File libDir = libFile.getParentFile();
+        libDir.mkdirs();
+        File tempFile = File.createTempFile(libraryDef.name, ".tmp", libDir);
+        try {
+            copy(resource, tempFile);
+            // Another process may have won the race, in which case its copy has the same content. On Windows, the rename fails when
+            // the target exists
+            if (!tempFile.renameTo(libFile) && !libFile.isFile()) {
+                throw new NativeException(String.format("Could not move native JNI library into place at %s.", libFile));
+            }
+        } finally {
+            // Does nothing when the rename succeeded
+            tempFile.delete();
+        }
+        return libFile;
+    }
+
+    private File extractTransient(URL resource, LibraryDef libraryDef, File parentDir) throws IOException {
+        File libDir = File.createTempFile("native-platform", "dir", parentDir);
+        libDir.delete();
+        libDir.mkdirs();
+        File libFile = new File(libDir, libraryDef.name);
+        // Files registered later are deleted first
+        libDir.deleteOnExit();
+        libFile.deleteOnExit();
+        copy(resource, libFile);
+        transientFiles.add(libFile);
+        return libFile;
+    }
+
+    /**
+     * Returns a key for the content of the given resource. Uses the CRC and size recorded in the jar, when available, so that the
+     * library does not need to be read when it is already in the cache.
+     */
+    private static String contentKey(URL resource) throws IOException {
+        URLConnection connection = resource.openConnection();
+        if (connection instanceof JarURLConnection) {
+            JarEntry entry = ((JarURLConnection) connection).getJarEntry();
+            if (entry != null && entry.getCrc() != -1 && entry.getSize() != -1) {
+                return String.format("%08x-%d", entry.getCrc(), entry.getSize());
             }
-        } else {
-            URL resource = getClass().getClassLoader().getResource(resourceName);
-            if (resource != null) {
-                File libFile;
-                File libDir = File.createTempFile("native-platform", "dir");
-                libDir.delete();
-                libDir.mkdirs();
-                libFile = new File(libDir, libraryDef.name);
-                libFile.deleteOnExit();
-                copy(resource, libFile);
-                return libFile;
+        }
+        CRC32 crc = new CRC32();
+        long size = 0;
+        InputStream inputStream = connection.getInputStream();
+        try {
+            byte[] buffer = new byte[COPY_BUFFER_SIZE];
+            while (true) {
+                int nread = inputStream.read(buffer);
+                if (nread < 0) {
+                    break;
+                }
+                crc.update(buffer, 0, nread);
+                size += nread;
             }
+        } finally {
+            inputStream.close();
         }
-        return null;
+        return String.format("%08x-%d", crc.getValue(), size);
     }
 
     private static void copy(URL source, File dest) {
@@ -86,7 +170,7 @@ public class NativeLibraryLocator {
             try {
                 OutputStream outputStream = new FileOutputStream(dest);
                 try {
-                    byte[] buffer = new byte[4096];
+                    byte[] buffer = new byte[COPY_BUFFER_SIZE];
                     while (true) {
                         int nread = inputStream.read(buffer);
                         if (nread < 0) {
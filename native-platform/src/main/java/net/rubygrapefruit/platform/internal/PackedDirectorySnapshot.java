@@ -0,0 +1,186 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.file.DirectorySnapshot;
+import net.rubygrapefruit.platform.file.FileInfo;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.List;
+
+/**
+ * A snapshot stored in a direct buffer, using the layout documented on {@link DirectorySnapshot}. See posix_snapshot.cpp.
+ */
+public class PackedDirectorySnapshot implements DirectorySnapshot {
+    private static final int HEADER_SIZE = 4;
+    private static final int RECORD_HEADER_SIZE = 24;
+
+    private final ByteBuffer buffer;
+    private final int count;
+    private final int[] offsets;
+
+    public PackedDirectorySnapshot(ByteBuffer contents) {
+        if (!contents.isDirect()) {
+            throw new NativeException("Could not load snapshot: snapshot is not stored in a direct buffer.");
+        }
+        this.buffer = contents.slice().order(ByteOrder.nativeOrder());
+        if (buffer.limit() < HEADER_SIZE) {
+            throw new NativeException("Could not load snapshot: snapshot is truncated.");
+        }
+        this.count = buffer.getInt(0);
+        this.offsets = index(buffer, count);
+    }
+
+    /**
+     * Locates the entries of the snapshot, checking that they lie within the buffer. Also see index_snapshot() in posix_snapshot.cpp.
+     */
+    private static int[] index(ByteBuffer buffer, int count) {
+        int length = buffer.limit();
+        if (count < 0 || count > (length - HEADER_SIZE) / RECORD_HEADER_SIZE) {
+            throw new NativeException("Could not load snapshot: snapshot has an invalid number of entries.");
+        }
+        int typeCount = FileInfo.Type.values().length;
+        int[] entryOffsets = new int[count];
+        int offset = HEADER_SIZE;
+        for (int i = 0; i < count; i++) {
+            if (offset > length - RECORD_HEADER_SIZE) {
+                throw new NativeException("Could not load snapshot: snapshot is truncated.");
+            }
+            int type = buffer.getInt(offset);
+            if (type < 0 || type >= typeCount) {
+                throw new NativeException("Could not load snapshot: snapshot has an entry with an invalid type.");
+            }
+            int pathLength = buffer.getInt(offset + 4);
+            if (pathLength < 0 || pathLength > length - offset - RECORD_HEADER_SIZE) {
+                throw new NativeException("Could not load snapshot: snapshot is truncated.");
+            }
+            entryOffsets[i] = offset;
+            offset += RECORD_HEADER_SIZE + pathLength;
+        }
+        return entryOffsets;
+    }
+
+    public ByteBuffer getBuffer() {
+        return buffer;
+    }
+
+    public int getLength() {
+        return buffer.limit();
+    }
+
+    public ByteBuffer getContents() {
+        return buffer.asReadOnlyBuffer().order(ByteOrder.nativeOrder());
+    }
+
+    public int size() {
+        return count;
+    }
+
+    public String getPath(int index) {
+        int offset = offset(index);
+        byte[] path = new byte[buffer.getInt(offset + 4)];
+        ByteBuffer view = buffer.duplicate();
+        view.position(offset + RECORD_HEADER_SIZE);
+        view.get(path);
+        return new String(path, PathCharset.CHARSET);
+    }
+
+    public FileInfo.Type getType(int index) {
+        return FileInfo.Type.values()[buffer.getInt(offset(index))];
+    }
+
+    public long getSize(int index) {
+        return buffer.getLong(offset(index) + 8);
+    }
+
+    public long getLastModifiedTime(int index) {
+        return buffer.getLong(offset(index) + 16);
+    }
+
+    private int offset(int index) {
+        if (index < 0 || index >= count) {
+            throw new IndexOutOfBoundsException(String.format("Index: %s, Size: %s", index, count));
+        }
+        return offsets[index];
+    }
+
+    public static class Builder implements DirectorySnapshot.Builder {
+        private final List<Entry> entries = new ArrayList<Entry>();
+        private int length = HEADER_SIZE;
+
+        public DirectorySnapshot.Builder add(String path, FileInfo.Type type, long size, long lastModifiedTime) {
+            Entry entry = new Entry(path.getBytes(PathCharset.CHARSET), type, size, lastModifiedTime);
+            entries.add(entry);
+            length += RECORD_HEADER_SIZE + entry.path.length;
+            return this;
+        }
+
+        public DirectorySnapshot build() {
+            Collections.sort(entries, new Comparator<Entry>() {
+                public int compare(Entry o1, Entry o2) {
+                    return compareUnsigned(o1.path, o2.path);
+                }
+            });
+            for (int i = 1; i < entries.size(); i++) {
+                if (compareUnsigned(entries.get(i - 1).path, entries.get(i).path) == 0) {
+                    throw new IllegalArgumentException(String.format("Path '%s' was added more than once.", new String(entries.get(i).path, PathCharset.CHARSET)));
+                }
+            }
+            ByteBuffer buffer = ByteBuffer.allocateDirect(length).order(ByteOrder.nativeOrder());
+            buffer.putInt(entries.size());
+            for (Entry entry : entries) {
+                buffer.putInt(entry.type.ordinal());
+                buffer.putInt(entry.path.length);
+                buffer.putLong(entry.size);
+                buffer.putLong(entry.lastModifiedTime);
+                buffer.put(entry.path);
+            }
+            buffer.flip();
+            return new PackedDirectorySnapshot(buffer);
+        }
+
+        private static int compareUnsigned(byte[] a, byte[] b) {
+            int len = Math.min(a.length, b.length);
+            for (int i = 0; i < len; i++) {
+                int diff = (a[i] & 0xff) - (b[i] & 0xff);
+                if (diff != 0) {
+                    return diff;
+                }
+            }
+            return a.length - b.length;
+        }
+    }
+
+    private static class Entry {
+        final byte[] path;
+        final FileInfo.Type type;
+        final long size;
+        final long lastModifiedTime;
+
+        Entry(byte[] path, FileInfo.Type type, long size, long lastModifiedTime) {
+            this.path = path;
+            this.type = type;
+            this.size = size;
+            this.lastModifiedTime = lastModifiedTime;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import java.nio.charset.Charset;
+
+/**
+ * The charset used by the JVM to encode file paths for native calls.
+ */
+public class PathCharset {
+    public static final Charset CHARSET = pathCharset();
+
+    private static Charset pathCharset() {
+        String encoding = System.getProperty("sun.jnu.encoding");
+        if (encoding != null && Charset.isSupported(encoding)) {
+            return Charset.forName(encoding);
+        }
+        return Charset.defaultCharset();
+    }
+}
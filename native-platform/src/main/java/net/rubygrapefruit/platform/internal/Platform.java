@@ -16,6 +16,7 @@
 
 package net.rubygrapefruit.platform.internal;
 
+import net.rubygrapefruit.platform.LinuxSystemInfo;
 import net.rubygrapefruit.platform.NativeException;
 import net.rubygrapefruit.platform.NativeIntegration;
 import net.rubygrapefruit.platform.NativeIntegrationUnavailableException;
@@ -30,6 +31,7 @@ import net.rubygrapefruit.platform.file.WindowsFiles;
 import net.rubygrapefruit.platform.internal.jni.NativeVersion;
 import net.rubygrapefruit.platform.internal.jni.PosixTypeFunctions;
 import net.rubygrapefruit.platform.internal.jni.TerminfoFunctions;
+import net.rubygrapefruit.platform.memory.LinuxMemory;
 import net.rubygrapefruit.platform.memory.Memory;
 import net.rubygrapefruit.platform.memory.OsxMemory;
 import net.rubygrapefruit.platform.terminal.Terminals;
@@ -266,6 +268,34 @@ public abstract class Platform {
             return Arrays.asList(getId() + "-ncurses5", getId() + "-ncurses6");
         }
 
+        @Override
+        public <T extends NativeIntegration> Class<? extends T> canonicalise(Class<T> type) {
+            if (type.equals(Memory.class)) {
+                return LinuxMemory.class.asSubclass(type);
+            }
+            if (type.equals(SystemInfo.class)) {
+                return LinuxSystemInfo.class.asSubclass(type);
+            }
+            return super.canonicalise(type);
+        }
+
+        @Override
+        public <T extends NativeIntegration> T get(Class<T> type, NativeLibraryLoader nativeLibraryLoader) {
+            if (type.equals(FileSystems.class)) {
+                return type.cast(new LinuxFileSystems());
+            }
+            if (type.equals(LinuxMemory.class)) {
+                return type.cast(new DefaultLinuxMemory());
+            }
+            if (type.equals(LinuxSystemInfo.class)) {
+                return type.cast(new DefaultLinuxSystemInfo());
+            }
+            if (type.equals(ProcessLauncher.class) && Boolean.getBoolean(PosixProcessLauncher.ENABLED_PROPERTY)) {
+                return type.cast(new PosixProcessLauncher(new WrapperProcessLauncher(new DefaultProcessLauncher())));
+            }
+            return super.get(type, nativeLibraryLoader);
+        }
+
         @Override
         public boolean isLinux() {
             return true;
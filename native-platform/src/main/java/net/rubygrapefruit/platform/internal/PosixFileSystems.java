@@ -16,12 +16,17 @@
 
 package net.rubygrapefruit.platform.internal;
 
+import net.rubygrapefruit.platform.file.FileSystemCapacity;
+import net.rubygrapefruit.platform.file.FileSystemCapacityMonitor;
 import net.rubygrapefruit.platform.file.FileSystemInfo;
 import net.rubygrapefruit.platform.file.FileSystems;
 import net.rubygrapefruit.platform.NativeException;
 import net.rubygrapefruit.platform.internal.jni.PosixFileSystemFunctions;
 
+import java.io.File;
+import java.io.IOException;
 import java.util.List;
+import java.util.concurrent.TimeUnit;
 
 public class PosixFileSystems implements FileSystems {
     public List<FileSystemInfo> getFileSystems() {
@@ -33,4 +38,50 @@ public class PosixFileSystems implements FileSystems {
         }
         return fileSystems.fileSystems;
     }
+
+    public FileSystemInfo fileSystemFor(File file) throws NativeException {
+        String path;
+        try {
+            path = file.getCanonicalPath();
+        } catch (IOException e) {
+            path = file.getAbsolutePath();
+        }
+        FileSystemInfo match = null;
+        int matchLength = -1;
+        // Later entries are mounted on top of earlier entries with the same mount point
+        for (FileSystemInfo fileSystem : getFileSystems()) {
+            String mountPoint = fileSystem.getMountPoint().getPath();
+            if (mountPoint.length() >= matchLength && isAncestor(mountPoint, path)) {
+                match = fileSystem;
+                matchLength = mountPoint.length();
+            }
+        }
+        return match;
+    }
+
+    public FileSystemCapacity getCapacity(File file) throws NativeException {
+        DefaultFileSystemCapacity capacity = new DefaultFileSystemCapacity();
+        FunctionResult result = new FunctionResult();
+        PosixFileSystemFunctions.getCapacity(file.getAbsolutePath(), capacity.getRecord(), result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not query capacity of file system containing %s: %s", file, result.getMessage()));
+        }
+        return capacity;
+    }
+
+    public FileSystemCapacityMonitor startCapacityMonitor(List<File> files, long interval, TimeUnit unit) throws NativeException {
+        if (Platform.current().isWindows()) {
+            throw new NativeException("Monitoring file system capacity is not supported on Windows.");
+        }
+        return new DefaultFileSystemCapacityMonitor(files, Math.max(1, unit.toMillis(interval)));
+    }
+
+    private static boolean isAncestor(String mountPoint, String path) {
+        if (!path.startsWith(mountPoint)) {
+            return false;
+        }
+        return path.length() == mountPoint.length()
+            || mountPoint.endsWith(File.separator)
+            || path.charAt(mountPoint.length()) == File.separatorChar;
+    }
 }
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ProcessLauncher;
+import net.rubygrapefruit.platform.ThreadSafe;
+import net.rubygrapefruit.platform.internal.jni.PosixProcessFunctions;
+
+import java.io.File;
+import java.lang.reflect.Method;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Starts processes using posix_spawn(). The pipes to the child are created close-on-exec, so that processes can be started concurrently
+ * without one child inheriting the streams of another, and no lock is required.
+ *
+ * <p>Falls back to the given launcher for settings that are not supported natively, such as the redirects added in Java 7.</p>
+ *
+ * <p>Only used when {@link #ENABLED_PROPERTY} is set to true, as the returned processes do not support all of the methods of
+ * {@link Process} - see {@link SpawnedProcess}.</p>
+ */
+@ThreadSafe
+public class PosixProcessLauncher implements ProcessLauncher {
+    /**
+     * When set to true on Linux, processes are started natively instead of using {@link ProcessBuilder}.
+     */
+    public static final String ENABLED_PROPERTY = "net.rubygrapefruit.platform.process.native";
+    private static final String[] REDIRECT_METHODS = {"redirectInput", "redirectOutput", "redirectError"};
+
+    private final ProcessLauncher fallback;
+    private final boolean canSpawnInDirectory;
+    private final Method[] redirectMethods;
+    private final Object pipeRedirect;
+    private final ChildProcessMonitor monitor = new ChildProcessMonitor();
+
+    public PosixProcessLauncher(ProcessLauncher fallback) {
+        this.fallback = fallback;
+        this.canSpawnInDirectory = PosixProcessFunctions.canSpawnInDirectory();
+        Method[] methods = null;
+        Object pipe = null;
+        try {
+            Class<?> redirectType = Class.forName("java.lang.ProcessBuilder$Redirect");
+            pipe = redirectType.getField("PIPE").get(null);
+            methods = new Method[REDIRECT_METHODS.length];
+            for (int i = 0; i < REDIRECT_METHODS.length; i++) {
+                methods[i] = ProcessBuilder.class.getMethod(REDIRECT_METHODS[i]);
+            }
+        } catch (Exception e) {
+            // Java 6 and earlier, which do not support redirects
+            methods = null;
+        }
+        this.redirectMethods = methods;
+        this.pipeRedirect = pipe;
+    }
+
+    public Process start(ProcessBuilder processBuilder) throws NativeException {
+        List<String> command = processBuilder.command();
+        File directory = processBuilder.directory();
+        if (command.size() == 0 || (directory != null && !canSpawnInDirectory) || !hasPipeRedirects(processBuilder)) {
+            return fallback.start(processBuilder);
+        }
+
+        Map<String, String> environment = processBuilder.environment();
+        String[] environmentStrings = new String[environment.size()];
+        int index = 0;
+        for (Map.Entry<String, String> entry : environment.entrySet()) {
+            environmentStrings[index++] = entry.getKey() + "=" + entry.getValue();
+        }
+
+        int[] record = new int[SpawnedProcess.RECORD_SIZE];
+        FunctionResult result = new FunctionResult();
+        PosixProcessFunctions.spawn(command.toArray(new String[command.size()]), environmentStrings,
+                directory == null ? null : directory.getPath(), processBuilder.redirectErrorStream(), record, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not start '%s': %s", command.get(0), result.getMessage()));
+        }
+        return new SpawnedProcess(record, processBuilder.redirectErrorStream(), monitor);
+    }
+
+    private boolean hasPipeRedirects(ProcessBuilder processBuilder) {
+        if (redirectMethods == null) {
+            return true;
+        }
+        try {
+            for (Method method : redirectMethods) {
+                if (!pipeRedirect.equals(method.invoke(processBuilder))) {
+                    return false;
+                }
+            }
+            return true;
+        } catch (Exception e) {
+            return false;
+        }
+    }
+}
@@ -12,29 +12,46 @@ import java.io.InputStream;
 
 /**
  * Assumes vt100 input control sequences: http://invisible-island.net/xterm/ctlseqs/ctlseqs.html
+ *
+ * <p>Reads stdin in bulk and decodes the bytes read into a batch of key events natively, including CSI and SS3 sequences, bracketed paste
+ * and UTF-8. Events are then handed out from the batch without further native calls.</p>
  */
 public class PosixTerminalInput implements TerminalInput {
-    private final PeekInputStream inputStream = new PeekInputStream(new FileInputStream(FileDescriptor.in));
+    // Record layout, order is important - see posix_terminal_input.cpp
+    private static final int CONSUMED = 0;
+    private static final int EVENT_COUNT = 1;
+    private static final int IN_PASTE = 2;
+    private static final int EVENTS = 3;
+
+    // Event types, each event is a (type, value) pair
+    private static final int CHARACTER = 0;
+    private static final int CONTROL_KEY = 1;
+    private static final int END_INPUT = 2;
+
+    private static final int BUFFER_SIZE = 4096;
+    // How long to wait for the remainder of an escape sequence, before treating ESC as a character
+    private static final int ESCAPE_TIMEOUT_MILLIS = 50;
+
     private final Object lock = new Object();
-    private static final int UP_ARROW = 65;
-    private static final int DOWN_ARROW = 66;
-    private static final int RIGHT_ARROW = 67;
-    private static final int LEFT_ARROW = 68;
-    private static final int BACK_TAB = 90;
-    private static final int END = 70;
-    private static final int END1 = 52;
-    private static final int HOME = 72;
-    private static final int HOME1 = 49;
-    private static final int ERASE1 = 51;
-    private static final int PAGE_UP = 53;
-    private static final int PAGE_DOWN = 54;
-    private static final int TILDE = 126;
+    private final InputStream inputStream = new BufferedInput(new FileInputStream(FileDescriptor.in));
+    private final byte[] buffer = new byte[BUFFER_SIZE];
+    private final int[] record = new int[EVENTS + 2 * BUFFER_SIZE];
+    // The bytes that have been read but not yet decoded
+    private int start;
+    private int end;
+    private int nextEvent;
+    private int eventCount;
+    private boolean endOfInput;
 
     @Override
     public String toString() {
         return "POSIX input on stdin";
     }
 
+    /**
+     * Returns a stream that reads from stdin. Bytes already read by {@link #read(TerminalInputListener)} but not yet decoded are returned
+     * first.
+     */
     @Override
     public InputStream getInputStream() {
         return inputStream;
@@ -43,90 +60,67 @@ public class PosixTerminalInput implements TerminalInput {
     @Override
     public void read(TerminalInputListener listener) {
         synchronized (lock) {
-            if (peek(0) == 27 && peek(1) == 91) {
-                int ch = peek(2);
-                if (ch == UP_ARROW) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.UpArrow);
-                    return;
-                } else if (ch == DOWN_ARROW) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.DownArrow);
-                    return;
-                } else if (ch == LEFT_ARROW) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.LeftArrow);
-                    return;
-                } else if (ch == RIGHT_ARROW) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.RightArrow);
-                    return;
-                } else if (ch == BACK_TAB) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.BackTab);
-                    return;
-                } else if (ch == HOME) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.Home);
-                    return;
-                } else if (ch == END) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.End);
-                    return;
-                } else if (ch == ERASE1 && peek(3) == TILDE) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.EraseForward);
-                    return;
-                } else if (ch == HOME1 && peek(3) == TILDE) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.Home);
-                    return;
-                } else if (ch == END1 && peek(3) == TILDE) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.End);
-                    return;
-                } else if (ch == PAGE_UP && peek(3) == TILDE) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.PageUp);
-                    return;
-                } else if (ch == PAGE_DOWN && peek(3) == TILDE) {
-                    inputStream.consumeAll();
-                    listener.controlKey(TerminalInputListener.Key.PageDown);
+            while (nextEvent == eventCount) {
+                if (endOfInput && start == end) {
+                    listener.endInput();
                     return;
                 }
+                fill();
             }
-            int ch = next();
-            if (ch < 0) {
-                listener.endInput();
-            } else if (ch == '\n') {
-                listener.controlKey(TerminalInputListener.Key.Enter);
-            } else if (ch == 127 || ch == 8) {
-                listener.controlKey(TerminalInputListener.Key.EraseBack);
-            } else if (ch == 4) {
-                // ctrl-d
-                listener.endInput();
+            int offset = EVENTS + 2 * nextEvent;
+            nextEvent++;
+            int type = record[offset];
+            if (type == CHARACTER) {
+                listener.character((char) record[offset + 1]);
+            } else if (type == CONTROL_KEY) {
+                listener.controlKey(TerminalInputListener.Key.values()[record[offset + 1]]);
             } else {
-                listener.character((char) ch);
+                listener.endInput();
             }
         }
     }
 
-    private int peek(int i) {
-        try {
-            return inputStream.peek(i);
-        } catch (IOException e) {
-            throw new NativeException("Could not read from terminal.", e);
+    /**
+     * Decodes the next batch of events, reading more input when the pending bytes do not form a complete event.
+     */
+    private void fill() {
+        if (start < end) {
+            decode(false);
+            if (eventCount > 0) {
+                return;
+            }
+        }
+        if (start > 0) {
+            System.arraycopy(buffer, start, buffer, 0, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (end == buffer.length) {
+            decode(true);
+            return;
+        }
+        // Only wait a short time when there is an incomplete escape sequence pending
+        int timeout = end == 0 ? -1 : ESCAPE_TIMEOUT_MILLIS;
+        FunctionResult result = new FunctionResult();
+        int count = PosixTerminalFunctions.readInput(buffer, end, buffer.length - end, timeout, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not read from terminal: %s", result.getMessage()));
+        }
+        if (count < 0) {
+            endOfInput = true;
+            decode(true);
+        } else if (count == 0) {
+            decode(true);
+        } else {
+            end += count;
         }
     }
 
-    private int next() {
-        int ch;
-        try {
-            ch = inputStream.read();
-        } catch (IOException e) {
-            throw new NativeException("Could not read from terminal.", e);
-        }
-        return ch;
+    private void decode(boolean flush) {
+        PosixTerminalFunctions.decodeInput(buffer, start, end - start, flush, record);
+        start += record[CONSUMED];
+        eventCount = record[EVENT_COUNT];
+        nextEvent = 0;
     }
 
     @Override
@@ -157,4 +151,35 @@ public class PosixTerminalInput implements TerminalInput {
         }
         return this;
     }
+
+    private class BufferedInput extends InputStream {
+        private final InputStream delegate;
+
+        BufferedInput(InputStream delegate) {
+            this.delegate = delegate;
+        }
+
+        @Override
+        public int read() throws IOException {
+            synchronized (lock) {
+                if (start < end) {
+                    return buffer[start++] & 0xff;
+                }
+            }
+            return delegate.read();
+        }
+
+        @Override
+        public int read(byte[] bytes, int offset, int length) throws IOException {
+            synchronized (lock) {
+                if (start < end) {
+                    int count = Math.min(length, end - start);
+                    System.arraycopy(buffer, start, bytes, offset, count);
+                    start += count;
+                    return count;
+                }
+            }
+            return delegate.read(bytes, offset, length);
+        }
+    }
 }
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.ChildProcess;
+import net.rubygrapefruit.platform.ChildProcessUsage;
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.internal.jni.PosixProcessFunctions;
+
+import java.io.BufferedInputStream;
+import java.io.BufferedOutputStream;
+import java.io.ByteArrayInputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+
+/**
+ * A child process started by {@link PosixProcessLauncher}. On Linux, the process is also referenced by a pidfd, so that it can be signalled
+ * without the risk of its pid having been reused, and is reaped by a {@link ChildProcessMonitor}.
+ *
+ * <p>When the process is not monitored, {@link #waitFor()} blocks in native code, and so only checks for interruption before it starts
+ * waiting.</p>
+ *
+ * <p>The {@code ProcessHandle} methods added in Java 9, such as {@code toHandle()}, {@code children()}, {@code descendants()} and
+ * {@code info()}, cannot be implemented while targeting earlier versions and so throw {@link UnsupportedOperationException}. Use
+ * {@code ProcessHandle.of(pid())} instead. This is why {@link PosixProcessLauncher} has to be enabled explicitly.</p>
+ */
+public class SpawnedProcess extends Process implements ChildProcess {
+    // Record layout, order is important - see posix.cpp
+    private static final int PID = 0;
+    private static final int PIDFD = 1;
+    private static final int STDIN = 2;
+    private static final int STDOUT = 3;
+    private static final int STDERR = 4;
+    static final int RECORD_SIZE = 5;
+
+    private static final int SIGKILL = 9;
+    private static final int SIGTERM = 15;
+
+    private final int pid;
+    private final Object lock = new Object();
+    private boolean monitored;
+    private int pidfd;
+    private boolean exited;
+    private int exitValue;
+    private ChildProcessUsage usage;
+    private final DescriptorOutputStream stdin;
+    private final DescriptorInputStream stdout;
+    private final DescriptorInputStream stderr;
+    private final OutputStream outputStream;
+    private final InputStream inputStream;
+    private final InputStream errorStream;
+
+    SpawnedProcess(int[] record, boolean redirectErrorStream, ChildProcessMonitor monitor) {
+        pid = record[PID];
+        pidfd = record[PIDFD];
+        stdin = new DescriptorOutputStream(record[STDIN]);
+        stdout = new DescriptorInputStream(record[STDOUT]);
+        stderr = redirectErrorStream ? null : new DescriptorInputStream(record[STDERR]);
+        outputStream = new BufferedOutputStream(stdin);
+        inputStream = new BufferedInputStream(stdout);
+        errorStream = stderr == null ? new ByteArrayInputStream(new byte[0]) : new BufferedInputStream(stderr);
+        if (monitor != null && pidfd >= 0) {
+            synchronized (lock) {
+                monitored = true;
+            }
+            // Must be last, as the monitor can report the exit, or give up on this process, before this returns
+            if (!monitor.watch(this, pid, pidfd)) {
+                synchronized (lock) {
+                    monitored = false;
+                }
+            }
+        }
+    }
+
+    @Override
+    public String toString() {
+        return "process " + pid;
+    }
+
+    /**
+     * Returns the pid of this process.
+     */
+    public long pid() {
+        return pid;
+    }
+
+    public int getPid() {
+        return pid;
+    }
+
+    public ChildProcessUsage getResourceUsage() {
+        synchronized (lock) {
+            return usage;
+        }
+    }
+
+    /**
+     * Returns the pidfd of this process, or -1 when not supported or once the process has been reaped.
+     */
+    public int getPidfd() {
+        synchronized (lock) {
+            return pidfd;
+        }
+    }
+
+    @Override
+    public OutputStream getOutputStream() {
+        return outputStream;
+    }
+
+    @Override
+    public InputStream getInputStream() {
+        return inputStream;
+    }
+
+    @Override
+    public InputStream getErrorStream() {
+        return errorStream;
+    }
+
+    @Override
+    public int waitFor() throws InterruptedException {
+        synchronized (lock) {
+            while (monitored && !exited) {
+                lock.wait();
+            }
+            if (exited) {
+                return exitValue;
+            }
+        }
+        while (true) {
+            if (Thread.interrupted()) {
+                throw new InterruptedException();
+            }
+            synchronized (lock) {
+                if (exited || reap()) {
+                    return exitValue;
+                }
+            }
+            FunctionResult result = new FunctionResult();
+            PosixProcessFunctions.waitForExit(pid, result);
+            if (result.isFailed()) {
+                synchronized (lock) {
+                    // Another thread may have reaped the child in the meantime
+                    if (exited) {
+                        return exitValue;
+                    }
+                }
+                throw new NativeException(String.format("Could not wait for %s: %s", this, result.getMessage()));
+            }
+        }
+    }
+
+    @Override
+    public int exitValue() {
+        synchronized (lock) {
+            if (!exited && !reap()) {
+                throw new IllegalThreadStateException(String.format("%s has not exited", this));
+            }
+            return exitValue;
+        }
+    }
+
+    @Override
+    public void destroy() {
+        destroy(SIGTERM);
+    }
+
+    /**
+     * Kills this process with SIGKILL. Overrides the method added in Java 8.
+     */
+    public Process destroyForcibly() {
+        destroy(SIGKILL);
+        return this;
+    }
+
+    /**
+     * Returns true, as {@link #destroy()} sends SIGTERM, which the process can handle. Overrides the method added in Java 9.
+     */
+    public boolean supportsNormalTermination() {
+        return true;
+    }
+
+    private void destroy(int signal) {
+        synchronized (lock) {
+            if (!exited && !reap()) {
+                // The child has not been reaped, so its pid cannot have been reused
+                FunctionResult result = new FunctionResult();
+                PosixProcessFunctions.kill(pid, pidfd, signal, result);
+                if (result.isFailed()) {
+                    throw new NativeException(String.format("Could not destroy %s: %s", this, result.getMessage()));
+                }
+            }
+        }
+        stdin.close();
+        stdout.close();
+        if (stderr != null) {
+            stderr.close();
+        }
+    }
+
+    /**
+     * Called by the monitor once it has reaped the child.
+     */
+    void exited(int exitValue, ChildProcessUsage usage) {
+        synchronized (lock) {
+            markExited(exitValue);
+            this.usage = usage;
+            lock.notifyAll();
+        }
+    }
+
+    /**
+     * Called by the monitor when it can no longer report the exit of the child, which is then reaped by this object.
+     */
+    void unmonitored() {
+        synchronized (lock) {
+            monitored = false;
+            lock.notifyAll();
+        }
+    }
+
+    /**
+     * Collects the exit status of the child if it has exited. Must hold the lock.
+     */
+    private boolean reap() {
+        if (monitored) {
+            // The monitor reaps the child
+            return exited;
+        }
+        FunctionResult result = new FunctionResult();
+        int value = PosixProcessFunctions.reap(pid, result);
+        if (result.isFailed()) {
+            throw new NativeException(String.format("Could not wait for %s: %s", this, result.getMessage()));
+        }
+        if (value < 0) {
+            return false;
+        }
+        markExited(value);
+        return true;
+    }
+
+    private void markExited(int value) {
+        exited = true;
+        exitValue = value;
+        if (pidfd >= 0) {
+            PosixProcessFunctions.closeDescriptor(pidfd);
+            pidfd = -1;
+        }
+        // Nothing can read what is written from now on
+        stdin.close();
+    }
+
+    /**
+     * A file descriptor shared by a stream and the threads using it. The descriptor is only closed once no thread is using it, so that a
+     * concurrent read or write never uses a descriptor number that has been closed and reused for an unrelated file.
+     */
+    private static class Descriptor {
+        private final int fd;
+        private int users;
+        private boolean closed;
+
+        Descriptor(int fd) {
+            this.fd = fd;
+        }
+
+        synchronized int acquire() throws IOException {
+            if (closed) {
+                throw new IOException("Stream closed");
+            }
+            users++;
+            return fd;
+        }
+
+        synchronized void release() {
+            users--;
+            if (closed && users == 0) {
+                PosixProcessFunctions.closeDescriptor(fd);
+            }
+        }
+
+        /**
+         * Closes the descriptor, or defers closing it until the threads using it have finished.
+         */
+        synchronized void close() {
+            if (closed) {
+                return;
+            }
+            closed = true;
+            if (users == 0) {
+                PosixProcessFunctions.closeDescriptor(fd);
+            }
+        }
+    }
+
+    private static class DescriptorInputStream extends InputStream {
+        private final byte[] single = new byte[1];
+        private final Descriptor descriptor;
+
+        DescriptorInputStream(int fd) {
+            this.descriptor = new Descriptor(fd);
+        }
+
+        @Override
+        public int read() throws IOException {
+            synchronized (single) {
+                int count = read(single, 0, 1);
+                return count < 0 ? -1 : single[0] & 0xFF;
+            }
+        }
+
+        @Override
+        public int read(byte[] buffer, int offset, int length) throws IOException {
+            if (offset < 0 || length < 0 || length > buffer.length - offset) {
+                throw new IndexOutOfBoundsException();
+            }
+            if (length == 0) {
+                return 0;
+            }
+            int fd = descriptor.acquire();
+            try {
+                FunctionResult result = new FunctionResult();
+                int count = PosixProcessFunctions.read(fd, buffer, offset, length, result);
+                if (result.isFailed()) {
+                    throw new IOException(result.getMessage());
+                }
+                return count;
+            } finally {
+                descriptor.release();
+            }
+        }
+
+        @Override
+        public void close() {
+            descriptor.close();
+        }
+    }
+
+    private static class DescriptorOutputStream extends OutputStream {
+        private final Descriptor descriptor;
+
+        DescriptorOutputStream(int fd) {
+            this.descriptor = new Descriptor(fd);
+        }
+
+        @Override
+        public void write(int b) throws IOException {
+            write(new byte[]{(byte) b}, 0, 1);
+        }
+
+        @Override
+        public void write(byte[] buffer, int offset, int length) throws IOException {
+            if (offset < 0 || length < 0 || length > buffer.length - offset) {
+                throw new IndexOutOfBoundsException();
+            }
+            int fd = descriptor.acquire();
+            try {
+                FunctionResult result = new FunctionResult();
+                PosixProcessFunctions.write(fd, buffer, offset, length, result);
+                if (result.isFailed()) {
+                    throw new IOException(result.getMessage());
+                }
+            } finally {
+                descriptor.release();
+            }
+        }
+
+        @Override
+        public void close() {
+            descriptor.close();
+        }
+    }
+}
@@ -17,5 +17,26 @@
 package net.rubygrapefruit.platform.internal;
 
 public class TerminalCapabilities {
+    // Table layout, order is important - see curses.cpp
+    static final int BOLD_ON = 0;
+    static final int DIM_ON = 1;
+    static final int RESET = 2;
+    static final int DEFAULT_FOREGROUND = 3;
+    static final int HIDE_CURSOR = 4;
+    static final int SHOW_CURSOR = 5;
+    static final int UP = 6;
+    static final int DOWN = 7;
+    static final int LEFT = 8;
+    static final int RIGHT = 9;
+    static final int START_LINE = 10;
+    static final int CLEAR_TO_END_OF_LINE = 11;
+    static final int FOREGROUND = 12;
+
     String terminalName;
+    // The pre-rendered control sequences, null when the terminal does not support the capability
+    byte[][] sequences;
+
+    byte[] getSequence(int index) {
+        return sequences[index];
+    }
 }
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.internal.jni.PosixTerminalFunctions;
+import net.rubygrapefruit.platform.terminal.TerminalSize;
+import net.rubygrapefruit.platform.terminal.TerminalSizeListener;
+import net.rubygrapefruit.platform.terminal.Terminals;
+
+import javax.annotation.Nullable;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.List;
+import java.util.concurrent.CopyOnWriteArrayList;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+/**
+ * Tracks the size of the terminals attached to stdout and stderr. A SIGWINCH handler keeps the sizes in a buffer shared with the native
+ * code, so that the current size can be read without a native call. A single thread waits for size changes and notifies the listeners.
+ * The sizes are only tracked while this process is in the foreground of its controlling terminal, as a background process does not
+ * receive SIGWINCH. SIGCONT, which is sent when a job moves between foreground and background, also triggers an update.
+ */
+class TerminalSizeWatcher implements Runnable {
+    // Buffer layout, order is important - see posix.cpp
+    private static final int GENERATION = 0;
+    private static final int STDOUT = 1;
+    private static final int STDERR = 2;
+
+    private static volatile TerminalSizeWatcher instance;
+    // Set when the watcher could not be started, so that it is not attempted again on every query
+    private static boolean unavailable;
+
+    private final ByteBuffer sizes;
+    private final List<Registration> listeners = new CopyOnWriteArrayList<Registration>();
+    // Set when waiting for changes has failed, after which the sizes in the buffer are no longer updated
+    private volatile boolean failed;
+
+    private TerminalSizeWatcher(ByteBuffer sizes) {
+        this.sizes = sizes.order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Returns the watcher for this process, installing the signal handler on first use.
+     */
+    static synchronized TerminalSizeWatcher getInstance() {
+        if (instance == null) {
+            FunctionResult result = new FunctionResult();
+            ByteBuffer sizes = PosixTerminalFunctions.watchTerminalSize(result);
+            if (result.isFailed()) {
+                throw new NativeException(String.format("Could not watch terminal size: %s", result.getMessage()));
+            }
+            instance = new TerminalSizeWatcher(sizes);
+            Thread thread = new Thread(instance, "native-platform terminal size watcher");
+            thread.setDaemon(true);
+            thread.start();
+        }
+        return instance;
+    }
+
+    /**
+     * Returns the watcher for this process, starting it on first use, or null when it cannot be started.
+     */
+    @Nullable
+    static TerminalSizeWatcher getInstanceIfAvailable() {
+        TerminalSizeWatcher watcher = instance;
+        if (watcher != null) {
+            return watcher;
+        }
+        synchronized (TerminalSizeWatcher.class) {
+            if (instance == null && !unavailable) {
+                try {
+                    getInstance();
+                } catch (NativeException e) {
+                    unavailable = true;
+                }
+            }
+            return instance;
+        }
+    }
+
+    /**
+     * Returns the watcher for this process, or null when it has not been started.
+     */
+    @Nullable
+    static TerminalSizeWatcher getRunningInstance() {
+        return instance;
+    }
+
+    /**
+     * Returns the current size of the terminal attached to the given output, or null when the size is not being tracked, for example when
+     * the output is not attached to a terminal or this process is in the background.
+     */
+    @Nullable
+    TerminalSize getSize(Terminals.Output output) {
+        if (failed) {
+            return null;
+        }
+        return toSize(read(output));
+    }
+
+    void addListener(Terminals.Output output, TerminalSizeListener listener) {
+        listeners.add(new Registration(output, listener));
+    }
+
+    void removeListener(Terminals.Output output, TerminalSizeListener listener) {
+        for (Registration registration : listeners) {
+            if (registration.output == output && registration.listener == listener) {
+                listeners.remove(registration);
+                return;
+            }
+        }
+    }
+
+    public void run() {
+        long stdout = read(Terminals.Output.Stdout);
+        long stderr = read(Terminals.Output.Stderr);
+        while (true) {
+            FunctionResult result = new FunctionResult();
+            PosixTerminalFunctions.waitForTerminalSizeChange(result);
+            if (result.isFailed()) {
+                // Stop serving the cached sizes, so that callers query the terminal instead
+                failed = true;
+                Logger.getLogger(TerminalSizeWatcher.class.getName()).log(Level.WARNING, String.format("Could not wait for terminal size change: %s", result.getMessage()));
+                return;
+            }
+            long newStdout = read(Terminals.Output.Stdout);
+            if (newStdout != stdout) {
+                stdout = newStdout;
+                sizeChanged(Terminals.Output.Stdout, newStdout);
+            }
+            long newStderr = read(Terminals.Output.Stderr);
+            if (newStderr != stderr) {
+                stderr = newStderr;
+                sizeChanged(Terminals.Output.Stderr, newStderr);
+            }
+        }
+    }
+
+    private void sizeChanged(Terminals.Output output, long packedSize) {
+        TerminalSize size = toSize(packedSize);
+        if (size == null) {
+            return;
+        }
+        for (Registration registration : listeners) {
+            if (registration.output == output) {
+                try {
+                    registration.listener.sizeChanged(size);
+                } catch (RuntimeException e) {
+                    // Ignore, so that a broken listener does not stop the other listeners from being notified
+                }
+            }
+        }
+    }
+
+    private long read(Terminals.Output output) {
+        return sizes.getLong((output == Terminals.Output.Stdout ? STDOUT : STDERR) * 8);
+    }
+
+    @Nullable
+    private static TerminalSize toSize(long packedSize) {
+        if (packedSize < 0) {
+            return null;
+        }
+        MutableTerminalSize size = new MutableTerminalSize();
+        size.rows = (int) (packedSize >>> 32);
+        size.cols = (int) (packedSize & 0xffffffffL);
+        return size;
+    }
+
+    private static class Registration {
+        final Terminals.Output output;
+        final TerminalSizeListener listener;
+
+        Registration(Terminals.Output output, TerminalSizeListener listener) {
+            this.output = output;
+            this.listener = listener;
+        }
+    }
+}
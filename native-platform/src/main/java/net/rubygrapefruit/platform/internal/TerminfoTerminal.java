@@ -21,18 +21,16 @@ import net.rubygrapefruit.platform.internal.jni.PosixTerminalFunctions;
 import net.rubygrapefruit.platform.internal.jni.TerminfoFunctions;
 import net.rubygrapefruit.platform.terminal.TerminalOutput;
 import net.rubygrapefruit.platform.terminal.TerminalSize;
+import net.rubygrapefruit.platform.terminal.TerminalSizeListener;
 import net.rubygrapefruit.platform.terminal.Terminals;
 
 import java.io.OutputStream;
-import java.util.HashMap;
-import java.util.Map;
 
 public class TerminfoTerminal extends AbstractTerminal {
     private final Terminals.Output output;
     private final TerminalCapabilities capabilities = new TerminalCapabilities();
     private final OutputStream outputStream;
     private final Object lock = new Object();
-    private Map<Color, byte[]> foregroundColors = new HashMap<Color, byte[]>();
     private byte[] boldOn;
     private byte[] dim;
     private byte[] defaultForeground;
@@ -54,6 +52,26 @@ public class TerminfoTerminal extends AbstractTerminal {
         this.outputStream = AbstractTerminal.streamForOutput(output);
     }
 
+    private TerminfoTerminal(TerminfoTerminal source, OutputStream outputStream) {
+        this.output = source.output;
+        this.outputStream = outputStream;
+        capabilities.terminalName = source.capabilities.terminalName;
+        capabilities.sequences = source.capabilities.sequences;
+        ansiTerminal = source.ansiTerminal;
+        boldOn = source.boldOn;
+        dim = source.dim;
+        defaultForeground = source.defaultForeground;
+        reset = source.reset;
+        hideCursor = source.hideCursor;
+        showCursor = source.showCursor;
+        up = source.up;
+        down = source.down;
+        left = source.left;
+        right = source.right;
+        startLine = source.startLine;
+        clearEOL = source.clearEOL;
+    }
+
     @Override
     public String toString() {
         return String.format("Curses terminal %s on %s", capabilities.terminalName, getOutputDisplay());
@@ -72,57 +90,28 @@ public class TerminfoTerminal extends AbstractTerminal {
                 throw new NativeException(String.format("Could not open terminal for %s: %s", getOutputDisplay(), result.getMessage()));
             }
             ansiTerminal = isAnsiTerminal();
-            hideCursor = TerminfoFunctions.hideCursor(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine hide cursor control sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            showCursor = TerminfoFunctions.showCursor(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine show cursor control sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            defaultForeground = TerminfoFunctions.defaultForeground(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine default foreground control sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            boldOn = TerminfoFunctions.boldOn(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine bold on control sequence %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            dim = TerminfoFunctions.dimOn(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine dim on control sequence %s: %s", getOutputDisplay(), result.getMessage()));
-            }
+            hideCursor = capabilities.getSequence(TerminalCapabilities.HIDE_CURSOR);
+            showCursor = capabilities.getSequence(TerminalCapabilities.SHOW_CURSOR);
+            defaultForeground = capabilities.getSequence(TerminalCapabilities.DEFAULT_FOREGROUND);
+            boldOn = capabilities.getSequence(TerminalCapabilities.BOLD_ON);
+            dim = capabilities.getSequence(TerminalCapabilities.DIM_ON);
             if (dim == null && ansiTerminal) {
                 dim = AnsiTerminal.DIM_ON;
             }
-            reset = TerminfoFunctions.reset(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine reset control sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            down = TerminfoFunctions.down(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine cursor down sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            up = TerminfoFunctions.up(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine cursor up sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            left = TerminfoFunctions.left(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine cursor left sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            right = TerminfoFunctions.right(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine cursor right sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            startLine = TerminfoFunctions.startLine(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine cursor to start of line sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
-            clearEOL = TerminfoFunctions.clearToEndOfLine(result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not determine clear to end of line sequence for %s: %s", getOutputDisplay(), result.getMessage()));
-            }
+            reset = capabilities.getSequence(TerminalCapabilities.RESET);
+            down = capabilities.getSequence(TerminalCapabilities.DOWN);
+            up = capabilities.getSequence(TerminalCapabilities.UP);
+            left = capabilities.getSequence(TerminalCapabilities.LEFT);
+            right = capabilities.getSequence(TerminalCapabilities.RIGHT);
+            startLine = capabilities.getSequence(TerminalCapabilities.START_LINE);
+            clearEOL = capabilities.getSequence(TerminalCapabilities.CLEAR_TO_END_OF_LINE);
+        }
+    }
+
+    @Override
+    protected AbstractTerminal redirectTo(OutputStream outputStream) {
+        synchronized (lock) {
+            return new TerminfoTerminal(this, outputStream);
         }
     }
 
@@ -133,6 +122,14 @@ public class TerminfoTerminal extends AbstractTerminal {
 
     @Override
     public TerminalSize getTerminalSize() {
+        // Use the size maintained by the signal handlers, falling back to querying the terminal when the size is not being tracked
+        TerminalSizeWatcher watcher = TerminalSizeWatcher.getInstanceIfAvailable();
+        if (watcher != null) {
+            TerminalSize cachedSize = watcher.getSize(output);
+            if (cachedSize != null) {
+                return cachedSize;
+            }
+        }
         synchronized (lock) {
             MutableTerminalSize terminalSize = new MutableTerminalSize();
             FunctionResult result = new FunctionResult();
@@ -144,6 +141,19 @@ public class TerminfoTerminal extends AbstractTerminal {
         }
     }
 
+    @Override
+    public void addSizeListener(TerminalSizeListener listener) throws NativeException {
+        TerminalSizeWatcher.getInstance().addListener(output, listener);
+    }
+
+    @Override
+    public void removeSizeListener(TerminalSizeListener listener) {
+        TerminalSizeWatcher watcher = TerminalSizeWatcher.getRunningInstance();
+        if (watcher != null) {
+            watcher.removeListener(output, listener);
+        }
+    }
+
     @Override
     public boolean supportsColor() {
         return getColor(Color.Black, false) != null;
@@ -185,17 +195,7 @@ public class TerminfoTerminal extends AbstractTerminal {
         if (bright && ansiTerminal) {
             return AnsiTerminal.BRIGHT_FOREGROUND.get(color.ordinal());
         }
-        byte[] sequence = foregroundColors.get(color);
-        if (sequence == null) {
-            FunctionResult result = new FunctionResult();
-            sequence = TerminfoFunctions.foreground(color.ordinal(), result);
-            if (result.isFailed()) {
-                throw new NativeException(String.format("Could not switch foreground color for %s: %s", getOutputDisplay(),
-                        result.getMessage()));
-            }
-            foregroundColors.put(color, sequence);
-        }
-        return sequence;
+        return capabilities.getSequence(TerminalCapabilities.FOREGROUND + color.ordinal());
     }
 
     @Override
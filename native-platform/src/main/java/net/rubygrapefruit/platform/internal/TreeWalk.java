@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal;
+
+import net.rubygrapefruit.platform.file.FileInfo;
+import net.rubygrapefruit.platform.file.FileTreeVisitor;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Decodes the entries reported by the native tree walker. The entries are transferred in chunks of packed records, through a direct buffer.
+ */
+public class TreeWalk {
+    // Corresponds to WALK_CHUNK_SIZE in posix.cpp
+    public static final int CHUNK_SIZE = 64 * 1024;
+
+    private final ByteBuffer buffer = ByteBuffer.allocateDirect(CHUNK_SIZE).order(ByteOrder.nativeOrder());
+    private final FileInfo.Type[] types = FileInfo.Type.values();
+    private final FileTreeVisitor visitor;
+
+    public TreeWalk(FileTreeVisitor visitor) {
+        this.visitor = visitor;
+    }
+
+    public ByteBuffer getBuffer() {
+        return buffer;
+    }
+
+    // Called from native code
+    @SuppressWarnings("UnusedDeclaration")
+    public void chunk(int length) {
+        // Record layout: type (int), path length (int), size (long), last modified (long), path bytes
+        int pos = 0;
+        while (pos < length) {
+            int type = buffer.getInt(pos);
+            int pathLength = buffer.getInt(pos + 4);
+            long size = buffer.getLong(pos + 8);
+            long lastModified = buffer.getLong(pos + 16);
+            byte[] path = new byte[pathLength];
+            buffer.position(pos + 24);
+            buffer.get(path);
+            visitor.visitEntry(new String(path, PathCharset.CHARSET), types[type], size, lastModified);
+            pos += 24 + pathLength;
+        }
+        buffer.clear();
+    }
+}
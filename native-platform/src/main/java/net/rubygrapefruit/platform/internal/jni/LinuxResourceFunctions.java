@@ -0,0 +1,33 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal.jni;
+
+import net.rubygrapefruit.platform.internal.FunctionResult;
+
+public class LinuxResourceFunctions {
+    public static native void openSampler(int[] fds, FunctionResult result);
+
+    public static native void sample(int[] fds, long[] record, FunctionResult result);
+
+    public static native void closeSampler(int[] fds);
+
+    /**
+     * Collects the given process and its descendants into the given records. Returns the number of processes, which may be more than
+     * the records can hold, in which case the records are not filled.
+     */
+    public static native int getProcessTree(int pid, long[] records, FunctionResult result);
+}
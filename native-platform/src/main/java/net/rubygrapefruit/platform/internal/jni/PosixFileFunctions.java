@@ -19,13 +19,40 @@ package net.rubygrapefruit.platform.internal.jni;
 import net.rubygrapefruit.platform.internal.DirList;
 import net.rubygrapefruit.platform.internal.FileStat;
 import net.rubygrapefruit.platform.internal.FunctionResult;
+import net.rubygrapefruit.platform.internal.TreeWalk;
+
+import java.nio.ByteBuffer;
 
 public class PosixFileFunctions {
     public static native void chmod(String file, int perms, FunctionResult result);
 
     public static native void stat(String file, boolean followLink, FileStat stat, FunctionResult result);
 
-    public static native void readdir(String file, boolean followLink, DirList stat, FunctionResult result);
+    public static native void statAll(String[] files, boolean followLink, long[] records, FunctionResult result);
+
+    /**
+     * Writes a record with the layout of FileStatList into the given direct buffer, returning 0 or the errno of the failure.
+     */
+    public static native int statInto(String file, boolean followLink, ByteBuffer record);
+
+    public static native void statx(String file, boolean followLink, int fields, boolean allowStale, long[] record, FunctionResult result);
+
+    public static native void hashAll(String[] files, int algorithm, byte[] digests, int[] errors, FunctionResult result);
+
+    public static native void readdir(String file, boolean followLink, boolean typeOnly, DirList stat, FunctionResult result);
+
+    public static native void walk(String root, int maxDepth, boolean followLinks, String[] excludes, ByteBuffer buffer, TreeWalk callback, FunctionResult result);
+
+    public static native int diffSnapshots(ByteBuffer previous, int previousLength, ByteBuffer current, int currentLength, int[] changes, FunctionResult result);
+
+    public static native int copy(String source, String target, int flags, FunctionResult result);
+
+    public static native void copyAll(String[] sources, String[] targets, int flags, int[] strategies, int[] errors, FunctionResult result);
+
+    /**
+     * Applies the given advice to each of the given files from a background thread, and returns without waiting for it.
+     */
+    public static native void adviseAll(String[] files, int advice, FunctionResult result);
 
     public static native void symlink(String file, String content, FunctionResult result);
 
@@ -19,6 +19,23 @@ package net.rubygrapefruit.platform.internal.jni;
 import net.rubygrapefruit.platform.internal.FileSystemList;
 import net.rubygrapefruit.platform.internal.FunctionResult;
 
+import java.nio.ByteBuffer;
+
 public class PosixFileSystemFunctions {
     public static native void listFileSystems(FileSystemList fileSystems, FunctionResult result);
+
+    public static native void getCapacity(String path, long[] record, FunctionResult result);
+
+    /**
+     * Starts a native thread that samples the capacity of the given paths at the given interval. Returns the buffer the samples are written
+     * to, which is also the handle to pass to {@link #stopCapacityRefresher(ByteBuffer)}. Not available on Windows.
+     */
+    public static native ByteBuffer startCapacityRefresher(String[] paths, long intervalMillis, FunctionResult result);
+
+    /**
+     * Reads a consistent copy of the given slot of the buffer returned by {@link #startCapacityRefresher(String[], long, FunctionResult)}.
+     */
+    public static native void readCapacitySlot(ByteBuffer slots, int index, long[] record);
+
+    public static native void stopCapacityRefresher(ByteBuffer slots);
 }
@@ -30,4 +30,26 @@ public class PosixProcessFunctions {
     public static native String getEnvironmentVariable(String var, FunctionResult result);
 
     public static native void setEnvironmentVariable(String var, String value, FunctionResult result);
+
+    public static native boolean canSpawnInDirectory();
+
+    public static native void spawn(String[] command, String[] environment, String directory, boolean redirectErrorStream, int[] record, FunctionResult result);
+
+    public static native void waitForExit(int pid, FunctionResult result);
+
+    public static native int reap(int pid, FunctionResult result);
+
+    public static native void kill(int pid, int pidfd, int signal, FunctionResult result);
+
+    public static native int openChildMonitor(FunctionResult result);
+
+    public static native void watchChild(int monitorFd, int pid, int pidfd, FunctionResult result);
+
+    public static native int waitForChildren(int monitorFd, long[] records, FunctionResult result);
+
+    public static native int read(int fd, byte[] buffer, int offset, int length, FunctionResult result);
+
+    public static native void write(int fd, byte[] buffer, int offset, int length, FunctionResult result);
+
+    public static native void closeDescriptor(int fd);
 }
@@ -19,11 +19,34 @@ package net.rubygrapefruit.platform.internal.jni;
 import net.rubygrapefruit.platform.internal.FunctionResult;
 import net.rubygrapefruit.platform.internal.MutableTerminalSize;
 
+import java.nio.ByteBuffer;
+
 public class PosixTerminalFunctions {
     public static native boolean isatty(int filedes);
 
     public static native void getTerminalSize(int filedes, MutableTerminalSize size, FunctionResult result);
 
+    /**
+     * Installs the SIGWINCH and SIGCONT handlers, if not already installed, and returns the buffer that it keeps up to date.
+     */
+    public static native ByteBuffer watchTerminalSize(FunctionResult result);
+
+    /**
+     * Blocks until the terminal size changes, then updates the buffer returned by {@link #watchTerminalSize(FunctionResult)}.
+     */
+    public static native void waitForTerminalSizeChange(FunctionResult result);
+
+    /**
+     * Waits up to the given timeout for input on stdin, then reads what is available into the given buffer. Returns the number of bytes
+     * read, 0 on timeout, or -1 at the end of input. A negative timeout waits indefinitely.
+     */
+    public static native int readInput(byte[] buffer, int offset, int length, int timeoutMillis, FunctionResult result);
+
+    /**
+     * Decodes the given bytes into key events. See PosixTerminalInput for the record layout.
+     */
+    public static native void decodeInput(byte[] buffer, int offset, int length, boolean flush, int[] record);
+
     public static native void rawInputMode(FunctionResult result);
 
     public static native void resetInputMode(FunctionResult result);
@@ -23,34 +23,7 @@ public class TerminfoFunctions {
     public static native String getVersion();
 
     /**
-     * Sets up output.
+     * Sets up output, and fills in the control sequences of the terminal.
      */
     public static native void initTerminal(int filedes, TerminalCapabilities terminalCapabilities, FunctionResult result);
-
-    public static native byte[] boldOn(FunctionResult result);
-
-    public static native byte[] dimOn(FunctionResult result);
-
-    // May be null
-    public static native byte[] reset(FunctionResult result);
-
-    public static native byte[] foreground(int ansiColor, FunctionResult result);
-
-    public static native byte[] defaultForeground(FunctionResult result);
-
-    public static native byte[] hideCursor(FunctionResult result);
-
-    public static native byte[] showCursor(FunctionResult result);
-
-    public static native byte[] left(FunctionResult result);
-
-    public static native byte[] right(FunctionResult result);
-
-    public static native byte[] up(FunctionResult result);
-
-    public static native byte[] down(FunctionResult result);
-
-    public static native byte[] startLine(FunctionResult result);
-
-    public static native byte[] clearToEndOfLine(FunctionResult result);
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.memory;
+
+import net.rubygrapefruit.platform.ThreadSafe;
+
+/**
+ * Detailed Linux memory info. The physical memory values describe the whole machine, as reported by {@literal /proc/meminfo}. The cgroup values
+ * describe the memory cgroup of the current process, which is what limits the process when it runs in a container.
+ */
+@ThreadSafe
+public interface LinuxMemoryInfo extends MemoryInfo {
+    /**
+     * Returns the version of the cgroup hierarchy that the cgroup values are read from, 1 or 2, or 0 when the process is not in a memory cgroup.
+     */
+    int getCgroupVersion();
+
+    /**
+     * Returns the hard memory limit of the cgroup in bytes, from {@literal memory.max} or {@literal memory.limit_in_bytes}, or -1 when there is no limit.
+     */
+    long getCgroupMemoryLimit();
+
+    /**
+     * Returns the memory limit of the cgroup above which the kernel reclaims memory aggressively, from {@literal memory.high} or
+     * {@literal memory.soft_limit_in_bytes}, or -1 when there is no such limit.
+     */
+    long getCgroupMemoryHigh();
+
+    /**
+     * Returns the memory used by the cgroup in bytes, from {@literal memory.current} or {@literal memory.usage_in_bytes}, or -1 when not known.
+     */
+    long getCgroupMemoryUsage();
+
+    /**
+     * Returns the number of bytes of memory that the current process can use, which is the smaller of the physical memory and the limits of the cgroup.
+     */
+    long getEffectiveMemoryLimit();
+
+    /**
+     * Returns the number of bytes of memory that are available to the current process, taking the limits of the cgroup into account.
+     */
+    long getEffectiveAvailableMemory();
+}
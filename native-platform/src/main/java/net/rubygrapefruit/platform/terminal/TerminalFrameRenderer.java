@@ -0,0 +1,49 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.terminal;
+
+import net.rubygrapefruit.platform.NativeException;
+import net.rubygrapefruit.platform.ThreadSafe;
+
+import java.util.List;
+
+/**
+ * Renders a sequence of frames to a terminal, such as a multi-line progress display that is redrawn many times per second. Each frame
+ * replaces the previous one. Only the lines and cells that have changed are redrawn, and the control sequences and text for a frame are
+ * written to the terminal with a single write.
+ *
+ * <p>The first frame is drawn at the cursor, which should be at the start of a line. After each frame, the cursor is left at the start of
+ * the line below the frame. Lines should not contain line separators or other control characters, and are truncated to the width of the
+ * terminal.</p>
+ */
+@ThreadSafe
+public interface TerminalFrameRenderer {
+    /**
+     * Renders the given lines, replacing the previous frame.
+     *
+     * @throws NativeException On failure, or when the terminal does not support cursor motion.
+     */
+    @ThreadSafe
+    void render(List<? extends CharSequence> lines) throws NativeException;
+
+    /**
+     * Forgets the previous frame, so that the next frame is drawn at the cursor rather than over the previous one. Use this when other
+     * output has been written below the frame.
+     */
+    @ThreadSafe
+    void detach();
+}
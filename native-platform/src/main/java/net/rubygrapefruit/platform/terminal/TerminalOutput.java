@@ -67,6 +67,18 @@ public interface TerminalOutput {
      */
     TerminalSize getTerminalSize() throws NativeException;
 
+    /**
+     * Adds a listener to be notified when the size of this terminal changes. Does nothing if this terminal does not report size changes.
+     *
+     * @throws NativeException On failure.
+     */
+    void addSizeListener(TerminalSizeListener listener) throws NativeException;
+
+    /**
+     * Removes a listener previously added using {@link #addSizeListener(TerminalSizeListener)}.
+     */
+    void removeSizeListener(TerminalSizeListener listener);
+
     /**
      * Returns an {@link OutputStream} that writes to this terminal. The output stream is not buffered.
      */
@@ -201,4 +213,9 @@ public interface TerminalOutput {
      * @throws NativeException On failure, or if this terminal does not support clearing.
      */
     TerminalOutput clearToEndOfLine() throws NativeException;
+
+    /**
+     * Creates a renderer that draws frames of lines to this terminal, redrawing only what has changed between frames.
+     */
+    TerminalFrameRenderer newFrameRenderer();
 }
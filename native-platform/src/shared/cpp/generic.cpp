@@ -22,17 +22,42 @@
 #include <stdlib.h>
 #include <string.h>
 
+jclass stringClass;
+jmethodID functionResultFailedMethodId;
+
+jclass find_global_class(JNIEnv* env, const char* name) {
+    jclass localClass = env->FindClass(name);
+    if (localClass == NULL) {
+        return NULL;
+    }
+    jclass globalClass = (jclass) env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    return globalClass;
+}
+
+bool init_generic_ids(JNIEnv* env) {
+    stringClass = find_global_class(env, "java/lang/String");
+    jclass functionResultClass = find_global_class(env, "net/rubygrapefruit/platform/internal/FunctionResult");
+    if (stringClass == NULL || functionResultClass == NULL) {
+        return false;
+    }
+    functionResultFailedMethodId = env->GetMethodID(functionResultClass, "failed", "(Ljava/lang/String;IILjava/lang/String;)V");
+    return functionResultFailedMethodId != NULL;
+}
+
 void mark_failed_with_message(JNIEnv* env, const char* message, jobject result) {
     mark_failed_with_code(env, message, 0, NULL, result);
 }
 
 void mark_failed_with_code(JNIEnv* env, const char* message, int error_code, const char* error_code_message, jobject result) {
-    jclass destClass = env->GetObjectClass(result);
-    jmethodID method = env->GetMethodID(destClass, "failed", "(Ljava/lang/String;IILjava/lang/String;)V");
+    if (result == NULL) {
+        // The caller reports the failure some other way
+        return;
+    }
     jstring message_str = env->NewStringUTF(message);
     jstring error_code_str = error_code_message == NULL ? NULL : env->NewStringUTF(error_code_message);
     jint failure_code = map_error_code(error_code);
-    env->CallVoidMethod(result, method, message_str, failure_code, error_code, error_code_str);
+    env->CallVoidMethod(result, functionResultFailedMethodId, message_str, failure_code, error_code, error_code_str);
     if (error_code_str != NULL) {
         env->DeleteLocalRef(error_code_str);
     }
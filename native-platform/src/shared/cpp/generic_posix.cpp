@@ -59,6 +59,12 @@ char* java_to_utf_char(JNIEnv* env, jstring string, jobject result) {
     return chars;
 }
 
+void free_chars(char* chars, const char* buffer) {
+    if (chars != buffer) {
+        free(chars);
+    }
+}
+
 jstring utf_char_to_java(JNIEnv* env, const char* chars, jobject result) {
     return env->NewStringUTF(chars);
 }
@@ -28,6 +28,17 @@ char* java_to_char(JNIEnv* env, jstring string, jobject result) {
     return java_to_utf_char(env, string, result);
 }
 
+char* java_to_char_buffer(JNIEnv* env, jstring string, char* buffer, size_t bufferLen, jobject result) {
+    size_t len = env->GetStringLength(string);
+    size_t bytes = env->GetStringUTFLength(string);
+    if (bytes >= bufferLen) {
+        return java_to_utf_char(env, string, result);
+    }
+    env->GetStringUTFRegion(string, 0, len, buffer);
+    buffer[bytes] = 0;
+    return buffer;
+}
+
 jstring char_to_java(JNIEnv* env, const char* chars, jobject result) {
     return utf_char_to_java(env, chars, result);
 }
@@ -20,50 +20,303 @@
 #if defined(__linux__) || defined(__FreeBSD__)
 
 #include "generic.h"
+#include <langinfo.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
 #include <wchar.h>
 
-char* java_to_char(JNIEnv* env, jstring string, jobject result) {
-    size_t stringLen = env->GetStringLength(string);
-    wchar_t* wideString = (wchar_t*) malloc(sizeof(wchar_t) * (stringLen + 1));
-    const jchar* javaString = env->GetStringChars(string, NULL);
+#define CONVERSION_FAILED -1
+#define CONVERSION_OVERFLOW -2
+
+// -1 when not yet known, otherwise 0 or 1
+static int utf8Locale = -1;
+
+/*
+ * Determines whether the current locale encodes strings as UTF-8, in which case the strings can be converted
+ * directly rather than via wchar_t and the C library.
+ */
+static bool is_utf8_locale() {
+    if (utf8Locale < 0) {
+        const char* codeset = nl_langinfo(CODESET);
+        utf8Locale = codeset != NULL && (strcmp(codeset, "UTF-8") == 0 || strcmp(codeset, "utf8") == 0) ? 1 : 0;
+    }
+    return utf8Locale == 1;
+}
+
+/*
+ * Encodes the given UTF-16 chars as NULL terminated UTF-8.
+ *
+ * Returns the number of bytes written, not including the terminator, CONVERSION_OVERFLOW when the destination is too small or
+ * CONVERSION_FAILED for an unpaired surrogate.
+ */
+static ssize_t utf16_to_utf8(const jchar* src, size_t len, char* dest, size_t destLen) {
+    if (destLen == 0) {
+        return CONVERSION_OVERFLOW;
+    }
+    char* out = dest;
+    // Leave space for the terminator
+    char* end = dest + destLen - 1;
+    size_t i = 0;
+    while (i < len) {
+        // Copy runs of ASCII chars four at a time
+        while (i + 4 <= len && out + 4 <= end) {
+            uint64_t block;
+            memcpy(&block, src + i, sizeof(block));
+            if ((block & 0xFF80FF80FF80FF80ULL) != 0) {
+                break;
+            }
+            out[0] = (char) src[i];
+            out[1] = (char) src[i + 1];
+            out[2] = (char) src[i + 2];
+            out[3] = (char) src[i + 3];
+            out += 4;
+            i += 4;
+        }
+        if (i == len) {
+            break;
+        }
+        uint32_t ch = src[i++];
+        if (ch < 0x80) {
+            if (out + 1 > end) {
+                return CONVERSION_OVERFLOW;
+            }
+            *out++ = (char) ch;
+        } else if (ch < 0x800) {
+            if (out + 2 > end) {
+                return CONVERSION_OVERFLOW;
+            }
+            *out++ = (char) (0xC0 | (ch >> 6));
+            *out++ = (char) (0x80 | (ch & 0x3F));
+        } else if (ch < 0xD800 || ch > 0xDFFF) {
+            if (out + 3 > end) {
+                return CONVERSION_OVERFLOW;
+            }
+            *out++ = (char) (0xE0 | (ch >> 12));
+            *out++ = (char) (0x80 | ((ch >> 6) & 0x3F));
+            *out++ = (char) (0x80 | (ch & 0x3F));
+        } else {
+            if (ch >= 0xDC00 || i == len || src[i] < 0xDC00 || src[i] > 0xDFFF) {
+                return CONVERSION_FAILED;
+            }
+            ch = 0x10000 + ((ch - 0xD800) << 10) + (src[i++] - 0xDC00);
+            if (out + 4 > end) {
+                return CONVERSION_OVERFLOW;
+            }
+            *out++ = (char) (0xF0 | (ch >> 18));
+            *out++ = (char) (0x80 | ((ch >> 12) & 0x3F));
+            *out++ = (char) (0x80 | ((ch >> 6) & 0x3F));
+            *out++ = (char) (0x80 | (ch & 0x3F));
+        }
+    }
+    *out = 0;
+    return out - dest;
+}
+
+/*
+ * Decodes the given UTF-8 bytes as UTF-16. The destination must have space for at least one char per byte.
+ *
+ * Returns the number of chars written or CONVERSION_FAILED for malformed input.
+ */
+static ssize_t utf8_to_utf16(const unsigned char* src, size_t len, jchar* dest) {
+    jchar* out = dest;
+    size_t i = 0;
+    while (i < len) {
+        // Copy runs of ASCII bytes eight at a time
+        while (i + 8 <= len) {
+            uint64_t block;
+            memcpy(&block, src + i, sizeof(block));
+            if ((block & 0x8080808080808080ULL) != 0) {
+                break;
+            }
+            for (int j = 0; j < 8; j++) {
+                out[j] = src[i + j];
+            }
+            out += 8;
+            i += 8;
+        }
+        if (i == len) {
+            break;
+        }
+        uint32_t ch = src[i++];
+        if (ch < 0x80) {
+            *out++ = (jchar) ch;
+            continue;
+        }
+        size_t extra;
+        uint32_t min;
+        if (ch >= 0xC2 && ch <= 0xDF) {
+            extra = 1;
+            min = 0x80;
+            ch &= 0x1F;
+        } else if (ch >= 0xE0 && ch <= 0xEF) {
+            extra = 2;
+            min = 0x800;
+            ch &= 0x0F;
+        } else if (ch >= 0xF0 && ch <= 0xF4) {
+            extra = 3;
+            min = 0x10000;
+            ch &= 0x07;
+        } else {
+            return CONVERSION_FAILED;
+        }
+        if (len - i < extra) {
+            return CONVERSION_FAILED;
+        }
+        for (size_t j = 0; j < extra; j++) {
+            unsigned char next = src[i++];
+            if ((next & 0xC0) != 0x80) {
+                return CONVERSION_FAILED;
+            }
+            ch = (ch << 6) | (next & 0x3F);
+        }
+        if (ch < min || ch > 0x10FFFF || (ch >= 0xD800 && ch <= 0xDFFF)) {
+            return CONVERSION_FAILED;
+        }
+        if (ch >= 0x10000) {
+            ch -= 0x10000;
+            *out++ = (jchar) (0xD800 + (ch >> 10));
+            *out++ = (jchar) (0xDC00 + (ch & 0x3FF));
+        } else {
+            *out++ = (jchar) ch;
+        }
+    }
+    return out - dest;
+}
+
+/*
+ * Converts the given UTF-16 chars to the encoding of the current locale, for locales that do not use UTF-8.
+ *
+ * Returns NULL on failure.
+ */
+static char* java_to_locale_char(JNIEnv* env, const jchar* javaString, size_t stringLen, char* buffer, size_t bufferLen, jobject result) {
+    wchar_t stackString[STRING_BUFFER_SIZE];
+    wchar_t* wideString = stringLen < STRING_BUFFER_SIZE ? stackString : (wchar_t*) malloc(sizeof(wchar_t) * (stringLen + 1));
+    size_t wideLen = 0;
     for (size_t i = 0; i < stringLen; i++) {
-        wideString[i] = javaString[i];
+        wchar_t ch = javaString[i];
+        if (sizeof(wchar_t) > 2 && ch >= 0xD800 && ch <= 0xDBFF && i + 1 < stringLen && javaString[i + 1] >= 0xDC00 && javaString[i + 1] <= 0xDFFF) {
+            ch = 0x10000 + ((ch - 0xD800) << 10) + (javaString[++i] - 0xDC00);
+        }
+        wideString[wideLen++] = ch;
     }
-    wideString[stringLen] = L'\0';
-    env->ReleaseStringChars(string, javaString);
+    wideString[wideLen] = L'\0';
 
-    size_t bytes = wcstombs(NULL, wideString, 0);
+    // Convert in a single pass, into a destination large enough for the longest possible encoding
+    size_t maxBytes = wideLen * MB_CUR_MAX + 1;
+    char* chars = maxBytes <= bufferLen ? buffer : (char*) malloc(maxBytes);
+    size_t bytes = wcstombs(chars, wideString, maxBytes);
+    if (wideString != stackString) {
+        free(wideString);
+    }
     if (bytes == (size_t) -1) {
+        if (chars != buffer) {
+            free(chars);
+        }
         mark_failed_with_message(env, "could not convert string to current locale", result);
-        free(wideString);
         return NULL;
     }
+    return chars;
+}
+
+char* java_to_char_buffer(JNIEnv* env, jstring string, char* buffer, size_t bufferLen, jobject result) {
+    size_t stringLen = env->GetStringLength(string);
+    jchar stackChars[STRING_BUFFER_SIZE];
+    const jchar* javaString = stackChars;
+    if (stringLen <= STRING_BUFFER_SIZE) {
+        env->GetStringRegion(string, 0, stringLen, stackChars);
+    } else {
+        javaString = env->GetStringChars(string, NULL);
+        if (javaString == NULL) {
+            mark_failed_with_message(env, "could not get string chars", result);
+            return NULL;
+        }
+    }
 
-    char* chars = (char*) malloc(bytes + 1);
-    wcstombs(chars, wideString, bytes + 1);
-    free(wideString);
+    char* chars;
+    if (is_utf8_locale()) {
+        chars = buffer;
+        ssize_t bytes = utf16_to_utf8(javaString, stringLen, buffer, bufferLen);
+        if (bytes == CONVERSION_OVERFLOW) {
+            // Each char takes at most 3 bytes, as supplementary characters take 4 bytes for a pair of chars
+            size_t maxBytes = stringLen * 3 + 1;
+            chars = (char*) malloc(maxBytes);
+            bytes = utf16_to_utf8(javaString, stringLen, chars, maxBytes);
+        }
+        if (bytes < 0) {
+            if (chars != buffer) {
+                free(chars);
+            }
+            mark_failed_with_message(env, "could not convert string to current locale", result);
+            chars = NULL;
+        }
+    } else {
+        chars = java_to_locale_char(env, javaString, stringLen, buffer, bufferLen, result);
+    }
 
+    if (javaString != stackChars) {
+        env->ReleaseStringChars(string, javaString);
+    }
+    return chars;
+}
+
+char* java_to_char(JNIEnv* env, jstring string, jobject result) {
+    char buffer[STRING_BUFFER_SIZE];
+    char* chars = java_to_char_buffer(env, string, buffer, sizeof(buffer), result);
+    if (chars != buffer) {
+        return chars;
+    }
+    // Copy to a heap allocated string of exactly the right size
+    size_t bytes = strlen(buffer) + 1;
+    chars = (char*) malloc(bytes);
+    memcpy(chars, buffer, bytes);
     return chars;
 }
 
 jstring char_to_java(JNIEnv* env, const char* chars, jobject result) {
     size_t bytes = strlen(chars);
-    wchar_t* wideString = (wchar_t*) malloc(sizeof(wchar_t) * (bytes + 1));
-    if (mbstowcs(wideString, chars, bytes + 1) == (size_t) -1) {
+    // Never produces more chars than there are bytes
+    jchar stackChars[STRING_BUFFER_SIZE];
+    jchar* javaString = bytes <= STRING_BUFFER_SIZE ? stackChars : (jchar*) malloc(sizeof(jchar) * bytes);
+    ssize_t stringLen = CONVERSION_FAILED;
+    if (is_utf8_locale()) {
+        stringLen = utf8_to_utf16((const unsigned char*) chars, bytes, javaString);
+    } else {
+        wchar_t stackString[STRING_BUFFER_SIZE];
+        wchar_t* wideString = bytes < STRING_BUFFER_SIZE ? stackString : (wchar_t*) malloc(sizeof(wchar_t) * (bytes + 1));
+        size_t wideLen = mbstowcs(wideString, chars, bytes + 1);
+        if (wideLen != (size_t) -1) {
+            stringLen = 0;
+            for (size_t i = 0; i < wideLen; i++) {
+                uint32_t ch = (uint32_t) wideString[i];
+                if (ch >= 0x10000 && ch <= 0x10FFFF) {
+                    if (stringLen + 2 > (ssize_t) bytes) {
+                        stringLen = CONVERSION_FAILED;
+                        break;
+                    }
+                    ch -= 0x10000;
+                    javaString[stringLen++] = (jchar) (0xD800 + (ch >> 10));
+                    javaString[stringLen++] = (jchar) (0xDC00 + (ch & 0x3FF));
+                } else {
+                    javaString[stringLen++] = (jchar) ch;
+                }
+            }
+        }
+        if (wideString != stackString) {
+            free(wideString);
+        }
+    }
+
+    jstring string = NULL;
+    if (stringLen < 0) {
         mark_failed_with_message(env, "could not convert string from current locale", result);
-        free(wideString);
-        return NULL;
+    } else {
+        string = env->NewString(javaString, stringLen);
     }
-    size_t stringLen = wcslen(wideString);
-    jchar* javaString = (jchar*) malloc(sizeof(jchar) * stringLen);
-    for (int i = 0; i < stringLen; i++) {
-        javaString[i] = (jchar) wideString[i];
+    if (javaString != stackChars) {
+        free(javaString);
     }
-    jstring string = env->NewString(javaString, stringLen);
-    free(wideString);
-    free(javaString);
     return string;
 }
 
@@ -30,6 +30,9 @@ extern "C" {
 #define STDERR_DESCRIPTOR 1
 #define STDIN_DESCRIPTOR 2
 
+// Size of the buffers used to convert strings without allocating
+#define STRING_BUFFER_SIZE 1024
+
 // Corresponds to values of FileInfo.Type
 #define FILE_TYPE_FILE 0
 #define FILE_TYPE_DIRECTORY 1
@@ -43,8 +46,25 @@ extern "C" {
 #define FAILURE_NOT_A_DIRECTORY 2
 #define FAILURE_PERMISSIONS 3
 
+// Global references to classes used by the generic functions, resolved by init_generic_ids()
+extern jclass stringClass;
+
+/*
+ * Resolves the class, method and field ids used by the generic functions. Should be called from JNI_OnLoad().
+ *
+ * Returns false when an id cannot be resolved, with a Java exception pending.
+ */
+extern bool init_generic_ids(JNIEnv* env);
+
+/*
+ * Finds the given class and returns a global reference to it, so that the ids of its members remain valid.
+ *
+ * Returns NULL when the class cannot be found, with a Java exception pending.
+ */
+extern jclass find_global_class(JNIEnv* env, const char* name);
+
 /*
- * Marks the given result as failed, using the given error message
+ * Marks the given result as failed, using the given error message. Does nothing when the result is NULL.
  */
 extern void mark_failed_with_message(JNIEnv* env, const char* message, jobject result);
 
@@ -85,6 +105,19 @@ extern jstring wchar_to_java(JNIEnv* env, const wchar_t* chars, size_t len, jobj
  */
 extern char* java_to_char(JNIEnv* env, jstring string, jobject result);
 
+/*
+ * Converts the given Java string to a NULL terminated char string, using the given buffer when the result fits into it.
+ * Should call free_chars() when finished.
+ *
+ * Returns NULL on failure.
+ */
+extern char* java_to_char_buffer(JNIEnv* env, jstring string, char* buffer, size_t bufferLen, jobject result);
+
+/*
+ * Releases a string returned by java_to_char_buffer().
+ */
+extern void free_chars(char* chars, const char* buffer);
+
 /*
  * Converts the given NULL terminated char string to a Java string.
  *
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/*
+ * Streaming implementations of the hash algorithms supported for file hashing.
+ */
+#ifndef __INCLUDE_HASHING_H__
+#define __INCLUDE_HASHING_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Corresponds to the ordinals of HashAlgorithm
+#define HASH_ALGORITHM_XXH3 0
+#define HASH_ALGORITHM_SHA256 1
+#define HASH_ALGORITHM_BLAKE3 2
+
+// Largest digest length of any algorithm, in bytes
+#define MAX_DIGEST_LEN 32
+// Largest state size of any algorithm, in bytes
+#define MAX_HASH_STATE_SIZE 2048
+
+typedef struct hash_algorithm {
+    size_t digestLen;
+    // Size of the state used by the functions below
+    size_t stateSize;
+    void (*init)(void* state);
+    void (*update)(void* state, const unsigned char* data, size_t len);
+    void (*digest)(void* state, unsigned char* digest);
+} hash_algorithm_t;
+
+/*
+ * Returns the given algorithm, or NULL for an unknown algorithm.
+ */
+extern const hash_algorithm_t* hash_algorithm(int algorithm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#ifndef __INCLUDE_LINUX_H__
+#define __INCLUDE_LINUX_H__
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUNTINFO_FILE "/proc/self/mountinfo"
+
+// Corresponds to the values of the cgroup version reported to Java
+#define CGROUP_VERSION_NONE 0
+#define CGROUP_VERSION_1 1
+#define CGROUP_VERSION_2 2
+
+/*
+ * Parses a line of mountinfo, in place, into the 6 leading fields followed by the type, source and super options.
+ */
+extern bool parse_mountinfo_line(char* line, char** fields, char** optionalFields);
+
+/*
+ * Replaces the octal escapes in a mountinfo field, in place.
+ */
+extern char* unescape_mount_field(char* field);
+
+/*
+ * Finds the directory of the cgroup of the current process that the given controller is attached to, preferring a cgroup v1 hierarchy
+ * for the controller and falling back to the unified cgroup v2 hierarchy.
+ *
+ * Returns the cgroup version of the directory, or CGROUP_VERSION_NONE when the process is not in a cgroup with the controller.
+ */
+extern int find_cgroup_dir(const char* controller, char* dir, size_t dirLen);
+
+/*
+ * Reads the content of the given file from the start into the given buffer and NULL terminates it. Uses pread(), so that a file
+ * can be kept open and read again by several threads.
+ *
+ * Returns the number of bytes read, or -1 on failure.
+ */
+extern ssize_t pread_file(int fd, char* buffer, size_t bufferLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
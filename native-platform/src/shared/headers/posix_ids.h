@@ -0,0 +1,56 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#ifndef __INCLUDE_POSIX_IDS_H__
+#define __INCLUDE_POSIX_IDS_H__
+
+#ifndef _WIN32
+
+#include <jni.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Class, method and field ids used by the POSIX functions. These are resolved once by JNI_OnLoad(), rather than on each call.
+ */
+extern jmethodID fileStatDetailsMethodId;
+extern jmethodID dirListAddFilesMethodId;
+extern jmethodID treeWalkChunkMethodId;
+extern jmethodID fileSystemListAddMethodId;
+extern jmethodID fileSystemListAddForUnknownCaseSensitivityMethodId;
+extern jmethodID fileSystemListAddMountMethodId;
+extern jfieldID systemInfoOsNameFieldId;
+extern jfieldID systemInfoOsVersionFieldId;
+extern jfieldID systemInfoMachineArchitectureFieldId;
+extern jfieldID systemInfoHostnameFieldId;
+extern jfieldID typeInfoIntBytesFieldId;
+extern jfieldID typeInfoULongBytesFieldId;
+extern jfieldID typeInfoSizeTBytesFieldId;
+extern jfieldID typeInfoUidTBytesFieldId;
+extern jfieldID typeInfoGidTBytesFieldId;
+extern jfieldID typeInfoOffTBytesFieldId;
+extern jfieldID terminalSizeColsFieldId;
+extern jfieldID terminalSizeRowsFieldId;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
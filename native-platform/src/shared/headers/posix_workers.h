@@ -0,0 +1,54 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#ifndef __INCLUDE_POSIX_WORKERS_H__
+#define __INCLUDE_POSIX_WORKERS_H__
+
+#ifndef _WIN32
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Upper bound for the number of threads used by a single parallel operation
+#define MAX_WORKER_THREADS 32
+
+/*
+ * Work item for run_in_parallel(), called with the index of the item to process.
+ */
+typedef void (*parallel_task_t)(void* context, size_t index);
+
+/*
+ * Returns the number of worker threads to use for processing the given number of items, in chunks of the given size.
+ */
+extern int worker_count(size_t count, size_t chunkSize);
+
+/*
+ * Calls the given task for each index in [0, count). The indexes are handed out in chunks of the given size
+ * to a number of native worker threads, one of them being the calling thread. Blocks until all items have been
+ * processed. The task must not call back into Java.
+ */
+extern void run_in_parallel(parallel_task_t task, void* context, size_t count, size_t chunkSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
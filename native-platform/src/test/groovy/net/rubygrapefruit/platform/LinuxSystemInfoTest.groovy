@@ -0,0 +1,127 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform
+
+import net.rubygrapefruit.platform.internal.Platform
+import spock.lang.IgnoreIf
+import spock.lang.Specification
+
+@IgnoreIf({ !Platform.current().linux })
+class LinuxSystemInfoTest extends Specification {
+    def "caches system info instance"() {
+        expect:
+        def systemInfo = Native.get(LinuxSystemInfo.class)
+        systemInfo.is(Native.get(LinuxSystemInfo.class))
+        systemInfo.is(Native.get(SystemInfo.class))
+    }
+
+    def "can query CPU info"() {
+        when:
+        def cpuInfo = Native.get(LinuxSystemInfo.class).cpuInfo
+
+        then:
+        cpuInfo.onlineProcessorCount > 0
+        cpuInfo.availableProcessorCount > 0
+        cpuInfo.availableProcessorCount <= cpuInfo.onlineProcessorCount
+        cpuInfo.coreCount > 0
+        cpuInfo.coreCount <= cpuInfo.availableProcessorCount
+        cpuInfo.packageCount > 0
+        cpuInfo.packageCount <= cpuInfo.coreCount
+        cpuInfo.numaNodeCount > 0
+        cpuInfo.cgroupCpuQuota == -1 || cpuInfo.cgroupCpuPeriod > 0
+        cpuInfo.effectiveProcessorCount <= cpuInfo.availableProcessorCount
+        cpuInfo.recommendedCpuBoundParallelism >= 1
+        cpuInfo.recommendedCpuBoundParallelism <= cpuInfo.availableProcessorCount
+        cpuInfo.recommendedIoBoundParallelism >= cpuInfo.recommendedCpuBoundParallelism
+    }
+
+    def "available processor count matches the JVM when there is no CPU quota"() {
+        when:
+        def cpuInfo = Native.get(LinuxSystemInfo.class).cpuInfo
+
+        then:
+        cpuInfo.cgroupCpuQuota != -1 || cpuInfo.availableProcessorCount == Runtime.runtime.availableProcessors()
+    }
+
+    def "can sample process resources"() {
+        def sampler = Native.get(LinuxSystemInfo.class).openProcessResourceSampler()
+        def sample = sampler.newSample()
+
+        when:
+        sampler.sample(sample)
+        def first = sample.userCpuTime + sample.systemCpuTime
+        def start = sample.timestamp
+        long sum = 0
+        for (int i = 0; i < 10000000; i++) {
+            sum += i
+        }
+        sampler.sample(sample)
+
+        then:
+        sum > 0
+        sample.timestamp > start
+        sample.userCpuTime + sample.systemCpuTime >= first
+        sample.threadCount > 0
+        sample.residentMemory > 0
+        sample.peakResidentMemory >= sample.residentMemory
+        !sample.cpuPressure.available || sample.cpuPressure.someAverage10 >= 0
+
+        cleanup:
+        sampler?.close()
+    }
+
+    def "cannot sample after sampler is closed"() {
+        def sampler = Native.get(LinuxSystemInfo.class).openProcessResourceSampler()
+        def sample = sampler.newSample()
+        sampler.close()
+
+        when:
+        sampler.sample(sample)
+
+        then:
+        thrown(ResourceClosedException)
+    }
+
+    def "can query resource usage of process tree"() {
+        def pid = Native.get(Process.class).processId
+        def child = new ProcessBuilder("sh", "-c", "sleep 10 & sleep 10 & wait").start()
+
+        when:
+        def tree = Native.get(LinuxSystemInfo.class).getProcessTree(pid)
+        def processes = tree.processes
+        def pids = processes*.pid
+
+        then:
+        processes[0].pid == pid
+        processes.size() >= 2
+        processes.every { it == processes[0] || pids.indexOf(it.parentPid) >= 0 && pids.indexOf(it.parentPid) < pids.indexOf(it.pid) }
+        processes.every { it.residentMemory > 0 && it.userCpuTime >= 0 && it.systemCpuTime >= 0 }
+        tree.userCpuTime >= processes[0].userCpuTime
+        tree.residentMemory > processes[0].residentMemory
+
+        cleanup:
+        child?.destroy()
+    }
+
+    def "cannot query process tree of process that does not exist"() {
+        when:
+        Native.get(LinuxSystemInfo.class).getProcessTree(Integer.MAX_VALUE)
+
+        then:
+        thrown(NativeException)
+    }
+}
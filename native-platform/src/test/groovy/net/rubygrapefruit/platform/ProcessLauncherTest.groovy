@@ -16,8 +16,16 @@
 
 package net.rubygrapefruit.platform
 
+import net.rubygrapefruit.platform.internal.DefaultProcessLauncher
+import net.rubygrapefruit.platform.internal.Platform
+import net.rubygrapefruit.platform.internal.PosixProcessLauncher
+import net.rubygrapefruit.platform.internal.WrapperProcessLauncher
+import spock.lang.IgnoreIf
 import spock.lang.Specification
 
+import java.util.concurrent.Callable
+import java.util.concurrent.Executors
+
 class ProcessLauncherTest extends Specification {
     final ProcessLauncher launcher = Native.get(ProcessLauncher)
 
@@ -38,4 +46,132 @@ class ProcessLauncherTest extends Specification {
         result == 0
         stdout.toString().contains(System.getProperty('java.vm.version'))
     }
+
+    @IgnoreIf({ Platform.current().windows })
+    def "can start a child process with environment and working directory"() {
+        def dir = File.createTempFile("dir", ".tmp").canonicalFile
+        dir.delete()
+        dir.mkdirs()
+        ProcessBuilder builder = new ProcessBuilder("sh", "-c", 'echo "$PWD $TEST_VAR"; echo error >&2; exit 3')
+        builder.directory(dir)
+        builder.environment().put("TEST_VAR", "some value")
+
+        when:
+        def process = launcher.start(builder)
+        def stdout = process.inputStream.text
+        def stderr = process.errorStream.text
+
+        then:
+        process.waitFor() == 3
+        process.exitValue() == 3
+        stdout == "${dir} some value\n"
+        stderr == "error\n"
+
+        cleanup:
+        dir.delete()
+    }
+
+    @IgnoreIf({ Platform.current().windows })
+    def "can write to the standard input of a child process"() {
+        when:
+        def process = launcher.start(new ProcessBuilder("cat"))
+        process.outputStream.withStream { it.write("some input".bytes) }
+
+        then:
+        process.inputStream.text == "some input"
+        process.waitFor() == 0
+    }
+
+    @IgnoreIf({ Platform.current().windows })
+    def "can destroy a child process"() {
+        when:
+        def process = launcher.start(new ProcessBuilder("sleep", "60"))
+
+        then:
+        try {
+            process.exitValue()
+            assert false
+        } catch (IllegalThreadStateException e) {
+            // Expected
+        }
+
+        when:
+        process.destroy()
+
+        then:
+        process.waitFor() != 0
+    }
+
+    @IgnoreIf({ Platform.current().windows })
+    def "can start many child processes concurrently"() {
+        def executor = Executors.newFixedThreadPool(8)
+
+        when:
+        def futures = (1..40).collect { index ->
+            executor.submit({
+                def process = launcher.start(new ProcessBuilder("sh", "-c", "echo ${index}"))
+                def output = process.inputStream.text
+                process.waitFor()
+                return output
+            } as Callable)
+        }
+
+        then:
+        futures.collect { it.get() } == (1..40).collect { "${it}\n" as String }
+
+        cleanup:
+        executor.shutdown()
+    }
+
+    def "reports failure to start a process that does not exist"() {
+        when:
+        launcher.start(new ProcessBuilder("does-not-exist-${System.nanoTime()}"))
+
+        then:
+        NativeException e = thrown()
+        e.message.startsWith("Could not start 'does-not-exist-")
+    }
+
+    @IgnoreIf({ !Platform.current().linux })
+    def "reports exit value and resource usage of many child processes"() {
+        def launcher = nativeLauncher()
+
+        when:
+        def processes = (1..100).collect { index ->
+            def process = launcher.start(new ProcessBuilder("sh", "-c", "exit ${index % 7}"))
+            process.outputStream.close()
+            process.inputStream.close()
+            process.errorStream.close()
+            return process
+        }
+
+        then:
+        processes.every { it instanceof ChildProcess }
+        processes.collect { it.waitFor() } == (1..100).collect { it % 7 }
+        processes.every { ChildProcess process ->
+            process.pid > 0 && (process.resourceUsage == null || process.resourceUsage.maxResidentMemory > 0)
+        }
+    }
+
+    @IgnoreIf({ !Platform.current().linux })
+    def "can forcibly destroy a child process that ignores SIGTERM"() {
+        def process = nativeLauncher().start(new ProcessBuilder("sh", "-c", 'trap "" TERM; echo ready; exec sleep 60'))
+
+        expect:
+        process instanceof ChildProcess
+        process.supportsNormalTermination()
+        process.inputStream.newReader().readLine() == "ready"
+
+        when:
+        def result = process.destroyForcibly()
+
+        then:
+        result.is(process)
+        process.waitFor() == 128 + 9
+    }
+
+    private static ProcessLauncher nativeLauncher() {
+        // Not used by default, see PosixProcessLauncher.ENABLED_PROPERTY
+        return new PosixProcessLauncher(new WrapperProcessLauncher(new DefaultProcessLauncher()))
+    }
 }
@@ -17,12 +17,16 @@
 package net.rubygrapefruit.platform.file
 
 import net.rubygrapefruit.platform.Native
+import net.rubygrapefruit.platform.NativeException
+import net.rubygrapefruit.platform.ResourceClosedException
 import net.rubygrapefruit.platform.internal.Platform
 import org.junit.Rule
 import org.junit.rules.TemporaryFolder
 import spock.lang.Requires
 import spock.lang.Specification
 
+import java.util.concurrent.TimeUnit
+
 import static org.junit.Assume.assumeTrue
 
 class FileSystemsTest extends Specification {
@@ -74,4 +78,96 @@ class FileSystemsTest extends Specification {
         where:
         fileSystemType << ["xfs", "btrfs"]
     }
+
+    def "can query file system that contains a file"() {
+        def file = new File(tmpDir.root, "does-not-exist")
+
+        when:
+        def fileSystem = fileSystems.fileSystemFor(file)
+        def root = fileSystems.fileSystemFor(File.listRoots()[0])
+
+        then:
+        fileSystem != null
+        file.canonicalPath.startsWith(fileSystem.mountPoint.absolutePath)
+        root.mountPoint == File.listRoots()[0]
+    }
+
+    @Requires({ Platform.current().linux && new File("/proc/self").directory })
+    def "resolves symlinks when finding the file system that contains a file"() {
+        def link = new File(tmpDir.root, "link")
+        java.nio.file.Files.createSymbolicLink(link.toPath(), new File("/proc").toPath())
+
+        when:
+        def fileSystem = fileSystems.fileSystemFor(new File(link, "self"))
+
+        then:
+        fileSystem.mountPoint == new File("/proc")
+        fileSystem.fileSystemType == "proc"
+    }
+
+    @Requires({ Platform.current().linux })
+    def "can query mount details on Linux"() {
+        when:
+        def mountedFileSystems = fileSystems.fileSystems
+        def root = fileSystems.fileSystemFor(new File("/"))
+
+        then:
+        mountedFileSystems.every { it instanceof LinuxFileSystemInfo }
+        root instanceof LinuxFileSystemInfo
+        root.mountId > 0
+        root.root != null
+        root.mountOptions != null
+    }
+
+    def "can query capacity of file system that contains a file"() {
+        when:
+        def capacity = fileSystems.getCapacity(tmpDir.root)
+
+        then:
+        capacity.totalBytes > 0
+        capacity.freeBytes <= capacity.totalBytes
+        capacity.availableBytes <= capacity.freeBytes
+        capacity.availableInodes <= capacity.freeInodes
+        capacity.freeInodes <= capacity.totalInodes
+    }
+
+    def "cannot query capacity of file that does not exist"() {
+        def file = new File(tmpDir.root, "does-not-exist")
+
+        when:
+        fileSystems.getCapacity(file)
+
+        then:
+        def e = thrown(NativeException)
+        e.message.startsWith("Could not query capacity of file system containing ${file}:")
+    }
+
+    @Requires({ !Platform.current().windows })
+    def "can monitor capacity of file systems"() {
+        def missing = new File(tmpDir.root, "does-not-exist")
+
+        when:
+        def monitor = fileSystems.startCapacityMonitor([tmpDir.root, missing], 10, TimeUnit.MILLISECONDS)
+        def capacity = monitor.getCapacity(tmpDir.root)
+        def missingCapacity = monitor.getCapacity(missing)
+
+        then:
+        capacity.totalBytes > 0
+        capacity.availableBytes <= capacity.totalBytes
+        missingCapacity.totalBytes == -1
+
+        when:
+        monitor.getCapacity(new File(tmpDir.root, "other"))
+
+        then:
+        thrown(IllegalArgumentException)
+
+        when:
+        monitor.close()
+        monitor.close()
+        monitor.getCapacity(tmpDir.root)
+
+        then:
+        thrown(ResourceClosedException)
+    }
 }
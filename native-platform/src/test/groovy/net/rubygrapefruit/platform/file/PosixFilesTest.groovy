@@ -4,14 +4,19 @@ import net.rubygrapefruit.platform.Native
 import net.rubygrapefruit.platform.NativeException
 import net.rubygrapefruit.platform.internal.Platform
 import spock.lang.IgnoreIf
+import spock.lang.Requires
 import spock.lang.Unroll
 
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.nio.file.LinkOption
 import java.nio.file.attribute.PosixFileAttributeView
 import java.nio.file.attribute.PosixFileAttributes
 import java.nio.file.attribute.PosixFilePermission
+import java.util.concurrent.TimeUnit
 
 import static java.nio.file.attribute.PosixFilePermission.*
+import static org.junit.Assume.assumeTrue
 
 @IgnoreIf({ Platform.current().windows })
 class PosixFilesTest extends FilesTest {
@@ -181,6 +186,500 @@ class PosixFilesTest extends FilesTest {
         list*.name.sort() == ["a", "b"]
     }
 
+    def "can stat many files at once"() {
+        def dir = tmpDir.newFolder()
+        def testFiles = (1..1000).collect { new File(dir, "file-$it") }
+        testFiles.each { it.text = "content-$it.name" }
+        def missingFile = new File(dir, "missing")
+        def testDir = new File(dir, "dir")
+        testDir.mkdirs()
+
+        when:
+        def stats = files.stat(testFiles + [missingFile, testDir], false)
+
+        then:
+        stats.size() == 1002
+        testFiles.eachWithIndex { file, index ->
+            assertIsFile(stats[index], file)
+            assert stats[index].size == file.length()
+            assert stats.getErrorCode(index) == 0
+        }
+        stats[1000].type == FileInfo.Type.Missing
+        stats.getErrorCode(1000) == 0
+        stats[1001].type == FileInfo.Type.Directory
+    }
+
+    def "reports failure to stat one of many files as error code"() {
+        def dir = tmpDir.newFolder()
+        def testFile = new File(dir, "test.file")
+        testFile.text = "content"
+        def otherFile = tmpDir.newFile("other.file")
+        chmod(dir, [OWNER_READ])
+
+        when:
+        def stats = files.stat([testFile, otherFile], false)
+
+        then:
+        stats[0].type == FileInfo.Type.Missing
+        stats.getErrorCode(0) != 0
+        stats[1].type == FileInfo.Type.File
+        stats.getErrorCode(1) == 0
+
+        cleanup:
+        chmod(dir, [OWNER_READ, OWNER_WRITE, OWNER_EXECUTE])
+    }
+
+    def "can stat many files into a reusable file info"() {
+        def testFile = tmpDir.newFile("test.file")
+        testFile.text = "content"
+        def testDir = tmpDir.newFolder("test.dir")
+        def missing = new File(tmpDir.root, "missing")
+        def info = files.newFileInfo()
+
+        expect:
+        files.stat(testFile, false, info) == 0
+        info.type == FileInfo.Type.File
+        info.size == 7
+        info.mode == files.getMode(testFile)
+        info.lastModifiedTime == files.stat(testFile).lastModifiedTime
+        info.errorCode == 0
+
+        files.stat(testDir, false, info) == 0
+        info.type == FileInfo.Type.Directory
+        info.size == 0
+
+        files.stat(missing, false, info) == 0
+        info.type == FileInfo.Type.Missing
+    }
+
+    def "reports failure to stat into a reusable file info as error code"() {
+        def dir = tmpDir.newFolder()
+        def testFile = new File(dir, "test.file")
+        testFile.text = "content"
+        chmod(dir, [OWNER_READ])
+        def info = files.newFileInfo()
+
+        when:
+        def errorCode = files.stat(testFile, false, info)
+
+        then:
+        errorCode != 0
+        info.errorCode == errorCode
+
+        cleanup:
+        chmod(dir, [OWNER_READ, OWNER_WRITE, OWNER_EXECUTE])
+    }
+
+    def "can stat a file with extended details"() {
+        def testFile = tmpDir.newFile("test.file")
+        testFile.text = "content"
+        def link = new File(tmpDir.root, "link")
+        java.nio.file.Files.createLink(link.toPath(), testFile.toPath())
+        def attributes = java.nio.file.Files.readAttributes(testFile.toPath(), "unix:*")
+
+        when:
+        def stat = files.stat(testFile, false, EnumSet.of(StatField.Inode, StatField.LinkCount, StatField.LastModifiedTime), false)
+
+        then:
+        stat.type == FileInfo.Type.File
+        stat.isAvailable(StatField.Inode)
+        stat.isAvailable(StatField.LinkCount)
+        stat.isAvailable(StatField.LastModifiedTime)
+        stat.inode == attributes.ino
+        stat.device == attributes.dev
+        stat.linkCount == 2
+        stat.lastModifiedTimeNanos == attributes.lastModifiedTime.to(TimeUnit.NANOSECONDS)
+    }
+
+    def "can stat a missing file with extended details"() {
+        def testFile = new File(tmpDir.root, "missing")
+
+        when:
+        def stat = files.stat(testFile, false, EnumSet.allOf(StatField), true)
+
+        then:
+        stat.type == FileInfo.Type.Missing
+        stat.inode == 0
+        stat.lastModifiedTimeNanos == 0
+    }
+
+    @Unroll
+    def "can hash many files at once using #algorithm"() {
+        def dir = tmpDir.newFolder()
+        def emptyFile = new File(dir, "empty")
+        emptyFile.createNewFile()
+        def textFile = new File(dir, "text")
+        textFile.text = "abc"
+        def largeFile = new File(dir, "large")
+        largeFile.bytes = (0..<300000).collect { (byte) (it % 251) } as byte[]
+        def missingFile = new File(dir, "missing")
+
+        when:
+        def hashes = files.hash([emptyFile, textFile, largeFile, missingFile], algorithm)
+
+        then:
+        hashes.size() == 4
+        hashes.algorithm == algorithm
+        hashes.hashes.length == 4 * algorithm.digestLength
+        hashes.getHash(0).encodeHex().toString() == emptyHash
+        hashes.getHash(1).encodeHex().toString() == abcHash
+        hashes.getErrorCode(0) == 0
+        hashes.getErrorCode(2) == 0
+        hashes.getErrorCode(3) == 2
+        hashes.getHash(3) == new byte[algorithm.digestLength]
+
+        and:
+        algorithm != HashAlgorithm.Sha256 || hashes.getHash(2) == java.security.MessageDigest.getInstance("SHA-256").digest(largeFile.bytes)
+
+        where:
+        algorithm              | emptyHash                                                          | abcHash
+        HashAlgorithm.Xxh3     | "2d06800538d394c2"                                                 | "78af5f94892f3950"
+        HashAlgorithm.Sha256   | "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" | "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+        HashAlgorithm.Blake3   | "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" | "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85"
+    }
+
+    def "reports failure to hash a directory or FIFO without blocking"() {
+        def dir = tmpDir.newFolder()
+        def fifo = new File(dir, "fifo")
+        assert ["mkfifo", fifo.absolutePath].execute().waitFor() == 0
+
+        when:
+        def hashes = files.hash([dir, fifo], HashAlgorithm.Xxh3)
+
+        then:
+        hashes.getErrorCode(0) == 21
+        hashes.getErrorCode(1) == 22
+    }
+
+    def "can copy a file"() {
+        def source = tmpDir.newFile("source.txt")
+        source.text = "content"
+        chmod(source, [OWNER_READ, OWNER_WRITE, OWNER_EXECUTE])
+        source.lastModified = 1000000000000
+        def target = new File(tmpDir.root, "target.txt")
+
+        when:
+        def strategy = files.copy(source, target, new CopyOptions().preserveMode(true).preserveLastModifiedTime(true))
+
+        then:
+        strategy != null
+        target.text == "content"
+        mode(attributes(target)) == 0700
+        target.lastModified() == 1000000000000
+
+        when:
+        source.text = "other"
+        files.copy(source, target, new CopyOptions())
+
+        then:
+        target.text == "other"
+    }
+
+    def "preserves holes when copying a sparse file"() {
+        def source = tmpDir.newFile("sparse.bin")
+        def file = new RandomAccessFile(source, "rw")
+        file.write("start".bytes)
+        file.seek(16 * 1024 * 1024)
+        file.write("end".bytes)
+        file.close()
+        def target = new File(tmpDir.root, "copy.bin")
+
+        when:
+        files.copy(source, target, new CopyOptions())
+
+        then:
+        target.length() == source.length()
+        target.bytes == source.bytes
+    }
+
+    def "can copy many files at once"() {
+        def sources = (1..20).collect { def file = tmpDir.newFile("source-$it"); file.text = "content $it"; file }
+        def missing = new File(tmpDir.root, "missing")
+        def targets = (1..21).collect { new File(tmpDir.root, "target-$it") }
+
+        when:
+        def results = files.copy(sources + [missing], targets, new CopyOptions())
+
+        then:
+        results.size() == 21
+        (0..<20).each {
+            assert results.getErrorCode(it) == 0
+            assert results.getStrategy(it) != null
+            assert targets[it].text == "content ${it + 1}"
+        }
+        results.getErrorCode(20) == 2
+    }
+
+    def "can prefetch and evict files"() {
+        def contents = (1..20).collect { def file = tmpDir.newFile("file-$it"); file.text = "content $it"; file }
+        def missing = new File(tmpDir.root, "missing")
+        def dir = tmpDir.newFolder("dir")
+
+        when:
+        files.prefetch(contents + [missing, dir])
+        files.evict(contents + [missing, dir])
+        files.prefetch([])
+
+        then:
+        noExceptionThrown()
+        (0..<20).each {
+            assert contents[it].text == "content ${it + 1}"
+        }
+    }
+
+    @Requires({ Platform.current().linux && new File("/proc/self/io").file })
+    def "prefetch reads an evicted file into the page cache"() {
+        def file = tmpDir.newFile("data.bin")
+        def stream = new FileOutputStream(file)
+        stream.write(new byte[8 * 1024 * 1024])
+        // Dirty pages cannot be evicted
+        stream.FD.sync()
+        stream.close()
+        assumeTrue(Native.get(FileSystems.class).fileSystemFor(file).fileSystemType != "tmpfs")
+
+        expect:
+        // Both calls return before the work is done, so retry until the eviction has completed before the prefetch starts
+        (1..10).any {
+            files.evict([file])
+            Thread.sleep(100)
+            def before = readBytes()
+            files.prefetch([file])
+            (1..20).any {
+                Thread.sleep(50)
+                readBytes() - before >= file.length() / 2
+            }
+        }
+    }
+
+    @Requires({ Platform.current().linux })
+    def "cannot prefetch a file whose path cannot be converted"() {
+        def file = new File(tmpDir.root, "bad\uD800")
+
+        when:
+        files.prefetch([file])
+
+        then:
+        NativeException e = thrown()
+        e.message.startsWith("Could not prefetch files: ")
+    }
+
+    def "cannot copy a file that does not exist"() {
+        def source = new File(tmpDir.root, "missing")
+        def target = new File(tmpDir.root, "target")
+
+        when:
+        files.copy(source, target, new CopyOptions())
+
+        then:
+        NativeException e = thrown()
+        e.message == "Could not copy $source to $target: could not copy file (errno 2: No such file or directory)"
+    }
+
+    def "cannot copy a file onto itself"() {
+        def source = tmpDir.newFile("source.txt")
+        source.text = "content"
+        def link = new File(tmpDir.root, "link.txt")
+        java.nio.file.Files.createLink(link.toPath(), source.toPath())
+
+        when:
+        files.copy(source, source, new CopyOptions())
+
+        then:
+        NativeException e = thrown()
+        e.message == "Could not copy $source to $source: could not copy file (errno 22: Invalid argument)"
+        source.text == "content"
+
+        when:
+        files.copy(source, link, new CopyOptions())
+
+        then:
+        e = thrown()
+        e.message == "Could not copy $source to $link: could not copy file (errno 22: Invalid argument)"
+        source.text == "content"
+    }
+
+    def "cannot copy from or to a FIFO"() {
+        def file = tmpDir.newFile("file.txt")
+        file.text = "content"
+        def fifo = new File(tmpDir.root, "fifo")
+        assert ["mkfifo", fifo.absolutePath].execute().waitFor() == 0
+        def target = new File(tmpDir.root, "target")
+
+        when:
+        files.copy(fifo, target, new CopyOptions())
+
+        then:
+        NativeException e = thrown()
+        e.message == "Could not copy $fifo to $target: could not copy file (errno 22: Invalid argument)"
+
+        when:
+        files.copy(file, fifo, new CopyOptions())
+
+        then:
+        e = thrown()
+        e.message.startsWith("Could not copy $file to $fifo: could not copy file")
+    }
+
+    def "can list names and types of directory contents"() {
+        def dir = tmpDir.newFolder()
+        def childFile = new File(dir, "a")
+        childFile.text = 'content'
+        def childDir = new File(dir, "b")
+        childDir.mkdirs()
+        files.symlink(new File(dir, "c"), childDir.absolutePath)
+        files.symlink(new File(dir, "d"), "missing")
+
+        when:
+        def list = files.listDirTypes(dir, false).sort { it.name }
+
+        then:
+        list*.name == ["a", "b", "c", "d"]
+        list*.type == [FileInfo.Type.File, FileInfo.Type.Directory, FileInfo.Type.Symlink, FileInfo.Type.Symlink]
+        list*.size == [0, 0, 0, 0]
+        list*.lastModifiedTime == [0, 0, 0, 0]
+
+        when:
+        list = files.listDirTypes(dir, true).sort { it.name }
+
+        then:
+        list*.name == ["a", "b", "c", "d"]
+        list*.type == [FileInfo.Type.File, FileInfo.Type.Directory, FileInfo.Type.Directory, FileInfo.Type.Missing]
+    }
+
+    def "can walk a file tree"() {
+        def dir = tmpDir.newFolder()
+        new File(dir, "a").text = 'content'
+        new File(dir, "b/c/d").mkdirs()
+        new File(dir, "b/c/d/e").text = 'content'
+        new File(dir, "b/ignored/f").mkdirs()
+        files.symlink(new File(dir, "link"), "b")
+        def visited = [:]
+        def visitor = { String path, FileInfo.Type type, long size, long lastModified -> visited[path] = type } as FileTreeVisitor
+
+        when:
+        files.walk(dir, new WalkOptions().exclude("ignore*"), visitor)
+
+        then:
+        visited == [a: FileInfo.Type.File, b: FileInfo.Type.Directory, "b/c": FileInfo.Type.Directory, "b/c/d": FileInfo.Type.Directory,
+                    "b/c/d/e": FileInfo.Type.File, link: FileInfo.Type.Symlink]
+
+        when:
+        visited.clear()
+        files.walk(dir, new WalkOptions().withMaxDepth(2).followLinks(true), visitor)
+
+        then:
+        // "b" and "link" are the same directory, and whichever is listed first is descended into
+        visited.keySet().containsAll(["a", "b", "link"])
+        visited.b == FileInfo.Type.Directory
+        visited.link == FileInfo.Type.Directory
+        def children = (visited.keySet() - ["a", "b", "link"]).sort()
+        children == ["b/c", "b/ignored"] || children == ["link/c", "link/ignored"]
+    }
+
+    def "cannot walk a file tree that does not exist"() {
+        def dir = new File(tmpDir.root, "missing")
+
+        when:
+        files.walk(dir, new WalkOptions(), {} as FileTreeVisitor)
+
+        then:
+        def e = thrown(NoSuchFileException)
+        e.message == "Could not list directory $dir as this directory does not exist."
+    }
+
+    def "can diff snapshots"() {
+        def previous = files.newSnapshotBuilder()
+            .add("b", FileInfo.Type.Directory, 0, 0)
+            .add("a", FileInfo.Type.File, 12, 100)
+            .add("b/c", FileInfo.Type.File, 12, 100)
+            .add("b/d", FileInfo.Type.File, 12, 100)
+            .add("e", FileInfo.Type.File, 12, 100)
+            .build()
+        def current = files.newSnapshotBuilder()
+            .add("a", FileInfo.Type.File, 12, 100)
+            .add("b", FileInfo.Type.Directory, 0, 0)
+            .add("b/c", FileInfo.Type.File, 12, 200)
+            .add("b/c2", FileInfo.Type.File, 12, 100)
+            .add("e", FileInfo.Type.Directory, 0, 0)
+            .build()
+
+        when:
+        def diff = files.diff(previous, current)
+
+        then:
+        diff.added == ["b/c2"]
+        diff.removed == ["b/d"]
+        diff.modified == ["b/c", "e"]
+
+        when:
+        def loaded = files.loadSnapshot(current.contents)
+
+        then:
+        loaded.size() == 5
+        loaded.getPath(1) == "b"
+        loaded.getType(1) == FileInfo.Type.Directory
+        loaded.getLastModifiedTime(2) == 200
+        files.diff(current, loaded).with { added.empty && removed.empty && modified.empty }
+    }
+
+    @Unroll
+    def "cannot load a malformed snapshot"() {
+        def buffer = ByteBuffer.allocateDirect(contents.size() * 4).order(ByteOrder.nativeOrder())
+        contents.each { buffer.putInt(it) }
+        buffer.flip()
+
+        when:
+        files.loadSnapshot(buffer)
+
+        then:
+        NativeException e = thrown()
+        e.message == "Could not load snapshot: $message"
+
+        where:
+        contents                                | message
+        [1]                                     | "snapshot has an invalid number of entries."
+        [-1, 0, 0, 0, 0, 0, 0]                  | "snapshot has an invalid number of entries."
+        [Integer.MAX_VALUE, 0, 0, 0, 0, 0, 0]   | "snapshot has an invalid number of entries."
+        [1, 0, 100, 0, 0, 0, 0]                 | "snapshot is truncated."
+        [1, 0, -1, 0, 0, 0, 0]                  | "snapshot is truncated."
+        [2, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0] | "snapshot is truncated."
+        [1, 100, 0, 0, 0, 0, 0]                 | "snapshot has an entry with an invalid type."
+    }
+
+    def "cannot build a snapshot with duplicate paths"() {
+        def builder = files.newSnapshotBuilder()
+        builder.add("a", FileInfo.Type.File, 1, 100)
+        builder.add("b", FileInfo.Type.File, 1, 100)
+        builder.add("a", FileInfo.Type.Directory, 0, 200)
+
+        when:
+        builder.build()
+
+        then:
+        IllegalArgumentException e = thrown()
+        e.message == "Path 'a' was added more than once."
+    }
+
+    def "can diff large snapshots"() {
+        def previous = files.newSnapshotBuilder()
+        def current = files.newSnapshotBuilder()
+        (0..<20000).each {
+            previous.add("file-$it", FileInfo.Type.File, it, 100)
+            if (it % 1000 != 0) {
+                current.add("file-$it", FileInfo.Type.File, it % 1000 == 1 ? 0 : it, 100)
+            }
+        }
+        current.add("new-file", FileInfo.Type.File, 0, 100)
+
+        when:
+        def diff = files.diff(previous.build(), current.build())
+
+        then:
+        diff.added == ["new-file"]
+        diff.removed.sort() == (0..<20).collect { "file-${it * 1000}" }.sort()
+        diff.modified.sort() == (0..<20).collect { "file-${it * 1000 + 1}" }.sort()
+    }
+
     def "cannot list directory without read and execute permissions"() {
         def dir = tmpDir.newFolder()
         new File(dir, "a").text = 'content'
@@ -295,6 +794,22 @@ class PosixFilesTest extends FilesTest {
         name << names
     }
 
+    @Unroll
+    def "can read symbolic link with long target"() {
+        def symlinkFile = new File(tmpDir.root, "symlink")
+        // Longer than the buffers used to convert short strings
+        def target = maybeWithUnicde(segment) * 300
+
+        when:
+        files.symlink(symlinkFile, target)
+
+        then:
+        files.readLink(symlinkFile) == target
+
+        where:
+        segment << ["dir/", "d\u03b1\u2295/", "d\ud83d\ude00/"]
+    }
+
     def "cannot read a symlink that does not exist"() {
         def symlinkFile = new File(tmpDir.root, "symlink")
 
@@ -326,4 +841,10 @@ class PosixFilesTest extends FilesTest {
         PosixFileAttributeView fileAttributeView = java.nio.file.Files.getFileAttributeView(file.toPath(), PosixFileAttributeView)
         fileAttributeView.setPermissions(perms as Set)
     }
+
+    private static long readBytes() {
+        // Counts the bytes this process has caused to be read from storage, including by native threads
+        def line = new File("/proc/self/io").readLines().find { it.startsWith("read_bytes:") }
+        return line.substring("read_bytes:".length()).trim() as long
+    }
 }
@@ -0,0 +1,105 @@
+package net.rubygrapefruit.platform.internal
+
+import net.rubygrapefruit.platform.NativeException
+import net.rubygrapefruit.platform.prompts.Prompter
+import net.rubygrapefruit.platform.terminal.TerminalInput
+import net.rubygrapefruit.platform.terminal.TerminalInputListener
+import net.rubygrapefruit.platform.terminal.Terminals
+import spock.lang.Specification
+import spock.lang.Unroll
+
+
+class PrompterTest extends Specification {
+    def terminals = Stub(Terminals)
+
+    @Unroll
+
+package net.rubygrapefruit.platform.internal
+
+import net.rubygrapefruit.platform.terminal.Terminals
+import spock.lang.Specification
+
+class DefaultTerminalFrameRendererTest extends Specification {
+    def output = new ByteArrayOutputStream()
+    def terminal = new AnsiTerminal(output, Terminals.Output.Stdout)
+    def renderer = terminal.newFrameRenderer()
+
+    def "draws first frame at cursor"() {
+        when:
+        renderer.render(["one", "two"])
+
+        then:
+        written() == "one\ntwo\n"
+    }
+
+    def "does not write anything when frame is unchanged"() {
+        renderer.render(["one", "two"])
+        output.reset()
+
+        when:
+        renderer.render(["one", "two"])
+
+        then:
+        written() == ""
+    }
+
+    def "redraws only the changed cells of a line"() {
+        renderer.render(["progress 10%", "two"])
+        output.reset()
+
+        when:
+        renderer.render(["progress 20%", "two"])
+
+        then:
+        written() == "\u001b[2A\u001b[9C2\n\n"
+    }
+
+    def "clears the end of a line that becomes shorter"() {
+        renderer.render(["one", "longer line"])
+        output.reset()
+
+        when:
+        renderer.render(["one", "long"])
+
+        then:
+        written() == "\u001b[1A\u001b[4C\u001b[0K\n"
+    }
+
+    def "clears lines when frame becomes shorter"() {
+        renderer.render(["one", "two", "three"])
+        output.reset()
+
+        when:
+        renderer.render(["one"])
+
+        then:
+        written() == "\u001b[2A\u001b[0K\n\u001b[0K\u001b[1A\u001b[1G"
+    }
+
+    def "appends lines when frame becomes longer"() {
+        renderer.render(["one"])
+        output.reset()
+
+        when:
+        renderer.render(["one", "two"])
+
+        then:
+        written() == "two\n"
+    }
+
+    def "draws next frame at cursor after detach"() {
+        renderer.render(["one"])
+        renderer.detach()
+        output.reset()
+
+        when:
+        renderer.render(["one"])
+
+        then:
+        written() == "one\n"
+    }
+
+    private String written() {
+        return output.toString().replace(System.getProperty("line.separator"), "\n")
+    }
+}
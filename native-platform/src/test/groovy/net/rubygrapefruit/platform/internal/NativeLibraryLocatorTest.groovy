@@ -0,0 +1,97 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal
+
+import org.junit.Rule
+import org.junit.rules.TemporaryFolder
+import spock.lang.IgnoreIf
+import spock.lang.Requires
+import spock.lang.Specification
+
+class NativeLibraryLocatorTest extends Specification {
+    @Rule TemporaryFolder tmpDir
+    final Platform platform = Platform.current()
+
+    def "extracts library into directory keyed by its content"() {
+        def locator = new NativeLibraryLocator(tmpDir.root, "1.0", false)
+
+        when:
+        def libFile = find(locator)
+
+        then:
+        libFile.file
+        libFile.parentFile.name ==~ /[0-9a-f]{8}-\d+/
+        libFile.parentFile.listFiles().toList() == [libFile]
+
+        when:
+        def lastModified = libFile.lastModified()
+        def second = find(new NativeLibraryLocator(tmpDir.root, "1.0", false))
+
+        then:
+        second == libFile
+        second.lastModified() == lastModified
+    }
+
+    @IgnoreIf({Platform.current().windows})
+    def "removes temporary copy of library once released"() {
+        def locator = new NativeLibraryLocator(null, "1.0", false)
+
+        when:
+        def libFile = find(locator)
+
+        then:
+        libFile.file
+
+        when:
+        locator.release(libFile)
+
+        then:
+        !libFile.exists()
+        !libFile.parentFile.exists()
+    }
+
+    @Requires({ Platform.current().linux && new File("/dev/shm").directory })
+    def "extracts library to disk once in memory extraction is disabled"() {
+        def locator = new NativeLibraryLocator(tmpDir.root, "1.0", true)
+
+        when:
+        def inMemory = find(locator)
+
+        then:
+        inMemory.path.startsWith("/dev/shm/")
+
+        when:
+        locator.release(inMemory)
+        def disabled = locator.disableInMemory()
+        def onDisk = find(locator)
+
+        then:
+        disabled
+        !locator.disableInMemory()
+        onDisk.path.startsWith(tmpDir.root.path)
+    }
+
+    private File find(NativeLibraryLocator locator) {
+        for (String variant : platform.libraryVariants) {
+            def libFile = locator.find(new LibraryDef(platform.libraryName, variant))
+            if (libFile != null) {
+                return libFile
+            }
+        }
+        throw new IllegalStateException("No native library found for $platform")
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.internal
+
+import net.rubygrapefruit.platform.Native
+import net.rubygrapefruit.platform.internal.jni.PosixTerminalFunctions
+import net.rubygrapefruit.platform.terminal.TerminalInputListener
+import net.rubygrapefruit.platform.terminal.Terminals
+import spock.lang.IgnoreIf
+import spock.lang.Specification
+
+@IgnoreIf({Platform.current().windows})
+class PosixTerminalInputTest extends Specification {
+    final int[] record = new int[3 + 2 * 4096]
+
+    def setup() {
+        Native.get(Terminals.class)
+    }
+
+    def "decodes characters and control keys"() {
+        expect:
+        decode("ab\n\u007f\u0004") == ["a", "b", "Enter", "EraseBack", "end"]
+        decode("\u001b[A\u001b[1;5D\u001bOB\u001b[3~\u001b[6~\u001b[Z") == ["UpArrow", "LeftArrow", "DownArrow", "EraseForward", "PageDown", "BackTab"]
+    }
+
+    def "ignores unknown control sequences"() {
+        expect:
+        decode("\u001b[2~\u001b[?1;2cz") == ["z"]
+    }
+
+    def "waits for the remainder of an escape sequence unless flushed"() {
+        expect:
+        decode("x\u001b[") == ["x"]
+        record[0] == 1
+        decode("\u001b", true) == [String.valueOf((char) 27)]
+    }
+
+    def "delivers pasted text as characters"() {
+        expect:
+        decode("\u001b[200~a\nb") == ["a", "\n", "b"]
+        record[2] == 1
+        decode("\n\u001b[201~\n") == ["\n", "Enter"]
+        record[2] == 0
+    }
+
+    def "decodes UTF-8"() {
+        expect:
+        decode("\u00e9\u20ac\ud83d\ude00") == ["\u00e9", "\u20ac", "\ud83d", "\ude00"]
+    }
+
+    private List<String> decode(String input, boolean flush = false) {
+        def bytes = input.getBytes("utf-8")
+        PosixTerminalFunctions.decodeInput(bytes, 0, bytes.length, flush, record)
+        def events = []
+        for (int i = 0; i < record[1]; i++) {
+            def type = record[3 + 2 * i]
+            def value = record[4 + 2 * i]
+            if (type == 0) {
+                events << String.valueOf((char) value)
+            } else if (type == 1) {
+                events << TerminalInputListener.Key.values()[value].name()
+            } else {
+                events << "end"
+            }
+        }
+        return events
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2012 Adam Murdoch
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+package net.rubygrapefruit.platform.memory
+
+import net.rubygrapefruit.platform.Native
+import net.rubygrapefruit.platform.internal.Platform
+import spock.lang.IgnoreIf
+import spock.lang.Specification
+
+@IgnoreIf({ !Platform.current().linux })
+class LinuxMemoryTest extends Specification {
+    def "caches memory instance"() {
+        expect:
+        def memory = Native.get(LinuxMemory.class)
+        memory.is(Native.get(LinuxMemory.class))
+        memory.is(Native.get(Memory.class))
+    }
+
+    def "can query Linux memory info"() {
+        def meminfo = new File("/proc/meminfo").readLines()
+        def memTotal = meminfo.find { it.startsWith("MemTotal:") }.split(/\s+/)[1] as long
+
+        when:
+        def memoryInfo = Native.get(LinuxMemory.class).memoryInfo
+
+        then:
+        memoryInfo.totalPhysicalMemory == memTotal * 1024
+        memoryInfo.availablePhysicalMemory > 0
+        memoryInfo.availablePhysicalMemory <= memoryInfo.totalPhysicalMemory
+        memoryInfo.effectiveMemoryLimit > 0
+        memoryInfo.effectiveMemoryLimit <= memoryInfo.totalPhysicalMemory
+        memoryInfo.effectiveAvailableMemory <= memoryInfo.availablePhysicalMemory
+        memoryInfo.cgroupVersion in [0, 1, 2]
+        memoryInfo.cgroupVersion == 0 || memoryInfo.cgroupMemoryUsage > 0
+    }
+
+    def "can query Linux memory info many times"() {
+        def memory = Native.get(LinuxMemory.class)
+
+        expect:
+        (1..100).every { memory.memoryInfo.totalPhysicalMemory > 0 }
+    }
+}
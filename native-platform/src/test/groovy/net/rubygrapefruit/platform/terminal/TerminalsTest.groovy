@@ -22,6 +22,8 @@ import org.junit.Rule
 import org.junit.rules.TemporaryFolder
 import spock.lang.Specification
 import net.rubygrapefruit.platform.internal.Platform
+import net.rubygrapefruit.platform.internal.TerminalSizeWatcher
+import net.rubygrapefruit.platform.internal.TerminfoTerminal
 import spock.lang.IgnoreIf
 
 class TerminalsTest extends Specification {
@@ -50,6 +52,42 @@ class TerminalsTest extends Specification {
         e.message == 'Could not open terminal for stdout: not a terminal'
     }
 
+    @IgnoreIf({Platform.current().windows})
+    def "does not report cached size for outputs that are not attached to a terminal"() {
+        expect:
+        TerminalSizeWatcher.instance.getSize(Terminals.Output.Stdout) == null
+        TerminalSizeWatcher.instance.getSize(Terminals.Output.Stderr) == null
+    }
+
+    @IgnoreIf({Platform.current().windows})
+    def "reads terminal size from the buffer maintained by the watcher"() {
+        def terminal = new TerminfoTerminal(Terminals.Output.Stdout)
+        def sizes = TerminalSizeWatcher.instance.sizes
+
+        when:
+        sizes.putLong(8, (24L << 32) | 80L)
+        def size = terminal.terminalSize
+
+        then:
+        size.rows == 24
+        size.cols == 80
+
+        cleanup:
+        sizes.putLong(8, -1L)
+    }
+
+    @IgnoreIf({Platform.current().windows})
+    def "queries the terminal when the size is not tracked by the watcher"() {
+        def terminal = new TerminfoTerminal(Terminals.Output.Stdout)
+
+        when:
+        terminal.terminalSize
+
+        then:
+        NativeException e = thrown()
+        e.message.startsWith('Could not get terminal size for stdout:')
+    }
+
     @IgnoreIf({!Platform.current().windows})
     def "cannot access windows console from a test"() {
         when:
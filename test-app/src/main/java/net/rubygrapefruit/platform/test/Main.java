@@ -67,6 +67,7 @@ public class Main {
         optionParser.accepts("stat-L", "Display details about the specified file or directory, following symbolic links").withRequiredArg();
         optionParser.accepts("ls", "Display contents of the specified directory").withRequiredArg();
         optionParser.accepts("ls-L", "Display contents of the specified directory, following symbolic links").withRequiredArg();
+        optionParser.accepts("benchmark", "Measures the time taken to stat and list the specified directory").withRequiredArg();
         optionParser.accepts("watch", "Watches for changes to the specified file or directory").withRequiredArg();
         optionParser.accepts("machine", "Display details about the current machine");
         optionParser.accepts("terminal", "Display details about the terminal");
@@ -109,6 +110,11 @@ public class Main {
             return;
         }
 
+        if (result.has("benchmark")) {
+            benchmark((String) result.valueOf("benchmark"));
+            return;
+        }
+
         if (result.has("watch")) {
             watch((String) result.valueOf("watch"));
             return;
@@ -485,6 +491,45 @@ public class Main {
         stat(path, false);
     }
 
+    private static void benchmark(String path) {
+        final File dir = new File(path);
+        final Files files = Native.get(Files.class);
+        int entries = files.listDir(dir).size();
+
+        System.out.println();
+        System.out.println("* Directory: " + dir + " (" + entries + " entries)");
+        benchmark("stat", new Runnable() {
+            public void run() {
+                files.stat(dir);
+            }
+        });
+        benchmark("listDir", new Runnable() {
+            public void run() {
+                files.listDir(dir);
+            }
+        });
+        System.out.println();
+    }
+
+    private static void benchmark(String name, Runnable action) {
+        // Warm up, so that the JIT has compiled the calling code
+        long deadline = System.nanoTime() + TimeUnit.SECONDS.toNanos(2);
+        while (System.nanoTime() < deadline) {
+            action.run();
+        }
+        int iterations = 0;
+        long start = System.nanoTime();
+        long end;
+        do {
+            for (int i = 0; i < 1000; i++) {
+                action.run();
+            }
+            iterations += 1000;
+            end = System.nanoTime();
+        } while (end - start < TimeUnit.SECONDS.toNanos(5));
+        System.out.println(String.format("* %s: %d ns/op", name, (end - start) / iterations));
+    }
+
     private static void statFollowLinks(String path) {
         stat(path, true);
     }